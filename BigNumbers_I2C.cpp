@@ -96,21 +96,10 @@ byte middleBar[8] =
   B11111,
   B11111
 };
-byte lowerEnd[8] = 
-{
-  B00000,
-  B00000,
-  B00000,
-  B00000,
-  B00000,
-  B00000,
-  B00111,
-  B01111
-};
 
 // Creates BigNumbers_I2C object
-// LiquidCrystal_I2C* lcd: LiquidCrystal object to use
-BigNumbers_I2C::BigNumbers_I2C(LiquidCrystal_I2C* lcd)
+// LcdHd44780* lcd: LCD backend object to use
+BigNumbers_I2C::BigNumbers_I2C(LcdHd44780* lcd)
 {
   _lcd = lcd;
 }
@@ -125,7 +114,8 @@ void BigNumbers_I2C::begin()
   _lcd->createChar(4, lowerBar);
   _lcd->createChar(5, rightEnd);
   _lcd->createChar(6, middleBar);
-  _lcd->createChar(7, lowerEnd);
+  // Caractère 7 laissé libre pour la barre de progression (progression.h) : le coin bas gauche
+  // de 3, 5 et 9 (ancien caractère 7 "lowerEnd") utilise la barre basse
 }
 
 // prints an integer to the display using large characters
@@ -135,12 +125,7 @@ void BigNumbers_I2C::begin()
 //             leading - sets if leading zeros are printed or not (false = no, true = yes)
 void BigNumbers_I2C::displayLargeInt(int n, byte x, byte y, byte digits, bool leading)
 {
-  boolean isNegative = false;
-  if(n < 0)
-  {
-    isNegative = true;
-    n = abs(n);
-  }
+  n = abs(n); // Pas de signe affiché, seulement la valeur absolue
   byte numString[digits];
   byte index = digits - 1;
   while(index)
@@ -221,7 +206,7 @@ y is row of upper left corner for large character */
       _lcd->write(6);
       _lcd->write(2);
       _lcd->setCursor(x, y+1);
-      _lcd->write(7);
+      _lcd->write(4);
       _lcd->write(4);
       _lcd->write(2);
       break;
@@ -245,7 +230,7 @@ y is row of upper left corner for large character */
       _lcd->write(6);
       _lcd->write(5);
       _lcd->setCursor(x, y+1);
-      _lcd->write(7);
+      _lcd->write(4);
       _lcd->write(4);
       _lcd->write(2);
       break;
@@ -293,7 +278,7 @@ y is row of upper left corner for large character */
       _lcd->write(6);
       _lcd->write(2);
       _lcd->setCursor(x, y+1);
-      _lcd->write(7);
+      _lcd->write(4);
       _lcd->write(4);
       _lcd->write(2);
       break;
@@ -21,18 +21,18 @@
 #define BigNumbers_I2C_h
 
 #include "Arduino.h"
-#include "LiquidCrystal_I2C.h"
+#include "ecran_lcd.h" // Backend HD44780 du projet (à la place de LiquidCrystal_I2C)
 
 class BigNumbers_I2C
 {
   public:
-    BigNumbers_I2C(LiquidCrystal_I2C*);
+    BigNumbers_I2C(LcdHd44780*);
 	void begin();
     void clearLargeNumber(byte, byte);
     void displayLargeNumber(byte, byte, byte);
 	void displayLargeInt(int, byte, byte, byte, bool);
   private:
-    LiquidCrystal_I2C* _lcd;
+    LcdHd44780* _lcd;
 };
 
 #endif
@@ -0,0 +1,64 @@
+// affichage.cpp - Ordonnanceur de rafraîchissement de l'écran LCD
+
+#include "affichage.h"
+#include "ecran.h"
+
+struct DisplayRequest {
+  DisplayRenderFn render;   // nullptr = aucune demande en attente
+  byte mode;                // Mode actif lors de la demande (ignorée si le mode a changé)
+};
+
+static DisplayRequest pendingRequests[DISP_PRIO_COUNT];
+DisplayStats displayStats = { 0, 0, 0, 0 };
+
+void requestDisplay(DisplayPriority priority, DisplayRenderFn render) {
+  DisplayRequest& req = pendingRequests[priority];
+  if (req.render != nullptr) {
+    // La demande précédente n'a pas encore été dessinée : elle est abandonnée au profit de
+    // celle-ci. Les rendus lisent l'état courant, donc rien n'est perdu à l'écran.
+    displayStats.dropped++;
+  }
+  req.render = render;
+  req.mode = currentMode;
+}
+
+void cancelDisplayRequests() {
+  for (byte p = 0; p < DISP_PRIO_COUNT; p++) { pendingRequests[p].render = nullptr; }
+}
+
+void serviceDisplay() {
+  unsigned long passStart = micros();
+  bool renderedSomething = false;
+
+  for (byte p = 0; p < DISP_PRIO_COUNT; p++) {
+    DisplayRequest& req = pendingRequests[p];
+    if (req.render == nullptr) continue;
+
+    if (req.mode != currentMode) { // L'écran a changé depuis la demande
+      req.render = nullptr;
+      continue;
+    }
+    // La demande la plus prioritaire passe toujours, les suivantes seulement s'il reste du budget
+    if (renderedSomething && (micros() - passStart) >= DISPLAY_I2C_BUDGET_US) {
+      for (byte q = p; q < DISP_PRIO_COUNT; q++) {
+        if (pendingRequests[q].render != nullptr) displayStats.deferred++;
+      }
+      break;
+    }
+
+    DisplayRenderFn render = req.render;
+    req.render = nullptr; // Libérée avant le rendu : le rendu peut redemander
+    render();
+    renderedSomething = true;
+  }
+
+  LCD.endFrame(); // OLED : envoi des cases modifiées pendant la passe (rendus et écritures directes)
+
+  if (renderedSomething) {
+    displayStats.passes++;
+    unsigned long passMicros = micros() - passStart;
+    if (passMicros > displayStats.maxPassMicros) {
+      displayStats.maxPassMicros = passMicros > 0xFFFF ? 0xFFFF : (unsigned int)passMicros;
+    }
+  }
+}
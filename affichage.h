@@ -0,0 +1,40 @@
+// affichage.h - Ordonnanceur de rafraîchissement de l'écran LCD
+//
+// Les modules ne rafraîchissent plus l'écran directement pendant la boucle : ils déposent une
+// demande (fonction de rendu) dans une classe de priorité. serviceDisplay(), appelée une fois
+// par passage dans loop() APRÈS la lecture des entrées, exécute les demandes de la plus
+// prioritaire à la moins prioritaire tant que le budget I2C de la passe n'est pas épuisé.
+// Une nouvelle demande dans une classe déjà en attente remplace l'ancienne (fusion).
+// La passe se termine par LCD.endFrame() (ecran.h) : fin de trame, envoi du tampon OLED.
+#ifndef AFFICHAGE_H
+#define AFFICHAGE_H
+
+#include <Arduino.h>
+#include "conf.h"
+
+extern enum Mode currentMode;
+
+// Classes de priorité (0 = la plus prioritaire)
+enum DisplayPriority {
+  DISP_PRIO_BEAT,     // Marqueurs de temps du métronome
+  DISP_PRIO_SECONDS,  // Grands chiffres MM:SS + ligne de statut du minuteur
+  DISP_PRIO_CENTIS,   // Centisecondes
+  DISP_PRIO_STATUS,   // Texte de statut (ligne 3)
+  DISP_PRIO_COUNT
+};
+
+typedef void (*DisplayRenderFn)();
+
+struct DisplayStats {
+  unsigned long passes;        // Passes ayant dessiné au moins une demande
+  unsigned long deferred;      // Demandes reportées à une passe suivante (budget épuisé)
+  unsigned long dropped;       // Demandes remplacées avant d'être dessinées
+  unsigned int maxPassMicros;  // Durée maximale d'une passe de rendu (µs)
+};
+extern DisplayStats displayStats;
+
+void requestDisplay(DisplayPriority priority, DisplayRenderFn render);
+void serviceDisplay();
+void cancelDisplayRequests();
+
+#endif // AFFICHAGE_H
@@ -0,0 +1,257 @@
+// banc.cpp - Banc d'essai : mesures, historique en EEPROM, écran des résultats
+
+#include "banc.h"
+#include "rapport.h"
+#include "checkpoint.h" // eepromWriteBegin/End : écriture protégée de la chute de tension
+#include <avr/eeprom.h>
+
+enum BenchFigure : byte { BENCH_LCD_CHARS, BENCH_BIG_DIGITS, BENCH_CLEAR_US, BENCH_EEPROM_US, BENCH_TONE_US, BENCH_LOOP_RATE, BENCH_FIGURES };
+
+// Enregistrement en EEPROM (BENCH_RECORD_SIZE octets par case de l'anneau)
+struct BenchRecord {
+  byte sequence;                   // Numéro de l'essai (modulo 256)
+  uint16_t figures[BENCH_FIGURES]; // Valeurs plafonnées à 65535
+  byte check;                      // Octet de contrôle (voir recordCheck)
+};
+
+// Libellés des lignes (10 caractères au plus : la valeur occupe les 5 dernières colonnes)
+static const char BENCH_LABELS[BENCH_FIGURES][11] PROGMEM = { "Car. LCD/s", "Chiffres/s", "Clear us", "EEPROM us", "Tone us", "Boucle/s" };
+static const byte BENCH_LINES = BENCH_FIGURES + 1; // Titre + une ligne par mesure
+
+static bool measuringLoop = false;
+static unsigned long loopWindowStart = 0;
+static unsigned long loopPasses = 0;
+static BenchRecord shown;          // Essai affiché
+static byte newestSlot = BENCH_HISTORY_SLOTS - 1;
+static byte newestSequence = 0;
+static byte viewAge = 0;           // 0 = essai le plus récent, 1 = le précédent...
+static byte scrollLine = 0;
+
+static byte recordCheck(const BenchRecord& rec) {
+  const byte* bytes = (const byte*)&rec;
+  byte check = 0xB5;
+  for (byte i = 0; i < sizeof(BenchRecord) - 1; i++) {
+    check = (check << 1 | check >> 7) ^ bytes[i];
+  }
+  return check;
+}
+
+static int slotAddress(byte slot) {
+  return EEPROM_ADDR_BENCH_HISTORY + slot * BENCH_RECORD_SIZE;
+}
+
+// Essai le plus récent de l'anneau (numéro de séquence le plus avancé)
+static void findNewest() {
+  static_assert(sizeof(BenchRecord) <= BENCH_RECORD_SIZE, "BENCH_RECORD_SIZE trop petit");
+  bool found = false;
+  for (byte slot = 0; slot < BENCH_HISTORY_SLOTS; slot++) {
+    BenchRecord rec;
+    EEPROM.get(slotAddress(slot), rec);
+    if (rec.check != recordCheck(rec)) continue;
+    if (!found || (int8_t)(rec.sequence - newestSequence) > 0) {
+      newestSlot = slot;
+      newestSequence = rec.sequence;
+      found = true;
+    }
+  }
+}
+
+// Essai d'âge 'age' (0 = le plus récent) ; faux si la case est vide ou n'appartient pas à la série
+static bool readRecord(byte age, BenchRecord& rec) {
+  if (age >= BENCH_HISTORY_SLOTS) return false;
+  EEPROM.get(slotAddress((newestSlot + BENCH_HISTORY_SLOTS - age) % BENCH_HISTORY_SLOTS), rec);
+  return rec.check == recordCheck(rec) && rec.sequence == (byte)(newestSequence - age);
+}
+
+static uint16_t perSecond(unsigned long count, unsigned long elapsedUs) {
+  unsigned long elapsedMs = (elapsedUs + 500) / 1000;
+  if (elapsedMs == 0) return 0;
+  unsigned long rate = count * 1000UL / elapsedMs;
+  return rate > 65535UL ? 65535 : rate;
+}
+
+// --- Mesures ---
+
+static uint16_t measureLcdChars() {
+  unsigned long start = micros(), elapsed, chars = 0;
+  unsigned int pass = 0;
+  do {
+    LCD.setCursor(0, pass % LCD_ROWS);
+    for (byte col = 0; col < LCD_COLS; col++) { LCD.print((char)('0' + (pass + col) % 10)); } // Cases toujours modifiées
+    LCD.endFrame();
+    chars += LCD_COLS;
+    pass++;
+    elapsed = micros() - start;
+  } while (elapsed < BENCH_PHASE_MS * 1000UL);
+  return perSecond(chars, elapsed);
+}
+
+static uint16_t measureBigDigits() {
+  bigNum.begin(); // Caractères personnalisés des grands chiffres (les menus en ont remplacé deux)
+  unsigned long start = micros(), elapsed, calls = 0;
+  do {
+    bigNum.displayLargeNumber(calls % 10, 0, 0);
+    LCD.endFrame();
+    calls++;
+    elapsed = micros() - start;
+  } while (elapsed < BENCH_PHASE_MS * 1000UL);
+  return perSecond(calls, elapsed);
+}
+
+static uint16_t measureClear() {
+  unsigned long start = micros();
+  for (byte i = 0; i < BENCH_CLEAR_COUNT; i++) {
+    LCD.clear();
+    LCD.endFrame();
+  }
+  return (micros() - start) / BENCH_CLEAR_COUNT;
+}
+
+static uint16_t measureEepromWrite() {
+  byte value = EEPROM.read(EEPROM_ADDR_BENCH_SCRATCH);
+  unsigned long total = 0;
+  for (byte i = 0; i < BENCH_EEPROM_WRITES; i++) {
+    value = ~value; // Toujours différent : effacement + programmation réels
+    unsigned long start = micros();
+    eepromWriteBegin();
+    EEPROM.write(EEPROM_ADDR_BENCH_SCRATCH, value);
+    while (!eeprom_is_ready()) {}
+    eepromWriteEnd();
+    total += micros() - start;
+  }
+  return total / BENCH_EEPROM_WRITES;
+}
+
+static uint16_t measureToneLatency() {
+  volatile uint8_t* pinReg = portInputRegister(digitalPinToPort(BUZZER_PIN));
+  uint8_t mask = digitalPinToBitMask(BUZZER_PIN);
+  digitalWrite(BUZZER_PIN, LOW);
+  unsigned long start = micros();
+  tone(BUZZER_PIN, BENCH_TONE_HZ);
+  while (!(*pinReg & mask) && micros() - start < 10000UL) {}
+  unsigned long elapsed = micros() - start;
+  noTone(BUZZER_PIN);
+  // Le premier basculement arrive une demi-période après le démarrage du timer : elle est retirée
+  const unsigned long halfPeriodUs = 500000UL / BENCH_TONE_HZ;
+  return elapsed > halfPeriodUs ? elapsed - halfPeriodUs : 0;
+}
+
+// --- Historique ---
+
+static void saveRecord() {
+  shown.sequence = newestSequence + 1;
+  shown.check = recordCheck(shown);
+  byte slot = (newestSlot + 1) % BENCH_HISTORY_SLOTS;
+  eepromWriteBegin();
+  EEPROM.put(slotAddress(slot), shown);
+  eepromWriteEnd();
+  newestSlot = slot;
+  newestSequence = shown.sequence;
+}
+
+void reportBenchHistory() {
+  findNewest();
+  for (byte age = 0; age < BENCH_HISTORY_SLOTS; age++) {
+    BenchRecord rec;
+    if (!readRecord(age, rec)) break;
+    Report.print(F("Banc #")); Report.print(rec.sequence);
+    for (byte f = 0; f < BENCH_FIGURES; f++) {
+      Report.print(' ');
+      Report.print((const __FlashStringHelper*)BENCH_LABELS[f]);
+      Report.print('=');
+      Report.print(rec.figures[f]);
+    }
+    Report.println();
+  }
+}
+
+// --- Affichage ---
+
+static void printBenchLine(byte line, byte row) {
+  LCD.setCursor(0, row);
+  byte len;
+  if (line == 0) {
+    len = LCD.print(F("Banc #"));
+    len += LCD.print(shown.sequence);
+    if (viewAge > 0) { len += LCD.print(F(" (-")); len += LCD.print(viewAge); len += LCD.print(')'); }
+  } else {
+    byte f = line - 1;
+    len = LCD.print((const __FlashStringHelper*)BENCH_LABELS[f]);
+    clearRestOfLine(len, row);
+    uint16_t value = shown.figures[f];
+    byte digits = 1;
+    for (uint16_t v = value; v >= 10; v /= 10) digits++;
+    LCD.setCursor(LCD_COLS - digits, row);
+    LCD.print(value);
+    return;
+  }
+  clearRestOfLine(len, row);
+}
+
+static void drawBenchScreen() {
+  for (byte row = 0; row < LCD_ROWS; row++) {
+    byte line = scrollLine + row;
+    if (line < BENCH_LINES) printBenchLine(line, row);
+    else clearRestOfLine(0, row);
+  }
+}
+
+// --- Gestionnaires de mode ---
+
+void enterBenchMode() {
+  resetActivityTimer();
+  findNewest();
+  LCD.clear();
+  shown.figures[BENCH_LCD_CHARS] = measureLcdChars();
+  shown.figures[BENCH_BIG_DIGITS] = measureBigDigits();
+  shown.figures[BENCH_CLEAR_US] = measureClear(); // Laisse l'écran vide pour la suite
+  shown.figures[BENCH_EEPROM_US] = measureEepromWrite();
+  shown.figures[BENCH_TONE_US] = measureToneLatency();
+  LCD.setCursor(centeredCol(textLen("Mesure boucle...")), 0);
+  LCD.print(F("Mesure boucle..."));
+  measuringLoop = true;
+  loopPasses = 0;
+  loopWindowStart = millis();
+}
+
+void tickBenchMode() {
+  if (!measuringLoop) return;
+  loopPasses++;
+  unsigned long elapsed = millis() - loopWindowStart;
+  if (elapsed < BENCH_LOOP_WINDOW_MS) return;
+  measuringLoop = false;
+  shown.figures[BENCH_LOOP_RATE] = perSecond(loopPasses, elapsed * 1000UL);
+  saveRecord();
+  reportBenchHistory();
+  viewAge = 0;
+  scrollLine = 0;
+  resetActivityTimer();
+  redrawBenchScreen();
+}
+
+void handleBenchEncoder(int delta) {
+  if (measuringLoop) return;
+  int line = constrain((int)scrollLine + delta, 0, BENCH_LINES > LCD_ROWS ? BENCH_LINES - LCD_ROWS : 0);
+  if (line == scrollLine) return;
+  scrollLine = line;
+  playClickSound(); resetActivityTimer();
+  requestDisplay(DISP_PRIO_STATUS, drawBenchScreen);
+}
+
+void handleBenchButton(ButtonEvent event) {
+  if (measuringLoop) return;
+  resetActivityTimer();
+  if (event == BTN_LONG_PRESS) { setMode(MODE_MENU_MAIN); return; }
+  if (!isClickEvent(event)) return;
+  playClickSound();
+  BenchRecord rec;
+  viewAge = readRecord(viewAge + 1, rec) ? viewAge + 1 : 0; // Après le plus ancien : retour au plus récent
+  readRecord(viewAge, shown);
+  requestDisplay(DISP_PRIO_STATUS, drawBenchScreen);
+}
+
+void redrawBenchScreen() {
+  LCD.clear();
+  if (measuringLoop) { LCD.setCursor(centeredCol(textLen("Mesure boucle...")), 0); LCD.print(F("Mesure boucle...")); }
+  else drawBenchScreen();
+}
@@ -0,0 +1,45 @@
+// banc.h - Banc d'essai du matériel : débit de l'écran, EEPROM, tone(), passes de loop()
+//
+// Mode caché (appui long sur l'écran Diagnostic). Les unités diffèrent selon l'adaptateur I2C, la
+// longueur du câble et l'alimentation : ces mesures repèrent le matériel lent avant qu'il ne fasse
+// manquer des temps au métronome.
+//  - Caractères LCD.print par seconde (lignes complètes, envoi compris : endFrame() pour l'OLED)
+//  - Appels displayLargeNumber() par seconde (un grand chiffre)
+//  - Coût d'un LCD.clear() (µs, délai d'effacement du contrôleur compris)
+//  - Écriture d'un octet EEPROM (µs, jusqu'à la fin de la programmation)
+//  - Latence de tone() : de l'appel au premier front sur BUZZER_PIN, demi-période retirée (µs)
+//  - Passes de loop() par seconde, écran au repos
+// Les cinq premières mesures bloquent environ une demi-seconde à l'entrée ; la dernière compte les
+// passes pendant BENCH_LOOP_WINDOW_MS. Chaque résultat est gardé dans un anneau de
+// BENCH_HISTORY_SLOTS enregistrements en EEPROM (numéro de séquence + octet de contrôle, comme
+// checkpoint.h) et l'historique complet part sur le port série.
+//
+// Commandes : encodeur = défilement des lignes, clic = essai précédent de l'historique (puis retour
+// au plus récent), appui long = retour au menu.
+#ifndef BANC_H
+#define BANC_H
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include "conf.h"
+#include "ecran.h"
+#include "geometrie.h"
+#include "affichage.h"
+#include "modes.h"
+#include "bouton.h"
+
+// Fonctions utilitaires du .ino principal
+void resetActivityTimer();
+void playClickSound();
+void clearRestOfLine(byte startCol, byte row);
+
+void reportBenchHistory(); // Essais conservés, du plus récent au plus ancien, sur le port série
+
+// Gestionnaires de MODE_BENCH (modes.h)
+void enterBenchMode();
+void tickBenchMode();
+void handleBenchEncoder(int delta);
+void handleBenchButton(ButtonEvent event);
+void redrawBenchScreen();
+
+#endif // BANC_H
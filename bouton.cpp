@@ -0,0 +1,199 @@
+// bouton.cpp - Gestes du bouton capturés par interruption
+
+#include "bouton.h"
+
+struct ButtonEdge {
+  unsigned long time; // micros() au front
+  bool down;          // true = enfoncé (niveau bas, pull-up)
+};
+
+ButtonStats buttonStats = {0, 0};
+
+static volatile uint8_t* buttonPinReg;
+static uint8_t buttonPinMask;
+
+static volatile ButtonEdge edgeQueue[BUTTON_EDGE_QUEUE_SIZE];
+static volatile byte edgeHead = 0; // Écrit par l'ISR
+static volatile byte edgeTail = 0; // Écrit par serviceButton()
+static volatile bool lastQueuedDown = false;
+static volatile bool edgeLost = false;
+
+struct QueuedEvent {
+  ButtonEvent event;
+  unsigned long pressMicros; // Premier contact de l'appui
+};
+
+static QueuedEvent eventQueue[BUTTON_EVENT_QUEUE_SIZE];
+static byte eventHead = 0;
+static byte eventTail = 0;
+static unsigned long lastEventMicros = 0;
+
+// Reconnaissance
+static ButtonEdge pendingEdge;          // Front en attente de stabilisation (BUTTON_SETTLE_US)
+static bool pendingValid = false;
+static bool stableDown = false;
+static unsigned long downMicros = 0;
+static unsigned long firstContactMicros = 0; // Premier front bas après un repos >= BUTTON_SETTLE_US
+static unsigned long lastUpEdgeMicros = 0;
+static unsigned long pressMicros = 0;         // firstContactMicros de l'appui validé
+static bool longFired = false;
+static unsigned long nextRepeatMs = 0;
+static bool suppressPress = false;
+static bool clickArmed = false;         // Un clic vient d'être livré : le suivant peut être un double
+static unsigned long lastClickUpMicros = 0;
+
+static bool readButtonDown() {
+  return !(*buttonPinReg & buttonPinMask);
+}
+
+ISR(PCINT2_vect) {
+  awokeByInterrupt = true; // Réveil (veille ou décompte basse consommation), bouton ou encodeur
+  bool down = readButtonDown();
+  if (down == lastQueuedDown) return; // Changement sur une autre broche du port
+  lastQueuedDown = down;
+  byte next = (edgeHead + 1) % BUTTON_EDGE_QUEUE_SIZE;
+  if (next == edgeTail) { edgeLost = true; return; }
+  edgeQueue[edgeHead].time = micros();
+  edgeQueue[edgeHead].down = down;
+  edgeHead = next;
+}
+
+void setupButton() {
+  pinMode(BUTTON_PIN, INPUT_PULLUP);
+  buttonPinReg = portInputRegister(digitalPinToPort(BUTTON_PIN));
+  buttonPinMask = digitalPinToBitMask(BUTTON_PIN);
+  stableDown = lastQueuedDown = readButtonDown();
+  suppressPress = stableDown; // Bouton tenu à la mise sous tension : ignoré jusqu'au relâchement
+  PCIFR = _BV(PCIF2);
+  PCMSK2 |= _BV(digitalPinToPCMSKbit(BUTTON_PIN));
+  PCICR |= _BV(PCIE2);
+}
+
+static bool popEdge(ButtonEdge& edge) {
+  bool available = false;
+  noInterrupts();
+  if (edgeTail != edgeHead) {
+    edge.time = edgeQueue[edgeTail].time;
+    edge.down = edgeQueue[edgeTail].down;
+    edgeTail = (edgeTail + 1) % BUTTON_EDGE_QUEUE_SIZE;
+    available = true;
+  }
+  interrupts();
+  return available;
+}
+
+static void pushEvent(ButtonEvent event) {
+  byte next = (eventHead + 1) % BUTTON_EVENT_QUEUE_SIZE;
+  if (next == eventTail) {
+    if (buttonStats.eventOverflows < 255) buttonStats.eventOverflows++;
+    return;
+  }
+  eventQueue[eventHead].event = event;
+  eventQueue[eventHead].pressMicros = pressMicros;
+  eventHead = next;
+}
+
+// Front stable : appui ou relâchement, horodaté au moment réel du front
+static void commitEdge(bool down, unsigned long time) {
+  if (down == stableDown) return;
+  stableDown = down;
+  if (down) {
+    downMicros = time;
+    pressMicros = firstContactMicros;
+    longFired = false;
+    return;
+  }
+
+  if (suppressPress) { suppressPress = false; return; }
+  if (longFired) return; // Appui long déjà livré pendant le maintien
+  unsigned long heldMs = (time - downMicros) / 1000;
+  if (heldMs >= longPressDuration) {
+    pushEvent(BTN_LONG_PRESS); // Relâché avant que loop() ait pu le voir tenu
+  } else if (heldMs >= (unsigned long)debounceDelay) {
+    if (clickArmed && (downMicros - lastClickUpMicros) / 1000 <= doubleClickWindow) {
+      pushEvent(BTN_DOUBLE_CLICK);
+      clickArmed = false;
+    } else {
+      pushEvent(BTN_CLICK);
+      clickArmed = true;
+      lastClickUpMicros = time;
+    }
+  }
+}
+
+void serviceButton() {
+  ButtonEdge edge;
+  while (popEdge(edge)) {
+    // Un front bas qui suit un repos assez long est le premier contact d'un appui (pas un rebond)
+    if (!edge.down) lastUpEdgeMicros = edge.time;
+    else if (edge.time - lastUpEdgeMicros >= BUTTON_SETTLE_US) firstContactMicros = edge.time;
+
+    if (pendingValid && edge.time - pendingEdge.time < BUTTON_SETTLE_US) {
+      // Rebond : le front en attente est annulé (retour au niveau stable) ou remplacé
+      if (edge.down == stableDown) pendingValid = false;
+      else pendingEdge = edge;
+      continue;
+    }
+    if (pendingValid) commitEdge(pendingEdge.down, pendingEdge.time);
+    pendingEdge = edge;
+    pendingValid = true;
+  }
+
+  unsigned long now = micros();
+  if (pendingValid && now - pendingEdge.time >= BUTTON_SETTLE_US) {
+    commitEdge(pendingEdge.down, pendingEdge.time);
+    pendingValid = false;
+  }
+
+  if (edgeLost) {
+    // File pleine : des fronts ont manqué, se recaler sur le niveau réel de la broche
+    if (buttonStats.edgeOverflows < 255) buttonStats.edgeOverflows++;
+    noInterrupts();
+    edgeLost = false;
+    lastQueuedDown = readButtonDown();
+    interrupts();
+    if (!pendingValid) {
+      if (lastQueuedDown) firstContactMicros = now;
+      commitEdge(lastQueuedDown, now);
+    }
+  }
+
+  if (stableDown && !longFired && !suppressPress) {
+    unsigned long heldUntil = (pendingValid && !pendingEdge.down) ? pendingEdge.time : now;
+    if ((heldUntil - downMicros) / 1000 >= longPressDuration) {
+      longFired = true;
+      clickArmed = false;
+      nextRepeatMs = longPressDuration + holdRepeatInterval;
+      pushEvent(BTN_LONG_PRESS);
+    }
+  } else if (stableDown && longFired && !pendingValid) {
+    if ((now - downMicros) / 1000 >= nextRepeatMs) {
+      nextRepeatMs += holdRepeatInterval;
+      pushEvent(BTN_HOLD_REPEAT);
+    }
+  }
+}
+
+ButtonEvent nextButtonEvent() {
+  if (eventTail == eventHead) return BTN_NONE;
+  ButtonEvent event = eventQueue[eventTail].event;
+  lastEventMicros = eventQueue[eventTail].pressMicros;
+  eventTail = (eventTail + 1) % BUTTON_EVENT_QUEUE_SIZE;
+  return event;
+}
+
+unsigned long buttonEventMicros() {
+  return lastEventMicros;
+}
+
+bool buttonInputPending() {
+  return stableDown || pendingValid || edgeTail != edgeHead || readButtonDown();
+}
+
+void ignoreCurrentPress() {
+  serviceButton();
+  if (stableDown || (pendingValid && pendingEdge.down) || readButtonDown()) {
+    suppressPress = true;
+    clickArmed = false;
+  }
+}
@@ -0,0 +1,50 @@
+// bouton.h - Gestes du bouton capturés par interruption (clic, double-clic, appui long, répétition)
+//
+// Chaque front du bouton est horodaté par ISR(PCINT2_vect) dans une file circulaire : un appui plus
+// court qu'une passe de loop() (mélodie bloquante, gros rafraîchissement) n'est plus perdu.
+// serviceButton() filtre les rebonds sur ces horodatages puis reconnaît les gestes, rangés dans
+// une file d'événements lue par nextButtonEvent(). Les durées sont mesurées entre fronts, pas au
+// moment où loop() les lit : un appui long vu en retard reste un appui long.
+//
+// Chaque geste porte l'horodatage (micros()) du PREMIER contact de l'appui qui l'a produit, pris
+// par l'ISR avant les rebonds : buttonEventMicros() après nextButtonEvent(). Le chronomètre y
+// date ses tours sans que la latence de loop() (ou d'un rafraîchissement de l'écran) ne compte.
+//
+// Le premier clic est livré sans attendre ; si un second suit dans doubleClickWindow, il est livré
+// comme BTN_DOUBLE_CLICK. Un mode qui ne gère pas le double-clic le traite comme un clic.
+// La même ISR sert au réveil (goToSleep, décompte basse consommation) : PCINT22 reste armé.
+#ifndef BOUTON_H
+#define BOUTON_H
+
+#include <Arduino.h>
+#include "conf.h"
+
+enum ButtonEvent : byte {
+  BTN_NONE,
+  BTN_CLICK,         // Appui court relâché
+  BTN_DOUBLE_CLICK,  // Second appui court dans doubleClickWindow (remplace le second BTN_CLICK)
+  BTN_LONG_PRESS,    // Maintien >= longPressDuration (une fois par appui)
+  BTN_HOLD_REPEAT    // Toutes les holdRepeatInterval ms tant que le maintien continue après l'appui long
+};
+
+// Clic simple ou double : les modes qui ne distinguent pas le double-clic l'acceptent comme un clic
+inline bool isClickEvent(ButtonEvent event) {
+  return event == BTN_CLICK || event == BTN_DOUBLE_CLICK;
+}
+
+struct ButtonStats {
+  byte edgeOverflows;   // Fronts perdus (file pleine) : niveau réel relu ensuite
+  byte eventOverflows;  // Gestes perdus (file d'événements pleine)
+};
+
+extern ButtonStats buttonStats;
+extern volatile bool awokeByInterrupt; // Positionné à chaque changement sur le port D (réveil)
+
+void setupButton();            // Entrée avec pull-up, interruption de changement d'état armée
+void serviceButton();          // Fronts -> gestes, à chaque passe de loop()
+ButtonEvent nextButtonEvent(); // BTN_NONE si aucun geste en attente
+unsigned long buttonEventMicros(); // micros() du premier contact de l'appui du dernier geste rendu
+bool buttonInputPending();     // Bouton enfoncé ou front pas encore traité
+void ignoreCurrentPress();     // L'appui en cours (ex: celui du réveil) ne produira aucun geste
+
+#endif // BOUTON_H
@@ -0,0 +1,93 @@
+// buzzer.cpp - Arbitrage du buzzer et file des sons en attente
+
+#include "buzzer.h"
+#include "rapport.h"
+
+struct PendingSound {
+  SoundPriority priority;
+  unsigned int frequency;
+  unsigned int durationMs;
+  unsigned long queuedAt;  // millis() de la demande
+};
+
+BuzzerStats buzzerStats = { 0, 0, 0, 0 };
+
+static bool sounding = false;          // Un son occupe la voie
+static SoundPriority soundingPriority;
+static unsigned long soundStart = 0;
+static unsigned int soundDuration = 0;
+static PendingSound pending[BUZZER_QUEUE_SIZE]; // Par priorité décroissante, puis ordre d'arrivée
+static byte pendingCount = 0;
+
+// La voie se libère d'elle-même : tone() avec durée s'arrête sur l'ISR du Timer2
+static void updateSounding() {
+  if (sounding && millis() - soundStart >= soundDuration) sounding = false;
+}
+
+static void startSound(SoundPriority priority, unsigned int frequency, unsigned int durationMs) {
+  tone(BUZZER_PIN, frequency, durationMs);
+  sounding = true;
+  soundingPriority = priority;
+  soundStart = millis();
+  soundDuration = durationMs;
+  buzzerStats.played++;
+}
+
+static void removePending(byte index) {
+  for (byte i = index; i + 1 < pendingCount; i++) pending[i] = pending[i + 1];
+  pendingCount--;
+}
+
+static void enqueue(SoundPriority priority, unsigned int frequency, unsigned int durationMs) {
+  if (pendingCount == BUZZER_QUEUE_SIZE) {
+    if (pending[pendingCount - 1].priority >= priority) { buzzerStats.dropped++; return; } // Le nouveau est le moins prioritaire
+    pendingCount--; // Le dernier de la file cède sa place
+    buzzerStats.dropped++;
+  }
+  byte at = pendingCount;
+  while (at > 0 && pending[at - 1].priority < priority) { pending[at] = pending[at - 1]; at--; }
+  pending[at] = { priority, frequency, durationMs, millis() };
+  pendingCount++;
+  buzzerStats.delayed++;
+}
+
+void playSound(SoundPriority priority, unsigned int frequency, unsigned int durationMs) {
+  updateSounding();
+  if (sounding && soundingPriority > priority) {
+    enqueue(priority, frequency, durationMs);
+    return;
+  }
+  if (sounding && soundingPriority < priority) buzzerStats.preempted++;
+  startSound(priority, frequency, durationMs);
+}
+
+void buzzerSilence(SoundPriority upTo) {
+  updateSounding();
+  if (sounding && soundingPriority <= upTo) {
+    noTone(BUZZER_PIN);
+    sounding = false;
+  }
+  for (byte i = pendingCount; i > 0; i--) {
+    if (pending[i - 1].priority <= upTo) removePending(i - 1);
+  }
+}
+
+void serviceBuzzer() {
+  if (pendingCount == 0) return;
+  updateSounding();
+  if (sounding) return;
+  while (pendingCount > 0) {
+    PendingSound next = pending[0];
+    removePending(0);
+    if (millis() - next.queuedAt > BUZZER_MAX_DELAY_MS) { buzzerStats.dropped++; continue; } // Trop tard pour avoir un sens
+    startSound(next.priority, next.frequency, next.durationMs);
+    return;
+  }
+}
+
+void reportBuzzerStats() {
+  Report.print(F("Buzzer joues="));  Report.print(buzzerStats.played);
+  Report.print(F(" coupes="));       Report.print(buzzerStats.preempted);
+  Report.print(F(" retardes="));     Report.print(buzzerStats.delayed);
+  Report.print(F(" abandonnes="));   Report.println(buzzerStats.dropped);
+}
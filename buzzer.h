@@ -0,0 +1,37 @@
+// buzzer.h - Arbitrage du buzzer : une seule voie tone(), trois classes de priorité, file d'attente
+//
+// Clics de l'interface, temps du métronome, mélodies et carillons passent tous par playSound().
+// Règles :
+//  - voie libre : le son part tout de suite ;
+//  - son en cours de priorité inférieure : il est coupé (préemption) ;
+//  - son en cours de même priorité : le nouveau le remplace (temps suivant, note suivante) ;
+//  - son en cours de priorité supérieure : le nouveau attend dans une file de BUZZER_QUEUE_SIZE
+//    entrées, rangée par priorité. serviceBuzzer() le lance quand la voie se libère, sauf s'il a
+//    attendu plus de BUZZER_MAX_DELAY_MS : un clic ou un temps trop tardif est abandonné.
+// File pleine : le son de plus basse priorité est abandonné (le nouveau ou le dernier de la file).
+// Ainsi un clic d'encodeur ne coupe plus un temps du métronome, il est joué juste après.
+//
+// Les compteurs (joués, coupés, retardés, abandonnés) partent sur le port série à l'entrée du
+// diagnostic. Le banc d'essai mesure tone() directement, hors arbitrage.
+#ifndef BUZZER_H
+#define BUZZER_H
+
+#include <Arduino.h>
+#include "conf.h"
+
+enum SoundPriority : byte { SOUND_UI, SOUND_BEAT, SOUND_ALARM }; // Croissante
+
+struct BuzzerStats {
+  unsigned int played;     // Sons lancés (tout de suite ou après attente)
+  unsigned int preempted;  // Sons coupés par un son plus prioritaire
+  unsigned int delayed;    // Sons mis en attente
+  unsigned int dropped;    // Sons abandonnés (file pleine ou attente trop longue)
+};
+extern BuzzerStats buzzerStats;
+
+void playSound(SoundPriority priority, unsigned int frequency, unsigned int durationMs);
+void buzzerSilence(SoundPriority upTo); // Coupe le son en cours et vide la file jusqu'à cette priorité comprise
+void serviceBuzzer();                   // Lance le son en attente quand la voie se libère, à chaque passe de loop()
+void reportBuzzerStats();               // Envoie buzzerStats sur le port série
+
+#endif // BUZZER_H
@@ -0,0 +1,142 @@
+// checkpoint.cpp - Points de reprise du décompte en EEPROM
+
+#include "checkpoint.h"
+
+// Enregistrement en EEPROM (CHECKPOINT_RECORD_SIZE octets par case de l'anneau)
+struct CheckpointRecord {
+  byte sequence;              // Incrémenté à chaque écriture (modulo 256)
+  byte state;                 // TimerRunState au moment de l'écriture
+  uint16_t remainingSec;      // Temps restant (arrondi à la seconde supérieure)
+  uint16_t targetSec;         // Temps cible du décompte
+  byte check;                 // Octet de contrôle (voir recordCheck)
+};
+
+static byte newestSlot = CHECKPOINT_SLOTS - 1; // La prochaine écriture ira dans la case 0
+static byte newestSequence = 0;
+static bool haveRecord = false;
+static CheckpointRecord newestRecord;
+static unsigned long lastCheckpointTime = 0;
+static volatile byte eepromWriters = 0;        // Écritures EEPROM en cours hors interruption (imbriquées)
+static volatile bool powerFailPending = false; // Chute de tension survenue pendant l'une d'elles
+
+static byte recordCheck(const CheckpointRecord& rec) {
+  const byte* bytes = (const byte*)&rec;
+  byte check = 0x5A;
+  for (byte i = 0; i < sizeof(CheckpointRecord) - 1; i++) {
+    check = (check << 1 | check >> 7) ^ bytes[i]; // Rotation + XOR : détecte les écritures tronquées
+  }
+  return check;
+}
+
+static int slotAddress(byte slot) {
+  return EEPROM_ADDR_CHECKPOINT + slot * CHECKPOINT_RECORD_SIZE;
+}
+
+// Non réentrante : n'est appelée que par writeRecord() ou, hors écriture EEPROM en cours, par l'interruption
+static void storeRecord(TimerRunState state, unsigned int remainingSec) {
+  CheckpointRecord rec;
+  rec.sequence = newestSequence + 1;
+  rec.state = state;
+  rec.remainingSec = remainingSec;
+  rec.targetSec = targetTotalSeconds;
+  rec.check = recordCheck(rec);
+
+  byte slot = (newestSlot + 1) % CHECKPOINT_SLOTS;
+  int address = slotAddress(slot);
+  const byte* bytes = (const byte*)&rec;
+  for (byte i = 0; i < sizeof(CheckpointRecord); i++) {
+    EEPROM.update(address + i, bytes[i]); // L'octet de contrôle est écrit en dernier
+  }
+  newestSlot = slot;
+  newestSequence = rec.sequence;
+  newestRecord = rec;
+  haveRecord = true;
+}
+
+static unsigned int toSeconds(unsigned long remainingMs) {
+  return (unsigned int)((remainingMs + 999) / 1000);
+}
+
+// Dernier enregistrement avant la coupure (état du décompte à cet instant)
+static void storePowerFailRecord() {
+  if (currentTimerState == STATE_RUNNING) {
+    long left = (long)(modeState.timer.targetEndTime - millis()); // Signé : sûr au passage à 0 de millis()
+    storeRecord(STATE_RUNNING, left > 0 ? toSeconds(left) : 0);
+  } else if (currentTimerState == STATE_PAUSED) {
+    storeRecord(STATE_PAUSED, toSeconds(modeState.timer.pausedRemainingMillis));
+  }
+}
+
+void eepromWriteBegin() {
+  eepromWriters++; // L'interruption ne fait que lire le compteur
+}
+
+// Une chute de tension pendant l'écriture est reportée à sa fin, pour ne pas entrelacer deux
+// enregistrements dans la même case de l'anneau ni interrompre la programmation d'un autre octet
+void eepromWriteEnd() {
+  if (--eepromWriters == 0 && powerFailPending) {
+    powerFailPending = false;
+    storePowerFailRecord();
+  }
+}
+
+static void writeRecord(TimerRunState state, unsigned int remainingSec) {
+  eepromWriteBegin();
+  storeRecord(state, remainingSec);
+  eepromWriteEnd();
+}
+
+void checkpointBegin() {
+  static_assert(sizeof(CheckpointRecord) <= CHECKPOINT_RECORD_SIZE, "CHECKPOINT_RECORD_SIZE trop petit");
+  haveRecord = false;
+  for (byte slot = 0; slot < CHECKPOINT_SLOTS; slot++) {
+    CheckpointRecord rec;
+    EEPROM.get(slotAddress(slot), rec);
+    if (rec.check != recordCheck(rec) || rec.state > STATE_PAUSED) continue;
+    if (!haveRecord || (int8_t)(rec.sequence - newestSequence) > 0) {
+      newestSlot = slot;
+      newestSequence = rec.sequence;
+      newestRecord = rec;
+      haveRecord = true;
+    }
+  }
+
+  if (POWER_FAIL_DETECT_ENABLED) {
+    pinMode(POWER_FAIL_SENSE_PIN, INPUT);
+    DIDR1 |= _BV(AIN1D);                                           // Entrée numérique D7 inutile
+    ACSR = _BV(ACBG) | _BV(ACI) | _BV(ACIS1) | _BV(ACIS0);         // Bandgap sur AIN0, front montant de ACO
+    ACSR |= _BV(ACIE);
+  }
+}
+
+bool checkpointRestore(unsigned int& remainingSeconds, unsigned int& targetSeconds) {
+  if (!haveRecord) return false;
+  if (newestRecord.state == STATE_IDLE || newestRecord.remainingSec == 0) return false;
+  remainingSeconds = newestRecord.remainingSec;
+  targetSeconds = newestRecord.targetSec;
+  return true;
+}
+
+void checkpointSave(TimerRunState state, unsigned long remainingMs) {
+  writeRecord(state, toSeconds(remainingMs));
+  lastCheckpointTime = millis();
+}
+
+void checkpointClear() {
+  if (haveRecord && newestRecord.state == STATE_IDLE) return; // Déjà effacé : aucune écriture
+  writeRecord(STATE_IDLE, 0);
+}
+
+void serviceCheckpoint(unsigned long remainingMs) {
+  if (millis() - lastCheckpointTime >= CHECKPOINT_INTERVAL) {
+    checkpointSave(STATE_RUNNING, remainingMs);
+  }
+}
+
+// Chute de la tension d'alimentation : dernière écriture avant la coupure
+ISR(ANALOG_COMP_vect) {
+  ACSR &= ~_BV(ACIE); // Une seule fois
+  if (eepromWriters != 0) { powerFailPending = true; return; } // Écrit par eepromWriteEnd() en sortant
+  sei(); // ~20 ms d'EEPROM : millis(), le bus de l'écran et le port série continuent pendant ce temps
+  storePowerFailRecord();
+}
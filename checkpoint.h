@@ -0,0 +1,35 @@
+// checkpoint.h - Points de reprise du décompte en EEPROM (coupure de courant / reset)
+//
+// Pendant un décompte, l'état (restant, cible) est écrit périodiquement dans un anneau de
+// CHECKPOINT_SLOTS enregistrements en EEPROM. Chaque enregistrement porte un numéro de séquence
+// et un octet de contrôle : au démarrage, le plus récent valide indique si un décompte a été
+// interrompu. L'anneau répartit l'usure et EEPROM.update() n'écrit que les octets modifiés.
+//
+// Option (POWER_FAIL_DETECT_ENABLED) : le comparateur analogique compare AIN1 (D7, pont diviseur
+// sur l'alimentation non régulée) à la référence interne 1,1 V et déclenche une dernière écriture
+// lorsque la tension chute. Il faut assez de capacité de réserve pour ~20 ms d'écriture EEPROM,
+// plus la fin de l'écriture en cours s'il y en a une : tout écrivain EEPROM (réglages, presets,
+// banc, journal, points de reprise) s'encadre de eepromWriteBegin()/eepromWriteEnd() et la chute
+// survenue entre les deux est écrite par eepromWriteEnd(), jamais au milieu d'un autre octet.
+// Hors écriture, l'interruption écrit elle-même, interruptions réactivées (millis(), TWI, série).
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include "conf.h"
+#include "modes.h" // État du minuteur (modeState.timer)
+
+// Variables du minuteur utilisées par l'écriture sur chute de tension
+extern enum TimerRunState currentTimerState;
+extern unsigned int targetTotalSeconds;
+
+void checkpointBegin();                 // Recherche l'enregistrement le plus récent, arme la détection de chute
+bool checkpointRestore(unsigned int& remainingSeconds, unsigned int& targetSeconds);
+void checkpointSave(TimerRunState state, unsigned long remainingMs);
+void checkpointClear();                 // Plus de décompte en cours (fin, arrêt)
+void serviceCheckpoint(unsigned long remainingMs); // Écriture périodique pendant le décompte
+void eepromWriteBegin();                // Début d'une écriture EEPROM : la chute de tension attendra (imbricable)
+void eepromWriteEnd();                  // Fin : écrit l'enregistrement de coupure si la tension a chuté entre-temps
+
+#endif // CHECKPOINT_H
@@ -0,0 +1,200 @@
+// chrono.cpp - Chronomètre : base de temps, anneau des tours, affichage
+
+#include "chrono.h"
+#include "rapport.h"
+
+// État du chronomètre : modeState.chrono (modes.h), remis à zéro à chaque entrée dans le mode
+
+// --- Base de temps ---
+
+static void syncClock() {
+  unsigned long now = micros();
+  unsigned long wholeMs = (now - modeState.chrono.syncMicros) / 1000;
+  modeState.chrono.elapsedMs += wholeMs;
+  modeState.chrono.syncMicros += wholeMs * 1000; // Le reste (< 1 ms) est reporté au recalage suivant
+}
+
+// Temps écoulé à un instant horodaté (micros()), arrondi à la ms inférieure
+static unsigned long elapsedAt(unsigned long eventMicros) {
+  long delta = (long)(eventMicros - modeState.chrono.syncMicros);
+  if (delta >= 0) return modeState.chrono.elapsedMs + delta / 1000;
+  unsigned long before = (unsigned long)(999 - delta) / 1000;
+  return before > modeState.chrono.elapsedMs ? 0 : modeState.chrono.elapsedMs - before;
+}
+
+// --- Anneau des tours ---
+
+static unsigned int oldestLap() {
+  return modeState.chrono.lapCount > CHRONO_LAP_SLOTS ? modeState.chrono.lapCount - CHRONO_LAP_SLOTS + 1 : 1;
+}
+
+static unsigned long splitOf(unsigned int lap) {
+  if (lap == 0) return 0;
+  if (lap < oldestLap()) return modeState.chrono.evictedSplit; // Seul le tour juste avant le plus ancien est demandé
+  return modeState.chrono.laps[(lap - 1) % CHRONO_LAP_SLOTS];
+}
+
+static void recordLap(unsigned long split) {
+  byte index = modeState.chrono.lapCount % CHRONO_LAP_SLOTS;
+  if (modeState.chrono.lapCount >= CHRONO_LAP_SLOTS) modeState.chrono.evictedSplit = modeState.chrono.laps[index];
+  modeState.chrono.laps[index] = split;
+  modeState.chrono.lapCount++;
+}
+
+// "MM:SS" ou "MM:SS.CC" ; rend le nombre de caractères écrits
+static byte printChronoTime(Print& out, unsigned long ms, bool centis) {
+  unsigned long minutes = ms / 60000;
+  byte seconds = (ms / 1000) % 60;
+  byte len = 0;
+  if (minutes < 10) len += out.print('0');
+  len += out.print(minutes);
+  len += out.print(':');
+  if (seconds < 10) len += out.print('0');
+  len += out.print(seconds);
+  if (centis) {
+    byte cs = (ms % 1000) / 10;
+    len += out.print('.');
+    if (cs < 10) len += out.print('0');
+    len += out.print(cs);
+  }
+  return len;
+}
+
+void reportChronoLaps() {
+  Report.print(F("Chrono ")); printChronoTime(Report, modeState.chrono.elapsedMs, true);
+  Report.print(F(", tours=")); Report.println(modeState.chrono.lapCount);
+  if (oldestLap() > 1) { Report.print(F("(tours 1-")); Report.print(oldestLap() - 1); Report.println(F(" ecrases)")); }
+  for (unsigned int lap = oldestLap(); lap <= modeState.chrono.lapCount; lap++) {
+    Report.print(F("Tour ")); Report.print(lap);
+    Report.print(F(" : ")); printChronoTime(Report, splitOf(lap) - splitOf(lap - 1), true);
+    Report.print(F(" cumul ")); printChronoTime(Report, splitOf(lap), true);
+    Report.println();
+  }
+}
+
+// --- Affichage ---
+
+static void drawChronoClock() {
+  LCD.setCursor(STATUS_COL_START, STATUS_ROW);
+  byte statusLen;
+  if (modeState.chrono.state == CHRONO_RUNNING) { statusLen = LCD.print(LCD_TALL ? F("CHRONO RUN") : F("RUN")); }
+  else if (modeState.chrono.state == CHRONO_STOPPED) { statusLen = LCD.print(LCD_TALL ? F("CHRONO STOP") : F("STP")); }
+  else { statusLen = LCD.print(LCD_TALL ? F("CHRONO") : F("CHR")); }
+  clearRestOfLine(STATUS_COL_START + statusLen, STATUS_ROW);
+  drawBigClock(modeState.chrono.shownMIN, modeState.chrono.shownSEC);
+}
+
+static void drawChronoCentis() {
+  drawCentiseconds(modeState.chrono.shownCS);
+}
+
+// Ligne d'infos (4 lignes seulement) : "T12 +00:12.34 01:23" = tour, durée du tour, cumul
+static void drawLapLine() {
+  if (!LCD_TALL) return;
+  LCD.setCursor(0, MELODY_NAME_ROW);
+  byte len;
+  if (modeState.chrono.lapCount == 0) {
+    if (modeState.chrono.state == CHRONO_RUNNING) len = LCD.print(F("Clic:Tour Long:Stop"));
+    else if (modeState.chrono.state == CHRONO_STOPPED) len = LCD.print(F("Clic:Go Long:RAZ"));
+    else len = LCD.print(F("Clic:Go Long:Menu"));
+  } else {
+    unsigned int lap = modeState.chrono.viewLap ? modeState.chrono.viewLap : modeState.chrono.lapCount;
+    if (lap < oldestLap()) lap = oldestLap(); // Tour affiché écrasé entre-temps
+    unsigned long split = splitOf(lap);
+    len = LCD.print('T');
+    if (lap < 10) len += LCD.print('0');
+    len += LCD.print(lap);
+    len += LCD.print(F(" +"));
+    len += printChronoTime(LCD, split - splitOf(lap - 1), true);
+    if (len + textLen(" MM:SS.CC") <= LCD_COLS) { len += LCD.print(' '); len += printChronoTime(LCD, split, true); }
+    else if (len + textLen(" MM:SS") <= LCD_COLS) { len += LCD.print(' '); len += printChronoTime(LCD, split, false); }
+  }
+  clearRestOfLine(len, MELODY_NAME_ROW);
+}
+
+// Valeurs à afficher d'après le temps écoulé ; demande les rendus qui ont changé
+static void showElapsed(unsigned long ms, bool force) {
+  int minutes = (ms / 60000) % 100; // Au-delà de 99 minutes, les grands chiffres repartent de 00
+  int seconds = (ms / 1000) % 60;
+  modeState.chrono.shownCS = (ms % 1000) / 10;
+  if (force || minutes != modeState.chrono.shownMIN || seconds != modeState.chrono.shownSEC) {
+    modeState.chrono.shownMIN = minutes;
+    modeState.chrono.shownSEC = seconds;
+    requestDisplay(DISP_PRIO_SECONDS, drawChronoClock);
+  }
+  unsigned long now = millis();
+  if (force || now - modeState.chrono.lastCsRequest >= csUpdateInterval) {
+    modeState.chrono.lastCsRequest = now;
+    requestDisplay(DISP_PRIO_CENTIS, drawChronoCentis);
+  }
+}
+
+void redrawChronoScreen() {
+  LCD.clear();
+  showElapsed(modeState.chrono.elapsedMs, true);
+  drawChronoClock();
+  drawChronoCentis();
+  drawLapLine();
+}
+
+// --- Gestionnaires de mode ---
+
+void enterChronoMode() {
+  resetActivityTimer();
+  bigNum.begin(); // Les menus ont remplacé deux caractères personnalisés par les flèches
+  redrawChronoScreen();
+}
+
+void tickChronoMode() {
+  if (modeState.chrono.state == CHRONO_RUNNING) {
+    syncClock();
+    showElapsed(modeState.chrono.elapsedMs, false);
+  } else {
+    checkIdleSleep(); // Jamais pendant le comptage : micros() s'arrête en veille
+  }
+}
+
+void handleChronoEncoder(int delta) {
+  if (modeState.chrono.lapCount == 0) return;
+  long lap = (long)(modeState.chrono.viewLap ? modeState.chrono.viewLap : modeState.chrono.lapCount) + delta;
+  lap = constrain(lap, (long)oldestLap(), (long)modeState.chrono.lapCount);
+  modeState.chrono.viewLap = lap == modeState.chrono.lapCount ? 0 : lap; // Revenir au dernier tour reprend son suivi
+  playClickSound(); resetActivityTimer();
+  requestDisplay(DISP_PRIO_STATUS, drawLapLine);
+}
+
+void handleChronoButton(ButtonEvent event) {
+  unsigned long pressMicros = buttonEventMicros(); // Premier contact, horodaté par l'ISR
+  resetActivityTimer();
+  if (event == BTN_LONG_PRESS) {
+    if (modeState.chrono.state == CHRONO_RUNNING) { // Arrêt à l'instant de l'appui, pas à la détection de l'appui long
+      syncClock();
+      modeState.chrono.elapsedMs = elapsedAt(pressMicros);
+      modeState.chrono.state = CHRONO_STOPPED;
+      reportChronoLaps();
+    } else if (modeState.chrono.state == CHRONO_STOPPED) {
+      modeState.chrono.state = CHRONO_RESET;
+      modeState.chrono.elapsedMs = 0;
+      modeState.chrono.lapCount = 0;
+      modeState.chrono.viewLap = 0;
+    } else {
+      setMode(MODE_MENU_MAIN);
+      return;
+    }
+    showElapsed(modeState.chrono.elapsedMs, true);
+    requestDisplay(DISP_PRIO_STATUS, drawLapLine);
+  } else if (isClickEvent(event)) {
+    playClickSound();
+    if (modeState.chrono.state == CHRONO_RUNNING) {
+      syncClock();
+      recordLap(elapsedAt(pressMicros));
+      modeState.chrono.viewLap = 0;
+    } else { // Départ ou reprise
+      modeState.chrono.syncMicros = pressMicros;
+      modeState.chrono.state = CHRONO_RUNNING;
+      syncClock();
+      showElapsed(modeState.chrono.elapsedMs, true);
+    }
+    requestDisplay(DISP_PRIO_STATUS, drawLapLine);
+  }
+}
@@ -0,0 +1,46 @@
+// chrono.h - Chronomètre (comptage croissant) avec tours et temps intermédiaires
+//
+// Départ, tour et arrêt sont datés à l'instant du PREMIER contact du bouton, horodaté par l'ISR
+// (buttonEventMicros(), bouton.h) : ni la latence de loop(), ni un rafraîchissement I2C en
+// cours, ni le délai de reconnaissance du geste (relâchement, appui long) n'entrent dans la
+// mesure. L'erreur de capture se limite à la latence de l'ISR et à la résolution de micros()
+// (4 µs), puis à la troncature à la milliseconde.
+//
+// Base de temps : un cumul en ms recalé sur micros() à chaque passe (le reste en µs est reporté),
+// ce qui évite le débordement de micros() au bout de 71 minutes. Un instant horodaté, antérieur ou
+// postérieur au dernier recalage, est converti par différence signée.
+//
+// Les temps intermédiaires (cumul au moment du tour) sont rangés dans un anneau de
+// CHRONO_LAP_SLOTS entrées : au-delà, les plus anciens sont écrasés (la durée du plus ancien tour
+// conservé reste calculable). L'encodeur fait défiler les tours sur la ligne d'infos ; la liste
+// complète part sur le port série à chaque arrêt.
+//
+// Commandes : clic = départ / tour / reprise ; appui long = arrêt, puis remise à zéro, puis menu.
+#ifndef CHRONO_H
+#define CHRONO_H
+
+#include <Arduino.h>
+#include "conf.h"
+#include "ecran.h"
+#include "geometrie.h"
+#include "affichage.h"
+#include "modes.h"
+#include "bouton.h"
+#include "timer.h" // Grands chiffres MM.SS et ".CS" (drawBigClock, drawCentiseconds)
+
+// Fonctions utilitaires du .ino principal
+void resetActivityTimer();
+void playClickSound();
+void checkIdleSleep();
+void clearRestOfLine(byte startCol, byte row);
+
+void reportChronoLaps(); // Tours conservés (durée et cumul) sur le port série
+
+// Gestionnaires de MODE_CHRONO (modes.h)
+void enterChronoMode();
+void tickChronoMode();
+void handleChronoEncoder(int delta);
+void handleChronoButton(ButtonEvent event);
+void redrawChronoScreen();
+
+#endif // CHRONO_H
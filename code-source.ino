@@ -20,6 +20,31 @@
 //  - AMÉLIORATION : Affichage du nom du tempo classique sélectionné sur l'écran principal du métronome.
 //  - RÉORGANISATION : Logique du métronome déplacée vers metronome.h/.cpp.
 //  - RÉORGANISATION : Logique du minuteur déplacée vers timer.h/.cpp.
+//  - AMÉLIORATION : Mélodies compactées en PROGMEM, générées depuis des fichiers RTTTL (tools/).
+//  - AMÉLIORATION : Ordonnanceur d'affichage par priorités avec budget I2C par passe (affichage.h/.cpp).
+//  - AJOUT : Écran "Diagnostic" (SRAM libre, marge minimale de pile, fragmentation du tas) + rapport série.
+//  - AMÉLIORATION : Démarrage rapide (écran opérationnel immédiat), écran de démarrage optionnel non bloquant.
+//  - AJOUT : Reprise du décompte après coupure de courant/reset (points de reprise EEPROM, checkpoint.h/.cpp).
+//  - AJOUT : Décompte basse consommation (écran éteint, power-down entre réveils du chien de garde, lowpower.h/.cpp).
+//  - AMÉLIORATION : Bouton lu par interruption (fronts horodatés) : clic, double-clic, appui long, répétition (bouton.h/.cpp).
+//  - RÉORGANISATION : Table des modes en PROGMEM (enter/exit/tick/encodeur/bouton/redessin), encodeur relatif (modes.h/.cpp).
+//  - AMÉLIORATION : Disposition de l'écran calculée à la compilation pour 16x2, 20x4 ou 40x4 (LCD_PANEL, geometrie.h).
+//  - AJOUT : Afficheur interchangeable : LCD HD44780/PCF8574 ou OLED SSD1306 128x64 (DISPLAY_OLED, ecran*.h/.cpp).
+//  - AJOUT : Sorties programmées (relais, lampe, flash) : délais et trains d'impulsions repérés sur le départ/la fin (sorties.h/.cpp).
+//  - AJOUT : Bibliothèque de 32 presets nommés en EEPROM, triés par usage récent, ajout/édition/suppression (presets.h/.cpp).
+//  - AMÉLIORATION : 16 indications de tempo italiennes en PROGMEM (plages, recherche dichotomique) : tout BPM est nommé.
+//  - AJOUT : Chronomètre avec tours et temps intermédiaires datés au front du bouton (ISR), anneau de tours (chrono.h/.cpp).
+//  - AJOUT : Horloge MIDI 24 PPQN maître (Timer1) ou esclave (boucle de phase) pour le métronome, MIDI_ENABLED (midi.h/.cpp).
+//  - AJOUT : Banc d'essai caché (appui long sur Diagnostic) : débit écran, EEPROM, tone(), passes de loop(), historique EEPROM (banc.h/.cpp).
+//  - AMÉLIORATION : Réglages regroupés en un enregistrement EEPROM versionné (CRC-16), migration de l'ancien schéma, export/import série (reglages.h/.cpp).
+//  - AJOUT : Barre de progression du décompte au 1/5 de case (100 positions), seule la case modifiée est redessinée (progression.h/.cpp).
+//  - AMÉLIORATION : État des modes superposé dans une union (minuteur, métronome, sous-menus, chrono) et indicateurs en champs de bits : 56 octets de SRAM rendus (modes.h).
+//  - AMÉLIORATION : Écran piloté par une file I2C vidée sous interruption (TWI direct, sans Wire) : loop() n'attend plus le bus (ecran_bus.h/.cpp).
+//  - AJOUT : Séance de pratique minutée : métronome et décompte dans la même passe, arrêt en fin de mesure, coût par passe mesuré (pratique.h/.cpp).
+//  - AMÉLIORATION : Buzzer arbitré par priorité (alarme > temps > clic) avec une courte file d'attente : un clic ne coupe plus un temps (buzzer.h/.cpp).
+//  - AJOUT : Journal des entrées (encodeur, bouton) et rejeu déterministe au démarrage, empreinte de l'état comparée, INPUT_JOURNAL (journal.h/.cpp, tools/journal.py).
+//  - AMÉLIORATION : Temps du métronome sur une grille absolue (reste de 60000/BPM réparti, sans dérive), pause au reste exact, retards mesurés envoyés sur le port série.
+//  - AMÉLIORATION : Tempo réglable pendant que le métronome bat (phase gardée, chiffres modifiés seuls redessinés, enregistrement différé), accelerando par double-clic (metronome.h/.cpp).
 //
 //  Date de génération : Dimanche 25 mai 2025 CEST (MAJ 25/05/2025)
 //  Lieu : Montmédy, Grand Est, France
@@ -27,37 +52,64 @@
 //**************************************************************
 
 #include <EEPROM.h>
-#include "Wire.h"
 #include <string.h> // Pour strlen
-#include "LiquidCrystal_I2C.h"
 #include "RotaryEncoder.h"
-#include "BigNumbers_I2C.h"
+#include "ecran.h"      // Afficheur choisi à la compilation (LCD HD44780 ou OLED SSD1306)
 
 #include "conf.h"    // Contient maintenant les enums et constantes globales
 #include "melodie.h"
 #include "metronome.h" 
 #include "timer.h"     
+#include "affichage.h" // Ordonnanceur de rafraîchissement de l'écran
+#include "diagnostic.h" // Instrumentation SRAM et écran de diagnostic
+#include "lowpower.h"   // Décompte en basse consommation (power-down + WDT)
+#include "bouton.h"     // Gestes du bouton capturés par interruption
+#include "modes.h"      // Table des modes (enter/exit/tick/encodeur/bouton/redessin)
+#include "sorties.h"    // Sorties programmées pendant le décompte
+#include "presets.h"    // Bibliothèque de presets en EEPROM
+#include "chrono.h"     // Chronomètre avec tours horodatés par interruption
+#include "pratique.h"   // Séance minutée : métronome et décompte ensemble
+#include "buzzer.h"     // Arbitrage du buzzer (priorités, file d'attente)
+#include "banc.h"       // Banc d'essai du matériel (mode caché)
+#include "midi.h"       // Horloge MIDI maître / esclave du métronome (MIDI_ENABLED)
+#include "rapport.h"    // Rapports texte sur le port série (coupés quand l'UART sert au MIDI)
+#include "reglages.h"   // Réglages persistants versionnés, export/import sur le port série
+#include "progression.h" // Barre de progression du décompte (ligne d'infos)
+#include "journal.h"    // Journal des entrées et rejeu (INPUT_JOURNAL)
 
 #include <avr/sleep.h>
 #include <avr/power.h>
 #include <avr/interrupt.h>
 
 // Définition des tableaux déclarés extern dans conf.h
-const unsigned int PRESET_VALUES[NUM_PRESETS] = { 0, 60, 120, 180 }; // Manuel, 1min, 2min, 3min
+// Presets installés au premier démarrage (presets.h), aux emplacements 0.. : anciens choix 1..3
+const DefaultPreset DEFAULT_PRESETS[NUM_DEFAULT_PRESETS] PROGMEM = {
+  { "1 MIN", 60 }, { "2 MIN", 120 }, { "3 MIN", 180 }
+};
 const unsigned int SLEEP_DELAY_VALUES[NUM_SLEEP_OPTIONS] = { 0, 60, 300, 600 }; // Off, 1min, 5min, 10min (en secondes)
 const char* const SLEEP_DELAY_NAMES[NUM_SLEEP_OPTIONS] = { "Off", "1 min", "5 min", "10 min" };
 
-// --- Définition des Préréglages de Tempo --- <<< NOUVEAU (après les autres tableaux)
-const TempoPreset tempoPresets[NUM_TEMPO_PRESETS] = {
-  {"Grave",       "tres lent",          20},
-  {"Largo",       "large",              50}, // J'utilise "Largo" pour garder le nom court
-  {"Adagio",      "lent, a l'aise",     70}, // "Adagio" pour la brièveté
-  {"Andante",     "allant",            108}, // "Andante"
-  {"Moderato",    "modere",            120},
-  {"Allegro",     "rapide",            168},
-  {"Presto",      "tres rapide",       188},
-  {"Prestissimo", "extreme. rapide",   208}  // "extreme. rapide" pour "extrêmement rapide"
+// --- Définition des Indications de Tempo (PROGMEM, triées par début de plage) ---
+const TempoMarking tempoMarkings[] PROGMEM = {
+  // nom             description           début  menu
+  {"Larghissimo",  "extreme. lent",      20,    22},
+  {"Grave",        "tres lent",          25,    35},
+  {"Largo",        "large",              40,    48},
+  {"Lento",        "lent",               55,    58},
+  {"Larghetto",    "assez large",        60,    63},
+  {"Adagio",       "lent, a l'aise",     66,    70},
+  {"Adagietto",    "assez a l'aise",     72,    74},
+  {"Andante",      "allant",             76,    84},
+  {"Andante mod.", "allant modere",      92,    95},
+  {"Andantino",    "un peu allant",      98,   102},
+  {"Moderato",     "modere",            108,   112},
+  {"Allegretto",   "assez rapide",      116,   120},
+  {"Allegro",      "rapide",            124,   138},
+  {"Vivace",       "vif",               156,   162},
+  {"Presto",       "tres rapide",       168,   184},
+  {"Prestissimo",  "extreme. rapide",   200,   208}
 };
+static_assert(sizeof(tempoMarkings) / sizeof(tempoMarkings[0]) == NUM_TEMPO_MARKINGS, "tempoMarkings doit avoir NUM_TEMPO_MARKINGS lignes");
 
 // Définitions des variables globales qui utilisent les enums de conf.h
 Mode currentMode = MODE_TIMER;
@@ -65,8 +117,8 @@ TimerRunState currentTimerState = STATE_IDLE;
 MetronomeRunState currentMetroState = METRO_STOPPED;
 
 // --- Initialisation des Objets Matériels ---
-LiquidCrystal_I2C LCD(LCD_ADDR, LCD_COLS, LCD_ROWS);
-BigNumbers_I2C bigNum(&LCD);
+DisplayDevice LCD(LCD_ADDR, LCD_COLS, LCD_ROWS);
+BigNumberDevice bigNum(&LCD);
 RotaryEncoder encoder(ENCODER_DT_PIN, ENCODER_CLK_PIN);
 
 // Définition caractères flèches custom
@@ -76,65 +128,39 @@ const byte ARROW_UP_CHAR_CODE = 0;
 const byte ARROW_DOWN_CHAR_CODE = 1; 
 
 // --- Variables Globales (celles qui restent dans le .ino principal ou sont partagées) ---
-// Variables Timer (maintenant utilisées via extern dans timer.h/timer.cpp)
-bool blinkDone = false; 
-int lastPos = 0;        
-int newPos = 0;         
-boolean buttonWasUp = true;
-boolean longPressDetected = false;
-unsigned long buttonDownTime = 0;
-
-int displaySEC = 0;
-int displayMIN = 0;
-int displayCS = 0;
+// Variables Timer : le décompte en cours vit dans modeState.timer (modes.h), seul le temps cible reste global
 unsigned int targetTotalSeconds = 0;
-unsigned long targetEndTime = 0;
-long remainingMillis = 0;
-unsigned long pausedRemainingMillis = 0; 
-int lastDisplayedSEC = -1;
-int lastDisplayedMIN = -1;
-unsigned long lastCsUpdateTime = 0;
-
-bool isEndSequenceBlinking = false;
-unsigned long blinkSequenceStartTime = 0;
-unsigned long lastEndBlinkToggleTime = 0;
-bool endBlinkStateIsOn = true;
-
-// Variables Menu (restent ici car gèrent les menus principaux)
+
+// Variables Menu (position du menu principal ; les sous-menus utilisent modeState.menu)
 byte currentMelodyChoice = 0;
 byte currentPresetChoice = 0;
 byte menuMainIndex = 0;
-byte menuMelodyIndex = 0;
-byte menuPresetIndex = 0;
-byte presetMenuScrollOffset = 0;
 byte menuMainScrollOffset = 0;
-byte melodyMenuScrollOffset = 0;
-byte veilleMenuScrollOffset = 0;
-byte menuTempoPresetIndex = 0;        // <<< NOUVEAU : Index pour le menu des presets de tempo
-byte tempoPresetMenuScrollOffset = 0; // <<< NOUVEAU : Offset de défilement pour ce menu
-
-int lastEncoderMenuPos = 0; 
 
-const char* mainMenuItems[] = { " Melodie", " Preset ", " Veille ", " FeedbackSon", " Melodie O/F", " Metronome", " Metro.Rythm", " Tempo Class.", " Quitter" };
+const char* mainMenuItems[] = { " Melodie", " Preset ", " Veille ", " FeedbackSon", " Melodie O/F", " Metronome", " Pratique", " Metro.Rythm", " Tempo Class.", " Chrono",
+#if MIDI_ENABLED
+                                " MIDI",
+#endif
+                                " Diagnostic", " Quitter" };
 const byte numMainMenuOptions = sizeof(mainMenuItems) / sizeof(mainMenuItems[0]);
 const char* melodyNames[] = { "Mario    ", "StarWars ", "Zelda    ", "Nokia    ", "Tetris   ", "Bip-Bip  " }; 
-const char* presetNames[] = { "Manuel", "1 Min", "2 Min", "3 Min" };
 
 // Variables Veille (restent ici car goToSleep est ici)
 byte currentSleepSetting = 0;
 unsigned long configuredSleepDelayMillis = 0;
 unsigned long lastActivityTime = 0;
-volatile bool awokeByInterrupt = false; 
-bool buzzerFeedbackEnabled = true;
-bool timerMelodyEnabled = true;
+volatile bool awokeByInterrupt = false; // Écrit par une ISR : hors de appFlags
+AppFlags appFlags = { true, true, false }; // Bips, mélodie de fin, écran de démarrage (conf.h)
 
 // Variables Globales pour MÉTRONOME (définies ici, extern dans metronome.h)
 int currentBPM = DEFAULT_BPM;
-unsigned long lastMetroBeatTime = 0;
-byte currentBeatInMeasure = 0;
 byte timeSignatureNum = DEFAULT_TIME_SIGNATURE_NUMERATOR;
 byte timeSignatureDen = DEFAULT_TIME_SIGNATURE_DENOMINATOR;
-int metroEncoderLastPos = 0; 
+
+// Variables Démarrage
+byte splashStage = 0;              // 0 = titre, 1 = "Initialisation...", 2 = auteur/version
+unsigned long splashStartTime = 0;
+unsigned long bootReadyMicros = 0; // Temps entre la mise sous tension (init) et la fin de setup()
 
 // --- Déclarations de fonctions qui restent dans le .ino principal ---
 void resetActivityTimer();
@@ -143,247 +169,257 @@ void handleButton();
 void enterMainMenu();
 void displayMainMenu();
 void navigateMainMenu(int diff);
-void selectMainMenuItem();
+void selectMainMenuItem(ButtonEvent event);
 void enterMelodyMenu();
 void displayMelodyMenu();
 void navigateMelodyMenu(int diff);
-void selectMelodyMenuItem();
+void selectMelodyMenuItem(ButtonEvent event);
 void enterPresetMenu();
 void displayPresetMenu();
 void navigatePresetMenu(int diff);
-void selectPresetMenuItem();
+void selectPresetMenuItem(ButtonEvent event);
 void enterVeilleMenu();
 void displayVeilleMenu();
 void navigateVeilleMenu(int diff);
-void selectVeilleMenuItem();
-void exitMenu();
-void saveChoiceToEEPROM(int address, byte value); 
+void selectVeilleMenuItem(ButtonEvent event);
+void loadPreferences();
 void displayStatusLine3(); 
 void clearRestOfLine(byte startCol, byte row);
 void playClickSound();
 void goToSleep();
+void checkIdleSleep();
+void ignoreWakeInput();
 void enterTempoPresetMenu();    // <<< NOUVELLE FONCTION
 void displayTempoPresetMenu();  // <<< NOUVELLE FONCTION
 void navigateTempoPresetMenu(int diff); // <<< NOUVELLE FONCTION
-void selectTempoPresetMenuItem(); // <<< NOUVELLE FONCTION
+void selectTempoPresetMenuItem(ButtonEvent event); // <<< NOUVELLE FONCTION
+void startBootSplash();
+void serviceBootSplash();
+void endBootSplash();
+void drawTimerScreen();
+
+// --- Table des modes (modes.h) : une ligne par valeur de l'enum Mode, dans le même ordre ---
+const ModeHandlers MODE_TABLE[] PROGMEM = {
+  // enter                 exit               tick               encodeur                  bouton                     redessin (réveil)
+  { enterTimerMode,        exitTimerMode,     tickTimerMode,     handleTimerEncoderInput,  handleTimerButton,         enterTimerMode },         // MODE_TIMER
+  { enterMainMenu,         nullptr,           nullptr,           navigateMainMenu,         selectMainMenuItem,        displayMainMenu },        // MODE_MENU_MAIN
+  { enterMelodyMenu,       nullptr,           nullptr,           navigateMelodyMenu,       selectMelodyMenuItem,      displayMelodyMenu },      // MODE_MENU_MELODY
+  { enterPresetMenu,       nullptr,           nullptr,           navigatePresetMenu,       selectPresetMenuItem,      displayPresetMenu },      // MODE_MENU_PRESET
+  { enterVeilleMenu,       nullptr,           nullptr,           navigateVeilleMenu,       selectVeilleMenuItem,      displayVeilleMenu },      // MODE_MENU_VEILLE
+  { enterMetronomeMode,    exitMetronomeMode, tickMetronomeMode, handleMetronomeEncoder,   handleMetronomeButton,     displayMetronomeScreen }, // MODE_METRONOME
+  { enterTSMetroMenu,      nullptr,           nullptr,           navigateTSMetroMenu,      selectTSMetroMenuItem,     displayTSMetroMenu },     // MODE_MENU_TS_METRO
+  { enterTempoPresetMenu,  nullptr,           nullptr,           navigateTempoPresetMenu,  selectTempoPresetMenuItem, displayTempoPresetMenu }, // MODE_MENU_TEMPO_PRESET
+  { enterDiagnosticMode,   nullptr,           loopDiagnostic,    nullptr,                  handleDiagnosticButton,    redrawDiagnosticScreen }, // MODE_DIAGNOSTIC
+  { enterPresetEditor,     nullptr,           nullptr,           handlePresetEditorEncoder, handlePresetEditorButton, displayPresetEditor },    // MODE_EDIT_PRESET
+  { enterChronoMode,       nullptr,           tickChronoMode,    handleChronoEncoder,      handleChronoButton,        redrawChronoScreen },     // MODE_CHRONO
+  { enterBenchMode,        nullptr,           tickBenchMode,     handleBenchEncoder,       handleBenchButton,         redrawBenchScreen },      // MODE_BENCH
+  { enterPracticeMode,     exitPracticeMode,  tickPracticeMode,  handlePracticeEncoder,    handlePracticeButton,      redrawPracticeScreen }    // MODE_PRACTICE
+};
+static_assert(sizeof(MODE_TABLE) / sizeof(MODE_TABLE[0]) == MODE_COUNT, "MODE_TABLE doit avoir une ligne par valeur de l'enum Mode");
+
+// --- Calendrier des sorties (sorties.h) : délais en ms par rapport au départ ou à la fin du décompte ---
+const OutputChannelConfig OUTPUT_CHANNELS[] PROGMEM = {
+  // broche      actif bas  début                     fin                     impulsions (ms)
+  { RELAY_PIN,   true,      OUT_FROM_START, 0,        OUT_FROM_END, 0,        0,   0   }, // Pompe : pendant tout le décompte
+  { LAMP_PIN,    false,     OUT_FROM_START, 2000,     OUT_FROM_END, 10000,    0,   0   }, // Lampe : 2 s après le départ, 10 s après la fin
+  { STROBE_PIN,  false,     OUT_FROM_END,   -10000,   OUT_FROM_END, 3000,     100, 400 }  // Flash : 10 s avant la fin jusqu'à 3 s après
+};
+static_assert(sizeof(OUTPUT_CHANNELS) / sizeof(OUTPUT_CHANNELS[0]) == NUM_OUTPUT_CHANNELS, "OUTPUT_CHANNELS doit avoir NUM_OUTPUT_CHANNELS lignes");
 
 // --- Fonction d'initialisation ---
 void setup() {
-  pinMode(BUTTON_PIN, INPUT_PULLUP);
-  pinMode(RELAY_PIN, OUTPUT);
+#if !MIDI_ENABLED
+  Serial.begin(SERIAL_BAUD);
+#endif
+  loadSettings(); // Réglages persistants (migration d'un ancien schéma) avant tout setup...() qui les lit
+  journalSetup(); // Rejeu armé : les réglages du journal remplacent ceux de l'unité
+  setupMidi();    // MIDI_ENABLED : l'UART passe au MIDI (31250 bauds), les rapports texte sont coupés
+  setupButton(); // Entrée + capture des fronts par interruption (bouton.h)
+  setupOutputs(); // Relais et autres sorties programmées, inactifs (sorties.h)
   pinMode(BUZZER_PIN, OUTPUT);
-  digitalWrite(RELAY_PIN, HIGH); 
   digitalWrite(BUZZER_PIN, LOW); 
 
   LCD.begin();
   LCD.backlight();
   LCD.clear();
 
-  // Boot screen 1
-  LCD.setCursor(0, 1); LCD.print(F("   Super Minuteur   "));
-  LCD.setCursor(0, 2); LCD.print(F("    & Metronome     "));
-  delay(1000);
-  LCD.setCursor(0, 2); LCD.print(F("  Initialisation... "));
-  delay(1500); LCD.clear();
-
-  // Boot screen 2
-  LCD.setCursor(0, 0); LCD.print(F("Auteur: ")); LCD.print(AUTHOR_NAME);
-  LCD.setCursor(0, 1); LCD.print(F("Vers: ")); LCD.print(FIRMWARE_VERSION);
-  LCD.setCursor(0, 2); LCD.print(F("Date: ")); LCD.print(F(__DATE__)); 
-  LCD.setCursor(0, 3); LCD.print(F("Time: ")); LCD.print(F(__TIME__)); 
-  delay(1500); LCD.clear();
-
-  // Charger les préférences EEPROM
-  byte savedMelody = EEPROM.read(EEPROM_ADDR_MELODY);
-  if (savedMelody >= NUM_MELODIES) { currentMelodyChoice = 0; EEPROM.update(EEPROM_ADDR_MELODY, currentMelodyChoice); }
-  else { currentMelodyChoice = savedMelody; }
-  menuMelodyIndex = currentMelodyChoice; 
-
-  // currentPresetChoice est initialisé dans setupTimer() maintenant
-  // menuPresetIndex = currentPresetChoice; // Sera basé sur currentPresetChoice après setupTimer()
-
-  currentSleepSetting = EEPROM.read(EEPROM_ADDR_SLEEP_DELAY);
-  if (currentSleepSetting >= NUM_SLEEP_OPTIONS) { currentSleepSetting = 0; EEPROM.update(EEPROM_ADDR_SLEEP_DELAY, currentSleepSetting); }
-  configuredSleepDelayMillis = (unsigned long)SLEEP_DELAY_VALUES[currentSleepSetting] * 1000UL;
+  // Démarrage rapide : préférences chargées et écran opérationnel prêt avant tout écran de démarrage
 
-  byte savedFeedbackState = EEPROM.read(EEPROM_ADDR_BUZZER_FEEDBACK);
-  if (savedFeedbackState == 0) { buzzerFeedbackEnabled = false; }
-  else { buzzerFeedbackEnabled = true; if (savedFeedbackState > 1 && savedFeedbackState != 0xFF ) { EEPROM.update(EEPROM_ADDR_BUZZER_FEEDBACK, 1); } }
-  
-  byte savedTimerMelodyState = EEPROM.read(EEPROM_ADDR_TIMER_MELODY_ENABLED);
-  if (savedTimerMelodyState == 0) { timerMelodyEnabled = false; }
-  else { timerMelodyEnabled = true; if (savedTimerMelodyState != 1 && savedTimerMelodyState != 0 && savedTimerMelodyState != 0xFF) { EEPROM.update(EEPROM_ADDR_TIMER_MELODY_ENABLED, 1); } }
+  // Charger les préférences (copie RAM des réglages EEPROM, reglages.h)
+  loadPreferences();
+  // currentPresetChoice est initialisé dans setupPresets() maintenant
 
   setupMetronome(); 
+  setupPresets();   // Bibliothèque de presets et choix courant, avant le temps cible du minuteur
   setupTimer();     // <<< APPEL À L'INITIALISATION DU TIMER
-
-  menuPresetIndex = currentPresetChoice; // Initialiser l'index du menu preset après setupTimer
+  saveSettings();   // Valeurs réparées ou migrées : seuls les octets changés sont écrits
 
   bigNum.begin(); 
-  encoder.setPosition(lastPos * STEPS); // Initialiser la position de l'encodeur pour le timer
 
   resetActivityTimer(); 
 
-  currentMode = MODE_TIMER; 
-  currentTimerState = STATE_IDLE;
+  currentMode = MODE_TIMER; // currentTimerState est fixé par setupTimer() (PAUSE si décompte à reprendre)
+  if (BOOT_SPLASH_ENABLED && !modeState.timer.timerResumePending) {
+    startBootSplash(); // Non bloquant : l'écran du minuteur sera dessiné à la fin ou à la première action
+  } else {
+    drawTimerScreen();
+  }
+
+  bootReadyMicros = micros(); // Prêt : la boucle traite les entrées dès maintenant
+  Report.print(F("Pret en ")); Report.print(bootReadyMicros / 1000); Report.print(F("."));
+  Report.print((bootReadyMicros / 100) % 10); Report.println(F(" ms"));
+  journalBegin(); // Origine des temps du journal (et du rejeu)
+
+  updateMemoryStats();
+  reportMemoryStats();
+}
+
+// Préférences du .ino lues dans settings ; une valeur hors plage revient à son défaut
+void loadPreferences() {
+  if (settings.melody >= NUM_MELODIES) { settings.melody = 0; }
+  currentMelodyChoice = settings.melody;
+
+  if (settings.sleepDelay >= NUM_SLEEP_OPTIONS) { settings.sleepDelay = 0; }
+  currentSleepSetting = settings.sleepDelay;
+  configuredSleepDelayMillis = (unsigned long)SLEEP_DELAY_VALUES[currentSleepSetting] * 1000UL;
+
+  appFlags.buzzerFeedbackEnabled = settings.buzzerFeedback != 0; // 0xFF (jamais réglé) = activé
+  settings.buzzerFeedback = appFlags.buzzerFeedbackEnabled;
+  appFlags.timerMelodyEnabled = settings.timerMelody != 0;
+  settings.timerMelody = appFlags.timerMelodyEnabled;
+}
+
+// Réglages importés par la console série (reglages.h) : tout est relu, puis écran du minuteur
+void applySettings() {
+  loadPreferences();
+  setupMetronome();
+  setupPresets();
+  setMode(MODE_TIMER); // Temps cible rechargé depuis le preset ou le temps manuel
+}
+
+// --- Écran de démarrage (optionnel, non bloquant) ---
+void startBootSplash() {
+  appFlags.splashActive = true;
+  splashStage = 0;
+  splashStartTime = millis();
+  LCD.setCursor(centeredCol(textLen("Super Minuteur")), MESSAGE_ROW); LCD.print(F("Super Minuteur"));
+  LCD.setCursor(centeredCol(textLen("& Metronome")), MESSAGE_ROW + 1); LCD.print(F("& Metronome"));
+}
+
+void drawTimerScreen() {
   updateStaticDisplay();      // Appel à la fonction maintenant dans timer.cpp
   updateCentisecondsDisplay(); // Appel à la fonction maintenant dans timer.cpp
   displayStatusLine3();
 }
 
+void endBootSplash() {
+  appFlags.splashActive = false;
+  LCD.clear();
+  drawTimerScreen();
+}
+
+// Fait avancer l'écran de démarrage. Toute action (bouton ou encodeur) le ferme immédiatement ;
+// l'action est ensuite traitée normalement dans la même passe (ex: un appui démarre la minuterie).
+void serviceBootSplash() {
+  encoder.tick();
+  if (buttonInputPending() || encoder.getPosition() != 0 || journalReplayDue()) {
+    endBootSplash();
+    return;
+  }
+  unsigned long elapsed = millis() - splashStartTime;
+  if (splashStage == 0 && elapsed >= SPLASH_TITLE_DURATION) {
+    splashStage = 1;
+    clearRestOfLine(0, MESSAGE_ROW + 1);
+    LCD.setCursor(centeredCol(textLen("Initialisation...")), MESSAGE_ROW + 1); LCD.print(F("Initialisation..."));
+  } else if (splashStage == 1 && elapsed >= SPLASH_TITLE_DURATION + SPLASH_INIT_DURATION) {
+    splashStage = 2;
+    LCD.clear();
+    LCD.setCursor(0, 0); LCD.print(F("Auteur: ")); LCD.print(AUTHOR_NAME);
+    LCD.setCursor(0, 1); LCD.print(F("Vers: ")); LCD.print(FIRMWARE_VERSION);
+    if (LCD_TALL) {
+      LCD.setCursor(0, 2); LCD.print(F("Date: ")); LCD.print(F(__DATE__)); 
+      LCD.setCursor(0, 3); LCD.print(F("Time: ")); LCD.print(F(__TIME__)); 
+    }
+  } else if (splashStage == 2 && elapsed >= SPLASH_TITLE_DURATION + SPLASH_INIT_DURATION + SPLASH_INFO_DURATION) {
+    endBootSplash();
+  }
+}
+
 // --- Boucle Principale (Gère les modes) ---
 void loop() {
+  serviceLowPowerWake(); // Veille interrompue par une entrée : millis() rattrape la part dormie
+  serviceOutputs(); // Fronts des sorties programmées avant toute autre tâche de la passe
+  if (appFlags.splashActive) { serviceBootSplash(); }
   handleEncoder(); 
   handleButton();  
+  serviceSettingsConsole(); // Export / import des réglages sur le port série
+  serviceJournal(); // Fin d'un rejeu : état comparé à celui du journal
+  serviceMidi(); // Boucle de phase de l'horloge MIDI esclave, avant la logique du métronome
+  modeTick(); // Logique propre au mode courant (MODE_TABLE)
+  serviceBuzzer(); // Son en attente lancé dès que la voie se libère
 
-  if (currentMode == MODE_TIMER) {
-    loopTimer(); // Appel à la logique de boucle du timer (dans timer.cpp)
-
-    // La gestion de la veille pour MODE_TIMER et STATE_IDLE reste ici pour l'instant
-    if (currentTimerState == STATE_IDLE) { 
-        if (configuredSleepDelayMillis > 0 && !isEndSequenceBlinking) {
-             if (millis() - lastActivityTime > configuredSleepDelayMillis) {
-                  goToSleep();
-             }
-        }
-    } 
-  } 
-  else if (currentMode == MODE_METRONOME) {
-    handleMetronomeLogic(); 
-    if (currentMetroState == METRO_STOPPED && configuredSleepDelayMillis > 0) {
-        if (millis() - lastActivityTime > configuredSleepDelayMillis) {
-            goToSleep();
-        }
-    }
-  } 
+  serviceMemoryMonitor();
+  serviceDisplay(); // Rafraîchissements en attente, dans la limite du budget I2C de la passe
 }
 
 
 // --- Fonctions Auxiliaires (qui restent dans le .ino principal) ---
+// Appelée par delay() en boucle : le calendrier des sorties continue pendant les mélodies bloquantes
+void yield() {
+    serviceOutputs();
+}
+
 void resetActivityTimer() {
     lastActivityTime = millis();
-    if (isEndSequenceBlinking) {
-      isEndSequenceBlinking = false;
+    if (currentMode == MODE_TIMER && modeState.timer.isEndSequenceBlinking) { // Le clignotement n'existe qu'en MODE_TIMER
+      modeState.timer.isEndSequenceBlinking = false;
       LCD.backlight(); 
     }
 }
 
 void handleEncoder() {
   encoder.tick(); 
-  int currentEncoderPhysicalPos = encoder.getPosition(); 
-
-  if (currentMode == MODE_TIMER) {
-    handleTimerEncoderInput(currentEncoderPhysicalPos); // <<< APPEL À LA FONCTION DANS timer.cpp
-  } else if (currentMode == MODE_METRONOME) {
-    if (currentMetroState == METRO_STOPPED) {
-        int newBPM = currentEncoderPhysicalPos;
-        if (newBPM < MIN_BPM) { encoder.setPosition(MIN_BPM); newBPM = MIN_BPM; }
-        if (newBPM > MAX_BPM) { encoder.setPosition(MAX_BPM); newBPM = MAX_BPM; }
-        if (currentBPM != newBPM) { 
-            playClickSound();
-            resetActivityTimer();
-            currentBPM = newBPM;
-            displayMetronomeScreen();   
-            saveBPMToEEPROM(currentBPM); 
-        }
-    }
-  } else { 
-       int diff = currentEncoderPhysicalPos - lastEncoderMenuPos;
-       if(diff != 0) { 
-         playClickSound();
-         resetActivityTimer();
-         switch(currentMode) {
-             case MODE_MENU_MAIN:   navigateMainMenu(diff); break;
-             case MODE_MENU_MELODY: navigateMelodyMenu(diff); break;
-             case MODE_MENU_PRESET: navigatePresetMenu(diff); break;
-             case MODE_MENU_VEILLE: navigateVeilleMenu(diff); break;
-             case MODE_MENU_TS_METRO: navigateTSMetroMenu(diff); break; 
-             case MODE_MENU_TEMPO_PRESET: navigateTempoPresetMenu(diff); break;
-             default: break;
-         }
-         lastEncoderMenuPos = currentEncoderPhysicalPos; 
-       }
+  int delta = encoder.getPosition(); // Crans depuis la dernière lecture
+  if (journalReplaying()) {          // Encodeur physique ignoré, crans du journal à leur échéance
+    encoder.setPosition(0);
+    delta = journalReplayEncoder();
   }
+  if (delta == 0) return;
+  encoder.setPosition(0);            // Lecture relative : aucune position absolue à synchroniser
+  journalEncoder(delta);
+  modeEncoder(delta);
 }
 
-void handleButton() {
-  boolean buttonIsUp = digitalRead(BUTTON_PIN);
-
-  if (buttonWasUp && !buttonIsUp) {
-    buttonDownTime = millis();
-    longPressDetected = false; 
-    resetActivityTimer();      
-  }
-
-  if (!buttonWasUp && !longPressDetected && (millis() - buttonDownTime >= longPressDuration)) {
-     longPressDetected = true;
-     playClickSound(); 
-
-     if (currentMode == MODE_TIMER) {
-         if (currentTimerState == STATE_IDLE) { 
-             enterMainMenu();
-         } else { // STATE_PAUSED (RUNNING ne fait rien sur appui long)
-             handleTimerButtonLongPress(); // <<< APPEL À LA FONCTION DANS timer.cpp
-         }
-     }  else if (currentMode == MODE_METRONOME) {
-        // exitMenu(); // <<< ANCIENNE LIGNE : Retournait directement au mode Timer
-        enterMainMenu(); // <<< NOUVELLE LIGNE : Retourne au "Menu Réglages"
-     }
-  }
+// Gestes du bouton, ou ceux du journal pendant un rejeu
+static ButtonEvent nextInputEvent() {
+  if (!journalReplaying()) return nextButtonEvent();
+  while (nextButtonEvent() != BTN_NONE) {}
+  return journalReplayButton();
+}
 
-  if (!buttonWasUp && buttonIsUp) {
-    if (!longPressDetected && (millis() - buttonDownTime >= debounceDelay)) { 
-        playClickSound(); 
-        switch (currentMode) {
-            case MODE_TIMER:
-                handleTimerButtonShortPress(); // <<< APPEL À LA FONCTION DANS timer.cpp
-                break;
-            case MODE_METRONOME: 
-                if (currentMetroState == METRO_STOPPED) {
-                    currentMetroState = METRO_RUNNING;
-                    lastMetroBeatTime = millis(); 
-                    currentBeatInMeasure = 0;     
-                    for (byte b = 0; b < timeSignatureNum; ++b) {
-                         LCD.setCursor(METRO_BEAT_MARKER_START_COL + b, METRO_BEAT_VISUAL_ROW);
-                         LCD.print(" ");
-                    }
-                } else { 
-                    currentMetroState = METRO_STOPPED;
-                    noTone(BUZZER_PIN); 
-                }
-                displayMetronomeScreen(); 
-                break;
-            case MODE_MENU_MAIN:   selectMainMenuItem(); break;
-            case MODE_MENU_MELODY: selectMelodyMenuItem(); break;
-            case MODE_MENU_PRESET: selectPresetMenuItem(); break;
-            case MODE_MENU_VEILLE: selectVeilleMenuItem(); break;
-            case MODE_MENU_TS_METRO: selectTSMetroMenuItem(); break; 
-            case MODE_MENU_TEMPO_PRESET: selectTempoPresetMenuItem(); break;
-        }
-    }
-    longPressDetected = false; 
+void handleButton() {
+  serviceButton(); // Fronts capturés par interruption -> gestes
+  ButtonEvent event;
+  while ((event = nextInputEvent()) != BTN_NONE) {
+    journalButton(event);
+    resetActivityTimer();
+    if (event != BTN_HOLD_REPEAT) { playClickSound(); }
+    modeButton(event);
   }
-  buttonWasUp = buttonIsUp; 
 }
 
 
 // --- Fonctions de Menu (restent dans le .ino principal) ---
 void enterMainMenu() {
     resetActivityTimer();
-    currentMode = MODE_MENU_MAIN;
-    if (currentMetroState == METRO_RUNNING) { 
-        currentMetroState = METRO_STOPPED;    
-        noTone(BUZZER_PIN);                   
-    }
     LCD.createChar(ARROW_UP_CHAR_CODE, arrowUp_Pattern);
     LCD.createChar(ARROW_DOWN_CHAR_CODE, arrowDown_Pattern);
-    byte displayLines = LCD_ROWS - 1; 
+    byte displayLines = MENU_LINES; 
     if (menuMainIndex >= numMainMenuOptions) menuMainIndex = 0; 
     if (menuMainIndex < menuMainScrollOffset) { menuMainScrollOffset = menuMainIndex; }
     else if (menuMainIndex >= menuMainScrollOffset + displayLines) { menuMainScrollOffset = menuMainIndex - displayLines + 1; }
     if (numMainMenuOptions <= displayLines) { menuMainScrollOffset = 0; }
     else { if (menuMainScrollOffset > numMainMenuOptions - displayLines) { menuMainScrollOffset = numMainMenuOptions - displayLines; } }
-    lastEncoderMenuPos = encoder.getPosition(); 
     displayMainMenu();
 }
 
@@ -391,9 +427,9 @@ void enterMainMenu() {
 void displayMainMenu() {
     LCD.clear();
     LCD.setCursor(0, 0); LCD.print(F("Menu Reglages:"));
-    byte displayLines = LCD_ROWS - 1;
+    byte displayLines = MENU_LINES;
     for (byte i = 0; i < displayLines; i++) {
-        byte displayRow = i + 1;
+        byte displayRow = i + MENU_FIRST_ROW;
         byte itemIndexToShow = i + menuMainScrollOffset;
         LCD.setCursor(0, displayRow);
         if (itemIndexToShow < numMainMenuOptions) {
@@ -410,19 +446,18 @@ void displayMainMenu() {
                 else { LCD.print(F("???")); }
             } else if (strcmp(mainMenuItems[itemIndexToShow], " Preset ") == 0) {
                 LCD.print(F(": "));
-                if (currentPresetChoice < NUM_PRESETS) { LCD.print(presetNames[currentPresetChoice]); }
-                else { LCD.print(F("???")); }
+                LCD.print(currentPresetName()); // Cache RAM, pas de lecture EEPROM
             } else if (strcmp(mainMenuItems[itemIndexToShow], " Veille ") == 0) {
                 LCD.print(F(": "));
                 if (currentSleepSetting < NUM_SLEEP_OPTIONS) { LCD.print(SLEEP_DELAY_NAMES[currentSleepSetting]); }
                 else { LCD.print(F("???")); }
             } else if (strcmp(mainMenuItems[itemIndexToShow], " FeedbackSon") == 0) {
                 LCD.print(F(": "));
-                if (buzzerFeedbackEnabled) { LCD.print(F("On ")); }
+                if (appFlags.buzzerFeedbackEnabled) { LCD.print(F("On ")); }
                 else { LCD.print(F("Off")); }
             } else if (strcmp(mainMenuItems[itemIndexToShow], " Melodie O/F") == 0) { 
                 LCD.print(F(": ")); 
-                if (timerMelodyEnabled) { LCD.print(F("On ")); }
+                if (appFlags.timerMelodyEnabled) { LCD.print(F("On ")); }
                 else { LCD.print(F("Off")); }
             } else if (strcmp(mainMenuItems[itemIndexToShow], " Metronome") == 0) { 
                LCD.print(F(": "));
@@ -432,23 +467,30 @@ void displayMainMenu() {
                 LCD.print(timeSignatureNum);
                 LCD.print(F("/")); // <<< MODIFIÉ
                 LCD.print(timeSignatureDen); // <<< MODIFIÉ
+            } else if (strcmp(mainMenuItems[itemIndexToShow], " MIDI") == 0) {
+                LCD.print(F(": "));
+                MidiSync sync = midiSyncMode();
+                if (sync == MIDI_SYNC_MASTER) { LCD.print(F("Maitre")); }
+                else if (sync == MIDI_SYNC_SLAVE) { LCD.print(F("Escl.")); }
+                else { LCD.print(F("Off")); }
             } else if (strcmp(mainMenuItems[itemIndexToShow], " Quitter") == 0) {
             }
-            clearRestOfLine(18, displayRow); 
+            clearRestOfLine(MENU_ARROW_COL - 1, displayRow); 
             } else { 
             clearRestOfLine(0, displayRow);
         }
     }
-    LCD.setCursor(LCD_COLS - 1, 1); LCD.print(" "); 
-    LCD.setCursor(LCD_COLS - 1, displayLines); LCD.print(" "); 
+    LCD.setCursor(MENU_ARROW_COL, MENU_FIRST_ROW); LCD.print(" "); 
+    LCD.setCursor(MENU_ARROW_COL, displayLines); LCD.print(" "); 
     if (numMainMenuOptions > displayLines) { 
-        if (menuMainScrollOffset > 0) { LCD.setCursor(LCD_COLS - 1, 1); LCD.write(byte(ARROW_UP_CHAR_CODE)); }
-        if ((menuMainScrollOffset + displayLines) < numMainMenuOptions) { LCD.setCursor(LCD_COLS - 1, displayLines); LCD.write(byte(ARROW_DOWN_CHAR_CODE)); }
+        if (menuMainScrollOffset > 0) { LCD.setCursor(MENU_ARROW_COL, MENU_FIRST_ROW); LCD.write(byte(ARROW_UP_CHAR_CODE)); }
+        if ((menuMainScrollOffset + displayLines) < numMainMenuOptions) { LCD.setCursor(MENU_ARROW_COL, displayLines); LCD.write(byte(ARROW_DOWN_CHAR_CODE)); }
     }
 }
 
 void navigateMainMenu(int diff) {
-    byte displayLines = LCD_ROWS - 1;
+    playClickSound(); resetActivityTimer();
+    byte displayLines = MENU_LINES;
     int tempMenuIndex = menuMainIndex;
     if (diff > 0) { tempMenuIndex++; if(tempMenuIndex >= numMainMenuOptions) tempMenuIndex = 0; }
     else if (diff < 0) { if(tempMenuIndex == 0) tempMenuIndex = numMainMenuOptions; tempMenuIndex--; }
@@ -465,28 +507,39 @@ void navigateMainMenu(int diff) {
     displayMainMenu(); 
 }
 
-void selectMainMenuItem() {
-    resetActivityTimer();
+void selectMainMenuItem(ButtonEvent event) {
+    if (!isClickEvent(event)) return;
     const char* selectedOption = mainMenuItems[menuMainIndex]; 
-    if (strcmp(selectedOption, " Melodie") == 0) { enterMelodyMenu(); }
-    else if (strcmp(selectedOption, " Preset ") == 0) { enterPresetMenu(); }
-    else if (strcmp(selectedOption, " Veille ") == 0) { enterVeilleMenu(); } 
+    if (strcmp(selectedOption, " Melodie") == 0) { setMode(MODE_MENU_MELODY); }
+    else if (strcmp(selectedOption, " Preset ") == 0) { setMode(MODE_MENU_PRESET); }
+    else if (strcmp(selectedOption, " Veille ") == 0) { setMode(MODE_MENU_VEILLE); } 
     else if (strcmp(selectedOption, " FeedbackSon") == 0) {
-        buzzerFeedbackEnabled = !buzzerFeedbackEnabled;
-        saveChoiceToEEPROM(EEPROM_ADDR_BUZZER_FEEDBACK, buzzerFeedbackEnabled ? 1 : 0);
+        appFlags.buzzerFeedbackEnabled = !appFlags.buzzerFeedbackEnabled;
+        settings.buzzerFeedback = appFlags.buzzerFeedbackEnabled;
+        saveSettings();
         displayMainMenu(); 
     } else if (strcmp(selectedOption, " Melodie O/F") == 0) { 
-        timerMelodyEnabled = !timerMelodyEnabled;
-        saveChoiceToEEPROM(EEPROM_ADDR_TIMER_MELODY_ENABLED, timerMelodyEnabled ? 1 : 0);
+        appFlags.timerMelodyEnabled = !appFlags.timerMelodyEnabled;
+        settings.timerMelody = appFlags.timerMelodyEnabled;
+        saveSettings();
         displayMainMenu(); 
     } else if (strcmp(selectedOption, " Metronome") == 0) {
-        enterMetronomeMode(); 
+        setMode(MODE_METRONOME); 
+    } else if (strcmp(selectedOption, " Pratique") == 0) {
+        setMode(MODE_PRACTICE);
     } else if (strcmp(selectedOption, " Metro.Rythm") == 0) { 
-        enterTSMetroMenu(); 
+        setMode(MODE_MENU_TS_METRO); 
     } else if (strcmp(selectedOption, " Tempo Class.") == 0) { // <<< NOUVEAU CAS (utilisez le nom exact que vous avez mis dans mainMenuItems)
-        enterTempoPresetMenu();    
+        setMode(MODE_MENU_TEMPO_PRESET);
+    } else if (strcmp(selectedOption, " Chrono") == 0) {
+        setMode(MODE_CHRONO);
+    } else if (strcmp(selectedOption, " MIDI") == 0) { // Off -> Maître -> Esclave
+        setMidiSyncMode((MidiSync)((midiSyncMode() + 1) % MIDI_SYNC_COUNT));
+        displayMainMenu();
+    } else if (strcmp(selectedOption, " Diagnostic") == 0) {
+        setMode(MODE_DIAGNOSTIC);
     } else if (strcmp(selectedOption, " Quitter") == 0) {
-        LCD.clear(); exitMenu(); 
+        setMode(MODE_TIMER); 
     }
 }
 
@@ -494,66 +547,50 @@ void selectMainMenuItem() {
 
 void enterTempoPresetMenu() {
     resetActivityTimer();
-    currentMode = MODE_MENU_TEMPO_PRESET;
-    // Initialiser l'index du menu sur le preset actuel si possible, ou 0
-    // Pour la simplicité, on commence à 0 ou au dernier réglé si on sauvegardait l'index.
-    // Ici, on va juste commencer à 0 et ajuster le scroll.
-    menuTempoPresetIndex = 0; // Ou trouver le preset le plus proche du BPM actuel si souhaité.
-
-    byte displayLines = LCD_ROWS - 1; // Ligne 0 pour le titre
-    // Ajuster le scrollOffset pour que l'item sélectionné (menuTempoPresetIndex) soit visible
-    if (menuTempoPresetIndex < tempoPresetMenuScrollOffset) { 
-        tempoPresetMenuScrollOffset = menuTempoPresetIndex;
-    } else if (menuTempoPresetIndex >= tempoPresetMenuScrollOffset + displayLines) { 
-        tempoPresetMenuScrollOffset = menuTempoPresetIndex - displayLines + 1;
+    // Le menu s'ouvre sur l'indication dont la plage contient le BPM actuel
+    modeState.menu.index = currentTempoMarking();
+
+    byte displayLines = MENU_LINES; // Ligne 0 pour le titre
+    // Ajuster le scrollOffset pour que l'item sélectionné soit visible
+    if (modeState.menu.index < modeState.menu.scrollOffset) { 
+        modeState.menu.scrollOffset = modeState.menu.index;
+    } else if (modeState.menu.index >= modeState.menu.scrollOffset + displayLines) { 
+        modeState.menu.scrollOffset = modeState.menu.index - displayLines + 1;
     }
    
     // S'assurer que scrollOffset est valide
-    if (NUM_TEMPO_PRESETS <= displayLines) {
-        tempoPresetMenuScrollOffset = 0;
+    if (NUM_TEMPO_MARKINGS <= displayLines) {
+        modeState.menu.scrollOffset = 0;
     } else {
-        if (tempoPresetMenuScrollOffset > NUM_TEMPO_PRESETS - displayLines) {
-            tempoPresetMenuScrollOffset = NUM_TEMPO_PRESETS - displayLines;
+        if (modeState.menu.scrollOffset > NUM_TEMPO_MARKINGS - displayLines) {
+            modeState.menu.scrollOffset = NUM_TEMPO_MARKINGS - displayLines;
         }
     }
    
-    lastEncoderMenuPos = encoder.getPosition(); 
     displayTempoPresetMenu();
 }
 
 void displayTempoPresetMenu() {
     LCD.clear();
     LCD.setCursor(0, 0); LCD.print(F("Tempo Classique:"));
-    byte displayLines = LCD_ROWS - 1; // 3 lignes pour les items
+    byte displayLines = MENU_LINES; // 3 lignes pour les items
 
     for (byte i = 0; i < displayLines; i++) {
-        byte displayRow = i + 1;
-        byte itemIndexToShow = i + tempoPresetMenuScrollOffset;
+        byte displayRow = i + MENU_FIRST_ROW;
+        byte itemIndexToShow = i + modeState.menu.scrollOffset;
         LCD.setCursor(0, displayRow);
 
-        if (itemIndexToShow < NUM_TEMPO_PRESETS) {
-            if (itemIndexToShow == menuTempoPresetIndex) { LCD.print(">"); }
+        if (itemIndexToShow < NUM_TEMPO_MARKINGS) {
+            if (itemIndexToShow == modeState.menu.index) { LCD.print(">"); }
             else { LCD.print(" "); }
             
-            LCD.print(tempoPresets[itemIndexToShow].name);
-            LCD.print(F(" ("));
-            LCD.print(tempoPresets[itemIndexToShow].bpm);
-            // LCD.print(F(" BPM)")); // "BPM" pourrait rendre la ligne trop longue
-            LCD.print(F(")"));
+            // Nom tronqué pour laisser " (bpm)" avant la colonne des flèches
+            byte currentLength = 1 + printTempoMarkingName(itemIndexToShow, MENU_ARROW_COL - 1 - textLen(" (000)"));
+            currentLength += LCD.print(F(" ("));
+            currentLength += LCD.print(pgm_read_byte(&tempoMarkings[itemIndexToShow].bpm));
+            currentLength += LCD.print(F(")"));
 
             // La description française n'est pas affichée ici pour garder la liste concise
-            // On pourrait l'afficher sur une 2ème ligne pour l'item sélectionné,
-            // mais cela réduirait le nombre d'items visibles.
-            
-            // Calcul approximatif de la longueur pour clearRestOfLine
-            byte currentLength = 1; // Pour ">" ou " "
-            currentLength += strlen(tempoPresets[itemIndexToShow].name);
-            currentLength += 3; // Pour " (" et ")"
-            if (tempoPresets[itemIndexToShow].bpm >= 100) currentLength += 3;
-            else if (tempoPresets[itemIndexToShow].bpm >= 10) currentLength += 2;
-            else currentLength += 1;
-            // if (strlen(" BPM)") > 0) currentLength += strlen(" BPM)");
-
             clearRestOfLine(currentLength, displayRow);
         } else {
             clearRestOfLine(0, displayRow); // Ligne vide
@@ -561,94 +598,91 @@ void displayTempoPresetMenu() {
     }
   
     // Afficher les flèches de défilement
-    LCD.setCursor(LCD_COLS - 1, 1); LCD.print(" "); 
-    LCD.setCursor(LCD_COLS - 1, displayLines); LCD.print(" "); 
-    if (NUM_TEMPO_PRESETS > displayLines) { 
-        if (tempoPresetMenuScrollOffset > 0) { 
-            LCD.setCursor(LCD_COLS - 1, 1); 
+    LCD.setCursor(MENU_ARROW_COL, MENU_FIRST_ROW); LCD.print(" "); 
+    LCD.setCursor(MENU_ARROW_COL, displayLines); LCD.print(" "); 
+    if (NUM_TEMPO_MARKINGS > displayLines) { 
+        if (modeState.menu.scrollOffset > 0) { 
+            LCD.setCursor(MENU_ARROW_COL, MENU_FIRST_ROW); 
             LCD.write(byte(ARROW_UP_CHAR_CODE)); 
         }
-        if ((tempoPresetMenuScrollOffset + displayLines) < NUM_TEMPO_PRESETS) { 
-            LCD.setCursor(LCD_COLS - 1, displayLines); 
+        if ((modeState.menu.scrollOffset + displayLines) < NUM_TEMPO_MARKINGS) { 
+            LCD.setCursor(MENU_ARROW_COL, displayLines); 
             LCD.write(byte(ARROW_DOWN_CHAR_CODE)); 
         }
     }
 }
 
 void navigateTempoPresetMenu(int diff) {
-    byte displayLines = LCD_ROWS - 1;
-    int tempMenuIndex = menuTempoPresetIndex;
+    playClickSound(); resetActivityTimer();
+    byte displayLines = MENU_LINES;
+    int tempMenuIndex = modeState.menu.index;
 
     if (diff > 0) { 
         tempMenuIndex++;
-        if(tempMenuIndex >= NUM_TEMPO_PRESETS) tempMenuIndex = 0; 
+        if(tempMenuIndex >= NUM_TEMPO_MARKINGS) tempMenuIndex = 0; 
     } else if (diff < 0) { 
-        if(tempMenuIndex == 0) tempMenuIndex = NUM_TEMPO_PRESETS; 
+        if(tempMenuIndex == 0) tempMenuIndex = NUM_TEMPO_MARKINGS; 
         tempMenuIndex--;
     }
-    menuTempoPresetIndex = tempMenuIndex;
+    modeState.menu.index = tempMenuIndex;
 
-    if (NUM_TEMPO_PRESETS > displayLines) { 
-        if (menuTempoPresetIndex < tempoPresetMenuScrollOffset) { 
-            tempoPresetMenuScrollOffset = menuTempoPresetIndex;
-        } else if (menuTempoPresetIndex >= tempoPresetMenuScrollOffset + displayLines) { 
-            tempoPresetMenuScrollOffset = menuTempoPresetIndex - displayLines + 1;
+    if (NUM_TEMPO_MARKINGS > displayLines) { 
+        if (modeState.menu.index < modeState.menu.scrollOffset) { 
+            modeState.menu.scrollOffset = modeState.menu.index;
+        } else if (modeState.menu.index >= modeState.menu.scrollOffset + displayLines) { 
+            modeState.menu.scrollOffset = modeState.menu.index - displayLines + 1;
         }
-        if (diff > 0 && menuTempoPresetIndex == 0) { 
-             tempoPresetMenuScrollOffset = 0;
-        } else if (diff < 0 && menuTempoPresetIndex == (NUM_TEMPO_PRESETS - 1) ) { 
-             if (NUM_TEMPO_PRESETS > displayLines) { 
-                tempoPresetMenuScrollOffset = NUM_TEMPO_PRESETS - displayLines;
+        if (diff > 0 && modeState.menu.index == 0) { 
+             modeState.menu.scrollOffset = 0;
+        } else if (diff < 0 && modeState.menu.index == (NUM_TEMPO_MARKINGS - 1) ) { 
+             if (NUM_TEMPO_MARKINGS > displayLines) { 
+                modeState.menu.scrollOffset = NUM_TEMPO_MARKINGS - displayLines;
              } else {
-                tempoPresetMenuScrollOffset = 0;
+                modeState.menu.scrollOffset = 0;
              }
         }
     } else { 
-        tempoPresetMenuScrollOffset = 0;
+        modeState.menu.scrollOffset = 0;
     }
     displayTempoPresetMenu(); 
 }
 
-void selectTempoPresetMenuItem() {
-    resetActivityTimer();
+void selectTempoPresetMenuItem(ButtonEvent event) {
+    if (!isClickEvent(event)) return;
     
-    currentBPM = tempoPresets[menuTempoPresetIndex].bpm;
+    currentBPM = pgm_read_byte(&tempoMarkings[modeState.menu.index].bpm);
     saveBPMToEEPROM(currentBPM);       // Sauvegarder le nouveau BPM
-    encoder.setPosition(currentBPM);   // Synchroniser l'encodeur avec le nouveau BPM
-    metroEncoderLastPos = currentBPM;  // Pour la gestion de l'encodeur en mode métronome
     
-    playClickSound(); 
     // Optionnel: afficher brièvement le tempo sélectionné avant de changer de mode
     // LCD.clear();
     // LCD.setCursor(0,1); LCD.print(F("Tempo selectionne:"));
-    // LCD.setCursor(0,2); LCD.print(tempoPresets[menuTempoPresetIndex].name);
+    // LCD.setCursor(0,2); LCD.print(tempoMarkings[menuTempoPresetIndex].name);
     // LCD.print(F(" (")); LCD.print(currentBPM); LCD.print(F(" BPM)"));
     // delay(1500);
 
-    enterMetronomeMode(); // Aller directement au mode métronome avec le BPM réglé
+    setMode(MODE_METRONOME); // Aller directement au mode métronome avec le BPM réglé
 }
 
 void enterMelodyMenu() {
-    resetActivityTimer(); currentMode = MODE_MENU_MELODY;
-    menuMelodyIndex = currentMelodyChoice; 
-    byte displayLines = LCD_ROWS - 1;
-    if (menuMelodyIndex < melodyMenuScrollOffset) { melodyMenuScrollOffset = menuMelodyIndex; }
-    else if (menuMelodyIndex >= melodyMenuScrollOffset + displayLines) { melodyMenuScrollOffset = menuMelodyIndex - displayLines + 1; }
-    if (NUM_MELODIES <= displayLines) { melodyMenuScrollOffset = 0; } 
-    else if (melodyMenuScrollOffset > NUM_MELODIES - displayLines) { melodyMenuScrollOffset = NUM_MELODIES - displayLines; } 
-    lastEncoderMenuPos = encoder.getPosition();
+    resetActivityTimer();
+    modeState.menu.index = currentMelodyChoice; 
+    byte displayLines = MENU_LINES;
+    if (modeState.menu.index < modeState.menu.scrollOffset) { modeState.menu.scrollOffset = modeState.menu.index; }
+    else if (modeState.menu.index >= modeState.menu.scrollOffset + displayLines) { modeState.menu.scrollOffset = modeState.menu.index - displayLines + 1; }
+    if (NUM_MELODIES <= displayLines) { modeState.menu.scrollOffset = 0; } 
+    else if (modeState.menu.scrollOffset > NUM_MELODIES - displayLines) { modeState.menu.scrollOffset = NUM_MELODIES - displayLines; } 
     displayMelodyMenu();
 }
 
 void displayMelodyMenu() {
     LCD.clear(); LCD.setCursor(0, 0); LCD.print(F(" Choix Melodie:"));
-    byte displayLines = LCD_ROWS - 1;
+    byte displayLines = MENU_LINES;
     for (byte i = 0; i < displayLines; i++) {
-        byte displayRow = i + 1;
-        byte itemIndexToShow = i + melodyMenuScrollOffset;
+        byte displayRow = i + MENU_FIRST_ROW;
+        byte itemIndexToShow = i + modeState.menu.scrollOffset;
         LCD.setCursor(0, displayRow);
         if (itemIndexToShow < NUM_MELODIES) {
-            if (itemIndexToShow == menuMelodyIndex) { LCD.print(">"); }
+            if (itemIndexToShow == modeState.menu.index) { LCD.print(">"); }
             else { LCD.print(" "); }
             LCD.print(melodyNames[itemIndexToShow]);
             clearRestOfLine(1 + strlen(melodyNames[itemIndexToShow]) +1, displayRow);
@@ -656,132 +690,147 @@ void displayMelodyMenu() {
             clearRestOfLine(0, displayRow); 
         }
     }
-    LCD.setCursor(LCD_COLS - 1, 1); LCD.print(" ");
-    LCD.setCursor(LCD_COLS - 1, displayLines); LCD.print(" ");
+    LCD.setCursor(MENU_ARROW_COL, MENU_FIRST_ROW); LCD.print(" ");
+    LCD.setCursor(MENU_ARROW_COL, displayLines); LCD.print(" ");
     if (NUM_MELODIES > displayLines) {
-        if (melodyMenuScrollOffset > 0) { LCD.setCursor(LCD_COLS - 1, 1); LCD.write(byte(ARROW_UP_CHAR_CODE)); }
-        if ((melodyMenuScrollOffset + displayLines) < NUM_MELODIES) { LCD.setCursor(LCD_COLS - 1, displayLines); LCD.write(byte(ARROW_DOWN_CHAR_CODE)); }
+        if (modeState.menu.scrollOffset > 0) { LCD.setCursor(MENU_ARROW_COL, MENU_FIRST_ROW); LCD.write(byte(ARROW_UP_CHAR_CODE)); }
+        if ((modeState.menu.scrollOffset + displayLines) < NUM_MELODIES) { LCD.setCursor(MENU_ARROW_COL, displayLines); LCD.write(byte(ARROW_DOWN_CHAR_CODE)); }
     }
 }
 
 void navigateMelodyMenu(int diff) {
-    byte displayLines = LCD_ROWS - 1;
-    int tempMenuIndex = menuMelodyIndex;
+    playClickSound(); resetActivityTimer();
+    byte displayLines = MENU_LINES;
+    int tempMenuIndex = modeState.menu.index;
     if (diff > 0) { tempMenuIndex++; if(tempMenuIndex >= NUM_MELODIES) tempMenuIndex = 0; }
     else if (diff < 0) { if(tempMenuIndex == 0) tempMenuIndex = NUM_MELODIES; tempMenuIndex--; }
-    menuMelodyIndex = tempMenuIndex;
+    modeState.menu.index = tempMenuIndex;
     if (NUM_MELODIES > displayLines) {
-        if (menuMelodyIndex < melodyMenuScrollOffset) { melodyMenuScrollOffset = menuMelodyIndex; }
-        else if (menuMelodyIndex >= (melodyMenuScrollOffset + displayLines)) { melodyMenuScrollOffset = menuMelodyIndex - displayLines + 1; }
-        if (diff > 0 && menuMelodyIndex == 0) melodyMenuScrollOffset = 0;
-        else if (diff < 0 && menuMelodyIndex == (NUM_MELODIES - 1)) {
-            if (NUM_MELODIES > displayLines) melodyMenuScrollOffset = NUM_MELODIES - displayLines;
-            else melodyMenuScrollOffset = 0;
+        if (modeState.menu.index < modeState.menu.scrollOffset) { modeState.menu.scrollOffset = modeState.menu.index; }
+        else if (modeState.menu.index >= (modeState.menu.scrollOffset + displayLines)) { modeState.menu.scrollOffset = modeState.menu.index - displayLines + 1; }
+        if (diff > 0 && modeState.menu.index == 0) modeState.menu.scrollOffset = 0;
+        else if (diff < 0 && modeState.menu.index == (NUM_MELODIES - 1)) {
+            if (NUM_MELODIES > displayLines) modeState.menu.scrollOffset = NUM_MELODIES - displayLines;
+            else modeState.menu.scrollOffset = 0;
         }
-    } else { melodyMenuScrollOffset = 0; }
+    } else { modeState.menu.scrollOffset = 0; }
     displayMelodyMenu();
 }
 
-void selectMelodyMenuItem() {
-    resetActivityTimer();
-    currentMelodyChoice = menuMelodyIndex;
-    saveChoiceToEEPROM(EEPROM_ADDR_MELODY, currentMelodyChoice);
-    playClickSound(); 
-    enterMainMenu(); 
+void selectMelodyMenuItem(ButtonEvent event) {
+    if (!isClickEvent(event)) return;
+    currentMelodyChoice = modeState.menu.index;
+    settings.melody = currentMelodyChoice;
+    saveSettings();
+    setMode(MODE_MENU_MAIN); 
+}
+
+// Menu Preset : "Manuel", les presets du plus au moins récemment utilisé, puis "+ Nouveau"
+static byte presetMenuItemCount() {
+    return 1 + presetCount() + (presetCount() < PRESET_SLOTS ? 1 : 0);
 }
 
 void enterPresetMenu() {
-    resetActivityTimer(); currentMode = MODE_MENU_PRESET;
-    menuPresetIndex = currentPresetChoice;
-    byte displayLines = LCD_ROWS - 1;
-    if (menuPresetIndex < presetMenuScrollOffset) { presetMenuScrollOffset = menuPresetIndex; }
-    else if (menuPresetIndex >= presetMenuScrollOffset + displayLines) { presetMenuScrollOffset = menuPresetIndex - displayLines + 1; }
-    if (NUM_PRESETS <= displayLines) { presetMenuScrollOffset = 0; }
-    else if (presetMenuScrollOffset > NUM_PRESETS - displayLines) { presetMenuScrollOffset = NUM_PRESETS - displayLines; }
-    lastEncoderMenuPos = encoder.getPosition();
+    resetActivityTimer();
+    // Curseur sur le choix courant (en tête de liste s'il vient d'être utilisé)
+    byte rank = currentPresetChoice == 0 ? PRESET_NONE : presetRankOf(currentPresetChoice - 1);
+    modeState.menu.index = rank == PRESET_NONE ? 0 : rank + 1;
+    byte numItems = presetMenuItemCount();
+    byte displayLines = MENU_LINES;
+    if (modeState.menu.index < modeState.menu.scrollOffset) { modeState.menu.scrollOffset = modeState.menu.index; }
+    else if (modeState.menu.index >= modeState.menu.scrollOffset + displayLines) { modeState.menu.scrollOffset = modeState.menu.index - displayLines + 1; }
+    if (numItems <= displayLines) { modeState.menu.scrollOffset = 0; }
+    else if (modeState.menu.scrollOffset > numItems - displayLines) { modeState.menu.scrollOffset = numItems - displayLines; }
     displayPresetMenu();
 }
 
 void displayPresetMenu() {
     LCD.clear(); LCD.setCursor(0, 0); LCD.print(F(" Choix Preset:"));
-    byte displayLines = LCD_ROWS - 1;
+    byte displayLines = MENU_LINES;
+    byte numItems = presetMenuItemCount();
+    char name[PRESET_NAME_LEN + 1];
     for (byte i = 0; i < displayLines; i++) {
-        byte displayRow = i + 1;
-        byte itemIndexToShow = i + presetMenuScrollOffset;
+        byte displayRow = i + MENU_FIRST_ROW;
+        byte itemIndexToShow = i + modeState.menu.scrollOffset;
         LCD.setCursor(0, displayRow);
-        if (itemIndexToShow < NUM_PRESETS) {
-            if (itemIndexToShow == menuPresetIndex) { LCD.print(">"); }
+        if (itemIndexToShow < numItems) {
+            if (itemIndexToShow == modeState.menu.index) { LCD.print(">"); }
             else { LCD.print(" "); }
-            LCD.print(presetNames[itemIndexToShow]);
-            clearRestOfLine(1 + strlen(presetNames[itemIndexToShow]) + 1, displayRow);
+            if (itemIndexToShow == 0) {
+                LCD.print(F("Manuel"));
+                clearRestOfLine(1 + textLen("Manuel"), displayRow);
+            } else if (itemIndexToShow <= presetCount()) {
+                byte slot = presetSlotAt(itemIndexToShow - 1); // Seuls les enregistrements visibles sont lus
+                readPresetName(slot, name);
+                LCD.print(name);
+                LCD.setCursor(PRESET_MENU_TIME_COL, displayRow);
+                printPresetDuration(readPresetSeconds(slot));
+                clearRestOfLine(PRESET_MENU_TIME_COL + 5, displayRow);
+            } else {
+                LCD.print(F("+ Nouveau"));
+                clearRestOfLine(1 + textLen("+ Nouveau"), displayRow);
+            }
         } else {
             clearRestOfLine(0, displayRow);
         }
     }
-    LCD.setCursor(LCD_COLS - 1, 1); LCD.print(" ");
-    LCD.setCursor(LCD_COLS - 1, displayLines); LCD.print(" ");
-    if (NUM_PRESETS > displayLines) {
-        if (presetMenuScrollOffset > 0) { LCD.setCursor(LCD_COLS - 1, 1); LCD.write(byte(ARROW_UP_CHAR_CODE)); }
-        if ((presetMenuScrollOffset + displayLines) < NUM_PRESETS) { LCD.setCursor(LCD_COLS - 1, displayLines); LCD.write(byte(ARROW_DOWN_CHAR_CODE)); }
+    LCD.setCursor(MENU_ARROW_COL, MENU_FIRST_ROW); LCD.print(" ");
+    LCD.setCursor(MENU_ARROW_COL, displayLines); LCD.print(" ");
+    if (numItems > displayLines) {
+        if (modeState.menu.scrollOffset > 0) { LCD.setCursor(MENU_ARROW_COL, MENU_FIRST_ROW); LCD.write(byte(ARROW_UP_CHAR_CODE)); }
+        if ((modeState.menu.scrollOffset + displayLines) < numItems) { LCD.setCursor(MENU_ARROW_COL, displayLines); LCD.write(byte(ARROW_DOWN_CHAR_CODE)); }
     }
 }
 
 void navigatePresetMenu(int diff) {
-    byte displayLines = LCD_ROWS - 1;
-    int tempMenuIndex = menuPresetIndex;
-    if (diff > 0) { tempMenuIndex++; if(tempMenuIndex >= NUM_PRESETS) tempMenuIndex = 0; }
-    else if (diff < 0) { if(tempMenuIndex == 0) tempMenuIndex = NUM_PRESETS; tempMenuIndex--; }
-    menuPresetIndex = tempMenuIndex;
-    if (NUM_PRESETS > displayLines) {
-        if (menuPresetIndex < presetMenuScrollOffset) { presetMenuScrollOffset = menuPresetIndex; }
-        else if (menuPresetIndex >= (presetMenuScrollOffset + displayLines)) { presetMenuScrollOffset = menuPresetIndex - displayLines + 1; }
-        if (diff > 0 && menuPresetIndex == 0) presetMenuScrollOffset = 0;
-        else if (diff < 0 && menuPresetIndex == (NUM_PRESETS - 1)) {
-             if (NUM_PRESETS > displayLines) presetMenuScrollOffset = NUM_PRESETS - displayLines;
-             else presetMenuScrollOffset = 0;
-        }
-    } else { presetMenuScrollOffset = 0; }
+    playClickSound(); resetActivityTimer();
+    byte displayLines = MENU_LINES;
+    byte numItems = presetMenuItemCount();
+    // Tous les crans lus depuis la dernière passe sont appliqués : rotation rapide = saut de plusieurs presets
+    int tempMenuIndex = ((int)modeState.menu.index + diff) % numItems;
+    if (tempMenuIndex < 0) tempMenuIndex += numItems;
+    modeState.menu.index = tempMenuIndex;
+    if (numItems > displayLines) {
+        if (modeState.menu.index < modeState.menu.scrollOffset) { modeState.menu.scrollOffset = modeState.menu.index; }
+        else if (modeState.menu.index >= (modeState.menu.scrollOffset + displayLines)) { modeState.menu.scrollOffset = modeState.menu.index - displayLines + 1; }
+    } else { modeState.menu.scrollOffset = 0; }
     displayPresetMenu();
 }
 
-void selectPresetMenuItem() {
-    resetActivityTimer();
-    currentPresetChoice = menuPresetIndex;
-    saveChoiceToEEPROM(EEPROM_ADDR_PRESET, currentPresetChoice); 
-    if (currentPresetChoice == 0) { 
-        EEPROM.get(EEPROM_ADDR_MANUAL_TIME, targetTotalSeconds);
-        if (targetTotalSeconds > MAX_TOTAL_SECONDS) targetTotalSeconds = 0;
-    } else if (currentPresetChoice < NUM_PRESETS) { 
-        targetTotalSeconds = PRESET_VALUES[currentPresetChoice];
-    } else { 
-        targetTotalSeconds = 0; currentPresetChoice = 0;
-        saveChoiceToEEPROM(EEPROM_ADDR_PRESET, currentPresetChoice); 
+void selectPresetMenuItem(ButtonEvent event) {
+    bool isEntry = modeState.menu.index > 0 && modeState.menu.index <= presetCount();
+    if (event == BTN_LONG_PRESS) { // Appui long sur un preset : édition / suppression
+        if (isEntry) openPresetEditor(presetSlotAt(modeState.menu.index - 1));
+        return;
+    }
+    if (!isClickEvent(event)) return;
+    if (modeState.menu.index > presetCount()) { // "+ Nouveau"
+        openPresetEditor(PRESET_NONE);
+        return;
     }
-    lastPos = targetTotalSeconds / SECOND_INCREMENT;
-    encoder.setPosition(lastPos * STEPS);
-    playClickSound();
-    enterMainMenu(); 
+    selectPreset(isEntry ? presetSlotAt(modeState.menu.index - 1) + 1 : 0); // Remonte le preset en tête de liste
+    targetTotalSeconds = presetTargetSeconds();
+    setMode(MODE_MENU_MAIN); // Le retour au minuteur recalcule la position de l'encodeur
 }
 
 void enterVeilleMenu() {
-    resetActivityTimer(); currentMode = MODE_MENU_VEILLE;
-    byte displayLines = LCD_ROWS - 1;
+    resetActivityTimer();
+    byte displayLines = MENU_LINES;
     if (currentSleepSetting >= NUM_SLEEP_OPTIONS) currentSleepSetting = 0;
-    if (currentSleepSetting < veilleMenuScrollOffset) { veilleMenuScrollOffset = currentSleepSetting; }
-    else if (currentSleepSetting >= veilleMenuScrollOffset + displayLines) { veilleMenuScrollOffset = currentSleepSetting - displayLines + 1; }
-    if (NUM_SLEEP_OPTIONS <= displayLines) { veilleMenuScrollOffset = 0; }
-    else { if (veilleMenuScrollOffset > NUM_SLEEP_OPTIONS - displayLines) { veilleMenuScrollOffset = NUM_SLEEP_OPTIONS - displayLines; } }
-    // if (veilleMenuScrollOffset < 0) veilleMenuScrollOffset = 0; // Redondant pour byte
-    lastEncoderMenuPos = encoder.getPosition();
+    if (currentSleepSetting < modeState.menu.scrollOffset) { modeState.menu.scrollOffset = currentSleepSetting; }
+    else if (currentSleepSetting >= modeState.menu.scrollOffset + displayLines) { modeState.menu.scrollOffset = currentSleepSetting - displayLines + 1; }
+    if (NUM_SLEEP_OPTIONS <= displayLines) { modeState.menu.scrollOffset = 0; }
+    else { if (modeState.menu.scrollOffset > NUM_SLEEP_OPTIONS - displayLines) { modeState.menu.scrollOffset = NUM_SLEEP_OPTIONS - displayLines; } }
+    // if (modeState.menu.scrollOffset < 0) modeState.menu.scrollOffset = 0; // Redondant pour byte
     displayVeilleMenu();
 }
 
 void displayVeilleMenu() {
     LCD.clear(); LCD.setCursor(0, 0); LCD.print(F(" Reglage Veille:"));
-    byte displayLines = LCD_ROWS - 1;
+    byte displayLines = MENU_LINES;
     for (byte i = 0; i < displayLines; i++) { 
-        byte displayRow = i + 1; 
-        byte itemIndexToShow = i + veilleMenuScrollOffset; 
+        byte displayRow = i + MENU_FIRST_ROW; 
+        byte itemIndexToShow = i + modeState.menu.scrollOffset; 
         LCD.setCursor(0, displayRow);
         if (itemIndexToShow < NUM_SLEEP_OPTIONS) { 
             if (itemIndexToShow == currentSleepSetting) { LCD.print(">"); }
@@ -792,78 +841,54 @@ void displayVeilleMenu() {
             clearRestOfLine(0, displayRow);
         }
     }
-    LCD.setCursor(LCD_COLS - 1, 1); LCD.print(" ");
-    LCD.setCursor(LCD_COLS - 1, displayLines); LCD.print(" ");
+    LCD.setCursor(MENU_ARROW_COL, MENU_FIRST_ROW); LCD.print(" ");
+    LCD.setCursor(MENU_ARROW_COL, displayLines); LCD.print(" ");
     if (NUM_SLEEP_OPTIONS > displayLines) { 
-        if (veilleMenuScrollOffset > 0) { LCD.setCursor(LCD_COLS - 1, 1); LCD.write(byte(ARROW_UP_CHAR_CODE)); }
-        if ((veilleMenuScrollOffset + displayLines) < NUM_SLEEP_OPTIONS) { LCD.setCursor(LCD_COLS - 1, displayLines); LCD.write(byte(ARROW_DOWN_CHAR_CODE)); }
+        if (modeState.menu.scrollOffset > 0) { LCD.setCursor(MENU_ARROW_COL, MENU_FIRST_ROW); LCD.write(byte(ARROW_UP_CHAR_CODE)); }
+        if ((modeState.menu.scrollOffset + displayLines) < NUM_SLEEP_OPTIONS) { LCD.setCursor(MENU_ARROW_COL, displayLines); LCD.write(byte(ARROW_DOWN_CHAR_CODE)); }
     }
 }
 
 void navigateVeilleMenu(int diff) {
-    byte displayLines = LCD_ROWS - 1; 
+    playClickSound(); resetActivityTimer();
+    byte displayLines = MENU_LINES; 
     int tempSetting = currentSleepSetting;
     if (diff > 0) { tempSetting++; if (tempSetting >= NUM_SLEEP_OPTIONS) tempSetting = 0; }
     else if (diff < 0) { if (tempSetting == 0) tempSetting = NUM_SLEEP_OPTIONS; tempSetting--; }
     currentSleepSetting = tempSetting; 
     if (NUM_SLEEP_OPTIONS > displayLines) { 
-        if (currentSleepSetting < veilleMenuScrollOffset) { veilleMenuScrollOffset = currentSleepSetting; }
-        else if (currentSleepSetting >= veilleMenuScrollOffset + displayLines) { veilleMenuScrollOffset = currentSleepSetting - displayLines + 1; }
-        if (diff > 0 && currentSleepSetting == 0) veilleMenuScrollOffset = 0;
+        if (currentSleepSetting < modeState.menu.scrollOffset) { modeState.menu.scrollOffset = currentSleepSetting; }
+        else if (currentSleepSetting >= modeState.menu.scrollOffset + displayLines) { modeState.menu.scrollOffset = currentSleepSetting - displayLines + 1; }
+        if (diff > 0 && currentSleepSetting == 0) modeState.menu.scrollOffset = 0;
         else if (diff < 0 && currentSleepSetting == (NUM_SLEEP_OPTIONS - 1) ) { 
-             if (NUM_SLEEP_OPTIONS > displayLines) veilleMenuScrollOffset = NUM_SLEEP_OPTIONS - displayLines;
-             else veilleMenuScrollOffset = 0;
+             if (NUM_SLEEP_OPTIONS > displayLines) modeState.menu.scrollOffset = NUM_SLEEP_OPTIONS - displayLines;
+             else modeState.menu.scrollOffset = 0;
         }
-    } else { veilleMenuScrollOffset = 0; }
+    } else { modeState.menu.scrollOffset = 0; }
     if (NUM_SLEEP_OPTIONS > displayLines) { 
-        if (veilleMenuScrollOffset > NUM_SLEEP_OPTIONS - displayLines) veilleMenuScrollOffset = NUM_SLEEP_OPTIONS - displayLines;
-        // if (veilleMenuScrollOffset < 0) veilleMenuScrollOffset = 0; // Redondant pour byte
-    } else { veilleMenuScrollOffset = 0; }
+        if (modeState.menu.scrollOffset > NUM_SLEEP_OPTIONS - displayLines) modeState.menu.scrollOffset = NUM_SLEEP_OPTIONS - displayLines;
+        // if (modeState.menu.scrollOffset < 0) modeState.menu.scrollOffset = 0; // Redondant pour byte
+    } else { modeState.menu.scrollOffset = 0; }
     displayVeilleMenu(); 
 }
 
-void selectVeilleMenuItem() {
-    resetActivityTimer();
-    saveChoiceToEEPROM(EEPROM_ADDR_SLEEP_DELAY, currentSleepSetting);
+void selectVeilleMenuItem(ButtonEvent event) {
+    if (!isClickEvent(event)) return;
+    settings.sleepDelay = currentSleepSetting;
+    saveSettings();
     configuredSleepDelayMillis = (unsigned long)SLEEP_DELAY_VALUES[currentSleepSetting] * 1000UL;
-    playClickSound();
-    enterMainMenu();
-}
-
-void exitMenu() {
-    resetActivityTimer();
-    bigNum.begin(); 
-    currentMode = MODE_TIMER; 
-    if (currentPresetChoice == 0) { 
-        EEPROM.get(EEPROM_ADDR_MANUAL_TIME, targetTotalSeconds);
-        if (targetTotalSeconds > MAX_TOTAL_SECONDS) targetTotalSeconds = 0;
-    } else { 
-        if (currentPresetChoice < NUM_PRESETS) { targetTotalSeconds = PRESET_VALUES[currentPresetChoice]; }
-        else { targetTotalSeconds = 0; currentPresetChoice = 0; EEPROM.update(EEPROM_ADDR_PRESET, currentPresetChoice); }
-    }
-    displayMIN = targetTotalSeconds / 60;
-    displaySEC = targetTotalSeconds % 60;
-    displayCS = 0; 
-    lastPos = targetTotalSeconds / SECOND_INCREMENT;
-    encoder.setPosition(lastPos * STEPS); 
-    lastDisplayedMIN = -1; 
-    lastDisplayedSEC = -1;
-    updateStaticDisplay();      // Appel à la fonction maintenant dans timer.cpp
-    updateCentisecondsDisplay(); // Appel à la fonction maintenant dans timer.cpp
-    displayStatusLine3();
-}
-
-void saveChoiceToEEPROM(int address, byte value) {
-    EEPROM.update(address, value); 
+    setMode(MODE_MENU_MAIN);
 }
 
 void displayStatusLine3() {
+    if (!LCD_TALL) return; // 16x2 : pas de ligne d'infos sous les grands chiffres
+    if (currentTimerState != STATE_IDLE) { drawProgressBar(); return; } // Décompte en cours ou en pause : barre de progression
     byte displayRow = MELODY_NAME_ROW;
     byte startCol = MELODY_NAME_COL;
     clearRestOfLine(0, displayRow);
     LCD.setCursor(startCol - 1, displayRow); 
     LCD.print(F("*"));
-    if (!timerMelodyEnabled) {
+    if (!appFlags.timerMelodyEnabled) {
         LCD.print(F("Mel. Off")); 
     } else {
         if (currentMelodyChoice < NUM_MELODIES) {
@@ -872,16 +897,10 @@ void displayStatusLine3() {
             LCD.print(F("???"));
         }
     }
-    LCD.print(F(" | ")); // Séparateur
+    LCD.print(F("|")); // Séparateur (nom de mélodie déjà complété par des espaces)
 
-    // Afficher le statut du preset (Manuel, 1.Min, 2.Min, etc.)
-    if (currentPresetChoice == 0) {
-        LCD.print(presetNames[0]); // Affiche "Manuel"
-    } else if (currentPresetChoice < NUM_PRESETS) {
-        LCD.print(currentPresetChoice); LCD.print(F(".Min"));  // Affiche "1.Min", "2.Min", etc.
-    } else {
-        LCD.print(F("???")); //
-    }
+    // Nom du preset courant (ou "Manuel"), gardé en RAM par presets.cpp
+    LCD.print(currentPresetName());
 }
 
 void clearRestOfLine(byte startCol, byte row) {
@@ -892,68 +911,46 @@ void clearRestOfLine(byte startCol, byte row) {
     }
 }
 
+// Mise en veille après configuredSleepDelayMillis sans action (modes qui l'autorisent)
+void checkIdleSleep() {
+    if (configuredSleepDelayMillis > 0 && millis() - lastActivityTime > configuredSleepDelayMillis) {
+        goToSleep();
+    }
+}
+
 void goToSleep() {
     LCD.clear(); 
-    LCD.setCursor(0, 1); LCD.print(F("    Mode Veille     "));
-    LCD.setCursor(0, 2); LCD.print(F("   Appuyez Btn...   "));
+    LCD.setCursor(centeredCol(textLen("Mode Veille")), MESSAGE_ROW); LCD.print(F("Mode Veille"));
+    LCD.setCursor(centeredCol(textLen("Appuyez Btn...")), MESSAGE_ROW + 1); LCD.print(F("Appuyez Btn..."));
+    LCD.endFrame(); // Message envoyé avant la veille (OLED : rien ne part avant la fin de trame)
     LCD.noBacklight();
-    digitalWrite(RELAY_PIN, HIGH); 
-    noTone(BUZZER_PIN);            
+    outputsStop();
+    buzzerSilence(SOUND_ALARM);
     delay(100); 
+    displayBusFlush(); // Un octet en cours d'envoi resterait bloqué pendant le power-down
     cli(); 
-    PCICR |= (1 << PCIE2);    
-    PCMSK2 |= (1 << PCINT22); 
+    // PCINT22 (bouton) est armé en permanence par setupButton() : il sert aussi au réveil
     set_sleep_mode(SLEEP_MODE_PWR_DOWN); 
     sleep_enable();                      
     sei();                               
     sleep_cpu();                         
     sleep_disable();                     
-    PCMSK2 &= ~(1 << PCINT22);           
     LCD.backlight(); 
     awokeByInterrupt = true; 
-    if (currentMode == MODE_TIMER) {
-        if (currentPresetChoice == 0) {
-            EEPROM.get(EEPROM_ADDR_MANUAL_TIME, targetTotalSeconds);
-            if (targetTotalSeconds > MAX_TOTAL_SECONDS) targetTotalSeconds = 0;
-        } else {
-            if (currentPresetChoice < NUM_PRESETS) targetTotalSeconds = PRESET_VALUES[currentPresetChoice];
-            else { targetTotalSeconds = 0; currentPresetChoice = 0; EEPROM.update(EEPROM_ADDR_PRESET, currentPresetChoice); }
-        }
-        lastPos = targetTotalSeconds / SECOND_INCREMENT;
-        encoder.setPosition(lastPos * STEPS); 
-        displayMIN = targetTotalSeconds / 60;
-        displaySEC = targetTotalSeconds % 60;
-        displayCS = 0;
-        lastDisplayedMIN = -1; 
-        lastDisplayedSEC = -1;
-        updateStaticDisplay();      // Appel à la fonction maintenant dans timer.cpp
-        updateCentisecondsDisplay(); // Appel à la fonction maintenant dans timer.cpp
-        displayStatusLine3();
-    } else if (currentMode == MODE_METRONOME) {
-        encoder.setPosition(currentBPM); 
-        metroEncoderLastPos = currentBPM; // Assurez-vous que metroEncoderLastPos est aussi mis à jour si utilisé
-        displayMetronomeScreen();
-    } else if (currentMode >= MODE_MENU_MAIN && currentMode <= MODE_MENU_TS_METRO) { 
-        bigNum.begin(); 
-        LCD.createChar(ARROW_UP_CHAR_CODE, arrowUp_Pattern);
-        LCD.createChar(ARROW_DOWN_CHAR_CODE, arrowDown_Pattern);
-        lastEncoderMenuPos = encoder.getPosition(); 
-        if(currentMode == MODE_MENU_MAIN) displayMainMenu();
-        else if(currentMode == MODE_MENU_MELODY) displayMelodyMenu();
-        else if(currentMode == MODE_MENU_PRESET) displayPresetMenu();
-        else if(currentMode == MODE_MENU_VEILLE) displayVeilleMenu();
-        else if(currentMode == MODE_MENU_TS_METRO) displayTSMetroMenu();
-    }
+    modeRedraw(); // Chaque mode redessine son écran (MODE_TABLE)
     resetActivityTimer(); 
 }
 
-ISR(PCINT2_vect) {
-    // Juste pour le réveil
+// Le geste qui a rallumé l'interface ne doit pas aussi agir (ex: mettre le décompte en pause)
+void ignoreWakeInput() {
+    ignoreCurrentPress();
+    encoder.tick();
+    resetActivityTimer();
 }
 
 void playClickSound() {
-  if (buzzerFeedbackEnabled) {
-    tone(BUZZER_PIN, CLICK_FREQUENCY, CLICK_DURATION);
+  if (appFlags.buzzerFeedbackEnabled) {
+    playSound(SOUND_UI, CLICK_FREQUENCY, CLICK_DURATION); // Attend la fin d'un temps ou d'une mélodie (buzzer.h)
   }
 }
 
@@ -14,11 +14,28 @@ enum Mode {
   MODE_MENU_VEILLE,
   MODE_METRONOME,
   MODE_MENU_TS_METRO, 
-  MODE_MENU_TEMPO_PRESET
+  MODE_MENU_TEMPO_PRESET,
+  MODE_DIAGNOSTIC,
+  MODE_EDIT_PRESET,
+  MODE_CHRONO,
+  MODE_BENCH,             // Banc d'essai (caché : appui long sur l'écran Diagnostic)
+  MODE_PRACTICE,          // Séance minutée : métronome et décompte ensemble (pratique.h)
+  MODE_COUNT // Nombre de modes (taille de MODE_TABLE, modes.h) : toujours en dernier
 };
 
 enum TimerRunState { STATE_IDLE, STATE_RUNNING, STATE_PAUSED };
 enum MetronomeRunState { METRO_STOPPED, METRO_RUNNING };
+enum ChronoState : byte { CHRONO_RESET, CHRONO_RUNNING, CHRONO_STOPPED };
+enum PracticeState : byte { PRACTICE_READY, PRACTICE_RUNNING, PRACTICE_PAUSED, PRACTICE_ENDING, PRACTICE_DONE };
+
+// Indicateurs globaux regroupés dans un octet (champs de bits). Aucune interruption ne les
+// modifie : l'écriture d'un champ relit et réécrit l'octet entier.
+struct AppFlags {
+  bool buzzerFeedbackEnabled : 1; // Bips de l'interface
+  bool timerMelodyEnabled : 1;    // Mélodie en fin de décompte
+  bool splashActive : 1;          // Écran de démarrage affiché (BOOT_SPLASH_ENABLED)
+};
+extern AppFlags appFlags;
 // --- Fin Énumérations Globales ---
 
 // --- Informations Auteur/Version ---
@@ -29,15 +46,45 @@ enum MetronomeRunState { METRO_STOPPED, METRO_RUNNING };
 
 // Broches Arduino
 const byte BUTTON_PIN = 6;
-const byte RELAY_PIN  = 10;
+const byte RELAY_PIN  = 10; // Sorties programmées : voir OUTPUT_CHANNELS (.ino) et sorties.h
+const byte LAMP_PIN   = 8;
+const byte STROBE_PIN = 9;
 const byte BUZZER_PIN = 12; // Utilisé par melodie.h
 const byte ENCODER_DT_PIN = 4;  // Broche DT de l'encodeur
 const byte ENCODER_CLK_PIN = 2; // Broche CLK de l'encodeur
 
+// Port série (rapports de diagnostic)
+const unsigned long SERIAL_BAUD = 115200;
+
+// MIDI (midi.h) : 1 = l'UART devient une prise MIDI (31250 bauds, horloge du métronome), les
+// rapports texte sont alors coupés (rapport.h). Compiler avec -DMIDI_ENABLED=1 ou modifier ici.
+#ifndef MIDI_ENABLED
+#define MIDI_ENABLED 0
+#endif
+const unsigned long MIDI_BAUD = 31250;
+
+// Journal des entrées (journal.h) : 1 = encodeur et bouton enregistrés pour être rejoués à
+// l'identique sur une autre unité. Coûte environ 200 octets de SRAM, plus une copie de l'écran LCD
+// (LCD_COLS * LCD_ROWS octets). Utilise le port série : incompatible avec MIDI_ENABLED.
+#ifndef INPUT_JOURNAL
+#define INPUT_JOURNAL 0
+#endif
+static_assert(!(INPUT_JOURNAL && MIDI_ENABLED), "INPUT_JOURNAL utilise le port serie, occupe par MIDI_ENABLED");
+
 // Configuration LCD I2C
-const byte LCD_ADDR = 0x27; // Adresse I2C de l'écran
-const byte LCD_COLS = 20;   // Nombre de colonnes de l'écran
-const byte LCD_ROWS = 4;    // Nombre de lignes de l'écran
+// Panneau choisi à la compilation : 1602 (16x2), 2004 (20x4) ou 4004 (40x4), colonnes puis lignes.
+// Modifier la valeur ci-dessous ou compiler avec -DLCD_PANEL=1602. Disposition déduite : geometrie.h
+#ifndef LCD_PANEL
+#define LCD_PANEL 2004
+#endif
+// Afficheur (ecran.h) : 0 = LCD HD44780 avec module PCF8574, 1 = OLED SSD1306 128x64 (grille 20x4 émulée)
+#ifndef DISPLAY_OLED
+#define DISPLAY_OLED 0
+#endif
+const byte LCD_ADDR = DISPLAY_OLED ? 0x3C : 0x27; // Adresse I2C de l'écran
+const byte LCD_COLS = LCD_PANEL / 100;   // Nombre de colonnes de l'écran
+const byte LCD_ROWS = LCD_PANEL % 100;   // Nombre de lignes de l'écran
+const unsigned int DISPLAY_BUS_QUEUE_SIZE = 256; // File d'émission I2C vidée par interruption (ecran_bus.h), puissance de deux
 
 // --- Constantes pour l'Encodeur et le Temps ---
 const byte STEPS   = 1;             // Nombre de pas logiques par "clic" physique de l'encodeur
@@ -47,31 +94,56 @@ const int POSMIN  = 0;             // Position logique minimale de l'encodeur (c
 // Position logique maximale (calculée automatiquement)
 const int POSMAX  = MAX_TOTAL_SECONDS / SECOND_INCREMENT;
 
+// --- Barre de progression du décompte (progression.h, position : geometrie.h) ---
+const byte PROGRESS_PARTIAL_CHAR = 7;    // Caractère custom de la seule case partiellement remplie
+const byte PROGRESS_FULL_CHAR = 0xFF;    // Pavé plein de la ROM HD44780 (reproduit par l'OLED)
+const byte PROGRESS_COLS_PER_CELL = 5;   // Colonnes de pixels d'une case : 5 positions par case
+
 // --- Constantes de Temporisation ---
 const int debounceDelay = 50;        // Délai anti-rebond pour le bouton (en ms)
 const unsigned long csUpdateInterval = 50; // Intervalle de rafraîchissement des centisecondes (en ms)
 const unsigned long longPressDuration = 1000; // Durée pour appui long pour accéder au menu (ms)
+const unsigned long doubleClickWindow = 300;  // Délai max entre relâchement et nouvel appui pour un double-clic (ms)
+const unsigned long holdRepeatInterval = 200; // Répétition pendant le maintien, après l'appui long (ms)
+const unsigned int BUTTON_SETTLE_US = 5000;   // Fronts plus rapprochés = rebonds (µs), voir bouton.h
+const byte BUTTON_EDGE_QUEUE_SIZE = 16;       // Fronts en attente (capturés par l'ISR)
+const byte BUTTON_EVENT_QUEUE_SIZE = 8;       // Gestes en attente de traitement
 const unsigned long blinkSequenceDuration = 5000; // Durée du clignotement final (ms) <<< AJOUTEZ/DÉCOMMMENTEZ
 const unsigned long endBlinkInterval = 250;       // Intervalle de basculement du rétroéclairage (ms) <<< AJOUTEZ/DÉCOMMMENTEZ
+const unsigned int DISPLAY_I2C_BUDGET_US = 8000;  // Budget d'écriture LCD par passage de loop() (µs), voir affichage.h
+
+// --- Démarrage ---
+const bool BOOT_SPLASH_ENABLED = true;             // false = démarrage rapide, écran du minuteur tout de suite
+const unsigned long SPLASH_TITLE_DURATION = 1000;  // Écran titre (ms)
+const unsigned long SPLASH_INIT_DURATION  = 1500;  // Ligne "Initialisation..." (ms)
+const unsigned long SPLASH_INFO_DURATION  = 1500;  // Écran auteur/version (ms)
+
+// --- Surveillance Mémoire (diagnostic.h) ---
+const unsigned long MEMORY_CHECK_INTERVAL = 1000; // Période de mesure de la SRAM (ms)
+const unsigned int SRAM_WARNING_THRESHOLD = 150;  // Alerte si la marge minimale pile/tas passe sous ce seuil (octets)
 
+// --- Points de Reprise du Décompte (checkpoint.h) ---
+const unsigned long CHECKPOINT_INTERVAL = 30000;  // Écriture périodique pendant le décompte (ms) : 120 enregistrements/heure
+const bool POWER_FAIL_DETECT_ENABLED = false;     // true si un pont diviseur de l'alimentation est câblé sur D7 (AIN1)
+const byte POWER_FAIL_SENSE_PIN = 7;              // AIN1 du comparateur analogique
+
+// --- Sorties Programmées (sorties.h) ---
+const byte NUM_OUTPUT_CHANNELS = 3;              // Lignes de OUTPUT_CHANNELS (.ino) : relais, lampe, flash
+
+// --- Décompte Basse Consommation (lowpower.h) ---
+const bool LOW_POWER_RUN_ENABLED = true;            // Écran éteint et MCU en power-down pendant les longs décomptes
+const unsigned long LOW_POWER_IDLE_DELAY = 15000;   // Inactivité avant extinction pendant un décompte (ms)
+const unsigned long LOW_POWER_WAKE_MARGIN = 3000;   // Fin du décompte toujours vécue éveillé, écran allumé (ms)
+const byte WDT_CALIBRATION_TICKS = 4;               // Périodes WDT de 16 ms mesurées à la première mise en veille du décompte
+const unsigned long AWAKE_CURRENT_UA = 42000;       // Estimation éveillé : MCU 16 MHz ~15 mA + rétroéclairage ~25 mA + LCD ~2 mA
+const unsigned long SLEEP_CURRENT_UA = 1300;        // Estimation veille : LCD éteint ~1,2 mA + PCF8574 ~0,1 mA + MCU/WDT ~6 µA
 
-// --- Constantes pour la disposition de l'Affichage LCD ---
-const byte STATUS_ROW = 0;
-const byte STATUS_COL_START = 0;
-const byte BIG_NUM_ROW = 1;     // Ligne supérieure des grands chiffres
-const byte BIG_M1_COL = 2;      // Colonne début Dizaines Minutes
-const byte BIG_M2_COL = 5;      // Colonne début Unités Minutes (M1 + 3)
-const byte COLON_COL = 8;       // Colonne du séparateur ":" ou "."
-const byte BIG_S1_COL = 9;      // Colonne début Dizaines Secondes
-const byte BIG_S2_COL = 12;     // Colonne début Unités Secondes (S1 + 3)
-const byte CS_ROW = 2;          // Ligne d'affichage des centisecondes
-const byte CS_COL = 15;         // Colonne de départ pour ".CS"
-const byte MELODY_NAME_ROW = 3; // Ligne pour afficher le nom de la mélodie
-const byte MELODY_NAME_COL = 1; // Colonne de départ pour icône + nom
 
 // --- Configuration Menu & EEPROM ---
+// Schéma 1 des réglages (ancien) : un champ par adresse, sans version ni contrôle. Ces adresses ne
+// sont plus lues qu'une fois, par la migration vers l'enregistrement EEPROM_ADDR_SETTINGS (reglages.h).
 const int EEPROM_ADDR_MELODY                  = 0;       // Adresse mémoire pour choix mélodie
-const int EEPROM_ADDR_PRESET                  = 1;       // Adresse mémoire pour choix preset/mode (0=Manuel, 1=P1...)
+const int EEPROM_ADDR_PRESET                  = 1;       // Choix courant : 0 = Manuel, n = emplacement n-1 de la bibliothèque (presets.h)
 const int EEPROM_ADDR_MANUAL_TIME             = 2;       // Adresse pour temps manuel (prend 2 octets: 2 et 3)
 // L'adresse 4 est réservée pour EEPROM_ADDR_SLEEP_DELAY ci-dessous
 // --- Configuration Veille (Sleep) ---
@@ -82,26 +154,55 @@ const int EEPROM_ADDR_TIMER_MELODY_ENABLED    = 6;      // Adresse pour activer/
 const int EEPROM_ADDR_METRONOME_BPM           = 7;      // Prend 1 octet (pour BPM jusqu'à 255) ou 2 pour plus.
 const int EEPROM_ADDR_METRONOME_TS_NUM        = 9;      // Numérateur de la signature rythmique (ex: 4 pour 4/4)
 const int EEPROM_ADDR_METRONOME_TS_DEN        = 10;     // byte, <<< NOUVELLE ADRESSE EEPROM POUR LE DÉNOMINATEUR
+const int EEPROM_ADDR_MIDI_SYNC               = 11;     // byte, MidiSync (midi.h) : arrêt, maître ou esclave
+// --- EEPROM DES RÉGLAGES (reglages.h) : un enregistrement versionné, protégé par CRC ---
+const int EEPROM_ADDR_SETTINGS                = 12;     // SETTINGS_RECORD_SIZE octets (12..31)
+const byte SETTINGS_RECORD_SIZE               = 20;
+const byte SETTINGS_VERSION                   = 2;      // Schéma courant ; à incrémenter (et migrer) si Settings change
+// --- EEPROM POUR POINTS DE REPRISE (anneau, usure répartie) ---
+const int EEPROM_ADDR_CHECKPOINT              = 32;     // CHECKPOINT_SLOTS * CHECKPOINT_RECORD_SIZE octets (32..95)
+const byte CHECKPOINT_SLOTS                   = 8;
+const byte CHECKPOINT_RECORD_SIZE             = 8;
+// --- EEPROM POUR LA BIBLIOTHÈQUE DE PRESETS (presets.h) ---
+const int EEPROM_ADDR_PRESET_LIBRARY          = 96;     // Octet de format (PRESET_LIBRARY_MAGIC)
+const int EEPROM_ADDR_PRESET_ORDER            = 97;     // PRESET_SLOTS octets : emplacements du plus au moins récent, 0xFF = fin (97..128)
+const int EEPROM_ADDR_PRESET_RECORDS          = 129;    // PRESET_SLOTS * PRESET_RECORD_SIZE octets : nom + durée (129..448)
+const byte PRESET_SLOTS                       = 32;
+const byte PRESET_NAME_LEN                    = 8;      // Nom court, complété par des espaces, sans zéro final
+const byte PRESET_RECORD_SIZE                 = PRESET_NAME_LEN + 2;
+// --- EEPROM DU BANC D'ESSAI (banc.h) ---
+const int EEPROM_ADDR_BENCH_HISTORY           = 449;    // BENCH_HISTORY_SLOTS * BENCH_RECORD_SIZE octets (449..512)
+const byte BENCH_HISTORY_SLOTS                = 4;
+const byte BENCH_RECORD_SIZE                  = 16;
+const int EEPROM_ADDR_BENCH_SCRATCH           = 513;    // Octet réécrit par la mesure d'écriture EEPROM
+// --- EEPROM DU JOURNAL DES ENTRÉES (journal.h, INPUT_JOURNAL) ---
+const int EEPROM_ADDR_JOURNAL                 = 520;    // Octet JOURNAL_MAGIC puis le journal à rejouer (520..688)
+const byte JOURNAL_MAGIC                      = 0xA5;   // Rejeu armé ; effacé au démarrage qui le lance
+const byte JOURNAL_ENTRIES                    = 48;     // Entrées gardées (3 octets chacune), les plus anciennes écrasées
+const byte JOURNAL_FORMAT                     = 1;      // Format de la trame JOURNAL / REJOUER
 
-// --- Configuration des Préréglages de Tempo --- <<< NOUVELLE SECTION
-const byte NUM_TEMPO_PRESETS  = 8; // Nombre de préréglages de tempo
+// --- Configuration des Indications de Tempo ---
+// Table des plages de tempo (PROGMEM), TRIÉE par minBpm croissant : une indication s'applique de son
+// minBpm jusqu'au minBpm de la suivante - 1, la dernière jusqu'à MAX_BPM. Recherche dichotomique :
+// findTempoMarking() (metronome.h). Le menu "Tempo Class." propose chaque indication à sa valeur bpm.
+const byte NUM_TEMPO_MARKINGS = 16; // Nombre d'indications de tempo
+const byte TEMPO_NAME_SIZE = 13;    // "Andante mod." + zéro final
+const byte TEMPO_DESC_SIZE = 16;    // "extreme. rapide" + zéro final
 
-struct TempoPreset {
-  const char* name;       // Nom du tempo (ex: "Allegro")
-  const char* frenchDesc; // Description en français (ex: "rapide")
-  int bpm;                // Pulsation par minute
+struct TempoMarking {
+  char name[TEMPO_NAME_SIZE];       // Nom italien (ex: "Allegro")
+  char frenchDesc[TEMPO_DESC_SIZE]; // Description en français (ex: "rapide")
+  byte minBpm;                      // Début de la plage
+  byte bpm;                         // Valeur proposée par le menu (dans la plage)
 };
 
 // Déclaration seulement (la définition = { ... } sera dans le .ino)
-extern const TempoPreset tempoPresets[];
-// --- Fin Configuration des Préréglages de Tempo ---
+extern const TempoMarking tempoMarkings[] PROGMEM;
+// --- Fin Configuration des Indications de Tempo ---
 
 const byte NUM_MELODIES = 6;      // Nombre total de mélodies disponibles (Mario, Star Wars, Zelda, Nokia Tune, Tetris Theme (Thème A), Bip-Bip)
-const byte NUM_PRESETS = 4;       // Nombre total d'options de preset (Manuel, 1min, 2min, 3min)
-
-// Valeurs des presets en secondes (l'index correspond au choix, ex: PRESET_VALUES[1] = 60)
-// LA DÉFINITION (= { ... }) de ce tableau DOIT être dans le .ino
-extern const unsigned int PRESET_VALUES[]; // Déclaration seulement
+const byte NUM_DEFAULT_PRESETS = 3;           // Presets installés au premier démarrage (DEFAULT_PRESETS, .ino)
+const unsigned int PRESET_MAX_SECONDS = 5999; // 99:59, limite de l'affichage MM:SS en grands chiffres
 
 
 
@@ -116,6 +217,8 @@ extern const char* const SLEEP_DELAY_NAMES[];
 /* const bool ENABLE_BUZZER_FEEDBACK = true;  // Activer (true) ou désactiver (false) les clics */
 const unsigned int CLICK_FREQUENCY = 2731;    // Fréquence du clic (Hz) - Ajustez selon vos préférences
 const byte CLICK_DURATION = 15;               // Durée très courte du clic (ms) - Ajustez si besoin
+const byte BUZZER_QUEUE_SIZE = 4;             // Sons en attente derrière un son plus prioritaire (buzzer.h)
+const unsigned int BUZZER_MAX_DELAY_MS = 40;  // Attente au-delà de laquelle un son est abandonné
 
 
 // --- CONSTANTES POUR MÉTRONOME ---
@@ -127,21 +230,8 @@ const byte METRONOME_CLICK_DURATION = 30;      // ms
 const unsigned int METRONOME_ACCENT_FREQ = 2700;
 const byte METRONOME_ACCENT_DURATION = 50;     // ms
 
-// Disposition LCD pour Métronome
-const byte METRO_STATUS_ROW = 0;
-const byte METRO_STATUS_COL = 0;
-const byte METRO_BPM_BIG_NUM_ROW = 1;  // Ligne supérieure des grands chiffres pour BPM
-const byte METRO_BPM_BIG_NUM_COL = 6;  // Colonne pour afficher 3 chiffres de BPM (centré approx.)
-                                       // Chaque grand chiffre prend 3 colonnes. 3*3=9. (20-9)/2 = 5.5 -> 5 ou 6.
-const byte METRO_TS_ROW = 0;           // Ligne pour la signature rythmique
-const byte METRO_TS_COL = 13;          // Colonne pour afficher "TS: 4/4"
-const byte METRO_BEAT_VISUAL_ROW = 3;  // Ligne pour l'indicateur visuel de battement
-const byte METRO_BEAT_VISUAL_COL = 9;  // Colonne pour l'indicateur visuel de battement
-
-// Constantes pour l'affichage des temps du métronome
+// Constantes pour l'affichage des temps du métronome (positions : geometrie.h)
 const byte METRO_BEAT_MARKER_CHAR = 1;          // Index du caractère custom 'upperBar'
-const byte METRO_BEAT_MARKER_START_COL = 1;     // Colonne de départ pour le premier marqueur de temps
-                                                // (laisse la colonne 0 pour le bord de l'écran ou un petit espace)
 
 const byte DEFAULT_TIME_SIGNATURE_NUMERATOR = 4; // ex: 4 pour 4/4
 const byte MIN_TIME_SIGNATURE_NUMERATOR = 1;     // 
@@ -150,5 +240,33 @@ const byte MAX_TIME_SIGNATURE_NUMERATOR = 16;    // (ex: jusqu'à 16/4, modifiab
 const byte MIN_TIME_SIGNATURE_DENOMINATOR = 1;  // <<< NOUVEAU
 const byte MAX_TIME_SIGNATURE_DENOMINATOR = 8;  // <<< NOUVEAU
 const byte DEFAULT_TIME_SIGNATURE_DENOMINATOR = 4; // <<< NOUVEAU
+const unsigned int TEMPO_SAVE_DELAY_MS = 2000;   // BPM enregistré quand l'encodeur ne tourne plus depuis ce délai
+const int TEMPO_RAMP_BPM = 20;                   // Double-clic au départ : accelerando de +20 BPM (négatif : ritardando)...
+const byte TEMPO_RAMP_MEASURES = 8;              // ...réparti sur 8 mesures, un palier par temps fort
+
+// --- Horloge MIDI du métronome (midi.h, MIDI_ENABLED) ---
+const byte MIDI_PPQN = 24;                         // Impulsions d'horloge par noire (norme MIDI)
+const byte MIDI_BEAT_CHANNEL = 9;                  // Canal 10 (batterie), numéroté 0..15
+const byte MIDI_NOTE_ACCENT = 76;                  // Wood block aigu : premier temps
+const byte MIDI_NOTE_BEAT = 77;                    // Wood block grave : autres temps
+const byte MIDI_BEAT_VELOCITY = 100;
+const byte MIDI_TX_RING_SIZE = 16;                 // Octets en attente d'émission (notes, hors horloge)
+const byte MIDI_RX_QUEUE_SIZE = 8;                 // Messages temps réel reçus en attente de serviceMidi()
+const unsigned int MIDI_LOCK_TOLERANCE_US = 1000;  // Erreur de phase sous laquelle l'esclave est verrouillé
+const byte MIDI_TEMPO_HYSTERESIS_X16 = 12;         // currentBPM ne suit le tempo estimé qu'au-delà de 0,75 BPM d'écart
+
+// --- Banc d'essai (banc.h) ---
+const unsigned int BENCH_PHASE_MS = 250;        // Durée des mesures de débit (caractères, grands chiffres)
+const byte BENCH_CLEAR_COUNT = 8;               // LCD.clear() mesurés (moyenne)
+const byte BENCH_EEPROM_WRITES = 4;             // Octets programmés (moyenne)
+const unsigned int BENCH_TONE_HZ = 4000;        // Fréquence du bip de mesure de tone()
+const unsigned int BENCH_LOOP_WINDOW_MS = 1000; // Fenêtre de comptage des passes de loop()
+
+// --- Chronomètre (chrono.h) ---
+const byte CHRONO_LAP_SLOTS = 16; // Temps intermédiaires gardés en RAM (anneau, 4 octets chacun)
+
+// --- Séance de pratique (pratique.h) ---
+const unsigned int PRACTICE_CHIME_FREQ = 1760;   // Carillon de fin de séance (Hz)
+const unsigned int PRACTICE_CHIME_DURATION = 600; // ms
 
 #endif // CONF_H
\ No newline at end of file
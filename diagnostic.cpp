@@ -0,0 +1,152 @@
+// diagnostic.cpp - Instrumentation mémoire (SRAM, pile, tas) et écran de diagnostic
+
+#include "diagnostic.h"
+#include "rapport.h"
+
+// Symboles fournis par l'éditeur de liens et avr-libc
+extern uint8_t _end;          // Fin des variables statiques (.data + .bss)
+extern uint8_t __stack;       // Haut de la pile (RAMEND)
+extern uint8_t __heap_start;
+extern void* __brkval;        // Fin actuelle du tas (0 tant que malloc() n'a rien alloué)
+
+struct __freelist {
+  size_t sz;
+  struct __freelist* nx;
+};
+extern struct __freelist* __flp; // Liste des blocs libérés par free()
+
+const uint8_t STACK_CANARY = 0xC5;
+
+MemoryStats memoryStats = { 0, 0, 0, 0, 0 };
+
+static unsigned long lastMemoryCheck = 0;
+static bool memoryWarningSent = false;
+static unsigned long lastDiagnosticRefresh = 0;
+
+// Peint toute la SRAM libre avant l'initialisation du C (section .init1, sans pile ni r1)
+void paintStack() __attribute__((naked, used, section(".init1")));
+void paintStack() {
+  __asm volatile (
+    "    ldi r30, lo8(_end)      \n"
+    "    ldi r31, hi8(_end)      \n"
+    "    ldi r24, %0             \n"
+    "    ldi r25, hi8(__stack)   \n"
+    "    rjmp 2f                 \n"
+    "1:  st Z+, r24              \n"
+    "2:  cpi r30, lo8(__stack)   \n"
+    "    cpc r31, r25            \n"
+    "    brlo 1b                 \n"
+    "    breq 1b                 \n"
+    :: "M" (STACK_CANARY)
+  );
+}
+
+static uint8_t* heapEnd() {
+  return __brkval == 0 ? &__heap_start : (uint8_t*)__brkval;
+}
+
+void updateMemoryStats() {
+  uint8_t stackMarker;
+  uint8_t* heapTop = heapEnd();
+  memoryStats.freeNow = (unsigned int)(&stackMarker - heapTop);
+
+  // Octets de peinture encore intacts juste au-dessus du tas
+  const uint8_t* p = heapTop;
+  while (p < &stackMarker && *p == STACK_CANARY) { p++; }
+  memoryStats.minFree = (unsigned int)(p - heapTop);
+
+  unsigned int freeBytes = 0, largest = 0;
+  byte fragments = 0;
+  for (struct __freelist* block = __flp; block != 0; block = block->nx) {
+    unsigned int blockSize = block->sz + sizeof(size_t);
+    freeBytes += blockSize;
+    if (blockSize > largest) largest = blockSize;
+    if (fragments < 255) fragments++;
+  }
+  memoryStats.heapFreeBytes = freeBytes;
+  memoryStats.heapLargest = largest;
+  memoryStats.heapFragments = fragments;
+}
+
+void reportMemoryStats() {
+  Report.print(F("SRAM libre="));  Report.print(memoryStats.freeNow);
+  Report.print(F(" min="));        Report.print(memoryStats.minFree);
+  Report.print(F(" tas libre="));  Report.print(memoryStats.heapFreeBytes);
+  Report.print(F(" plus grand=")); Report.print(memoryStats.heapLargest);
+  Report.print(F(" frag="));       Report.println(memoryStats.heapFragments);
+  // État des modes superposé (modes.h) : octets rendus par rapport à des variables séparées
+  Report.print(F("Etat des modes=")); Report.print(sizeof(ModeState));
+  Report.print(F(" o (separes: ")); Report.print(MODE_STATE_SEPARATE_SIZE);
+  Report.print(F(" o, gain ")); Report.print(MODE_STATE_SEPARATE_SIZE - sizeof(ModeState)); Report.println(F(" o)"));
+}
+
+void serviceMemoryMonitor() {
+  unsigned long now = millis();
+  if (now - lastMemoryCheck < MEMORY_CHECK_INTERVAL) return;
+  lastMemoryCheck = now;
+  updateMemoryStats();
+  if (!memoryWarningSent && memoryStats.minFree < SRAM_WARNING_THRESHOLD) {
+    memoryWarningSent = true; // Une seule alerte par démarrage
+    Report.print(F("ALERTE SRAM: marge < ")); Report.print(SRAM_WARNING_THRESHOLD); Report.print(F(" o | "));
+    reportMemoryStats();
+  }
+}
+
+// --- Écran de diagnostic ---
+
+void enterDiagnosticMode() {
+    resetActivityTimer();
+    updateMemoryStats();
+    reportMemoryStats();
+    reportDisplayBusStats();
+    reportOutputStats();
+    reportBuzzerStats();
+    lastDiagnosticRefresh = millis();
+    LCD.clear();
+    displayDiagnosticScreen();
+}
+
+// Affiche un entier aligné à droite sur 'width' caractères (les valeurs restent à la même place)
+static void printPadded(unsigned int value, byte width) {
+    unsigned int limit = 10;
+    for (byte w = 1; w < width; w++) {
+        if (value < limit) LCD.print(' ');
+        limit *= 10;
+    }
+    LCD.print(value);
+}
+
+// 4 lignes : titre, libre, minimum, tas. 16x2 : libre et minimum seulement.
+static const byte DIAG_FIRST_ROW = LCD_TALL ? 1 : 0;
+
+void displayDiagnosticScreen() {
+    if (LCD_TALL) { LCD.setCursor(0, 0); LCD.print(F("Diagnostic SRAM")); }
+    LCD.setCursor(0, DIAG_FIRST_ROW); LCD.print(F("Libre: ")); printPadded(memoryStats.freeNow, 4); LCD.print(F(" o"));
+    LCD.setCursor(0, DIAG_FIRST_ROW + 1); LCD.print(F("Min:   ")); printPadded(memoryStats.minFree, 4); LCD.print(F(" o"));
+    if (memoryStats.minFree < SRAM_WARNING_THRESHOLD) { LCD.print(LCD_COLS >= textLen("Min:   NNNN o ALERTE") ? F(" ALERTE") : F(" !")); }
+    else { clearRestOfLine(textLen("Min:   NNNN o"), DIAG_FIRST_ROW + 1); }
+    if (LCD_TALL) {
+        LCD.setCursor(0, 3); LCD.print(F("Tas:")); printPadded(memoryStats.heapFreeBytes, 4);
+        LCD.print(F("/")); printPadded(memoryStats.heapLargest, 4);
+        LCD.print(F(" fr:")); printPadded(memoryStats.heapFragments, 3);
+    }
+}
+
+void loopDiagnostic() {
+    unsigned long now = millis();
+    if (now - lastDiagnosticRefresh >= 1000) {
+        lastDiagnosticRefresh = now;
+        updateMemoryStats();
+        displayDiagnosticScreen();
+    }
+}
+
+void redrawDiagnosticScreen() {
+    LCD.clear();
+    displayDiagnosticScreen();
+}
+
+void handleDiagnosticButton(ButtonEvent event) {
+    if (isClickEvent(event)) setMode(MODE_MENU_MAIN);
+    else if (event == BTN_LONG_PRESS) setMode(MODE_BENCH); // Banc d'essai (banc.h), volontairement absent du menu
+}
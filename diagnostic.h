@@ -0,0 +1,46 @@
+// diagnostic.h - Instrumentation mémoire (SRAM, pile, tas) et écran de diagnostic
+//
+// - La zone libre entre le tas et la pile est "peinte" avec STACK_CANARY au démarrage (.init1),
+//   avant même l'initialisation des variables : les octets encore intacts plus tard n'ont jamais
+//   été touchés par la pile => marge minimale réellement atteinte (interruptions comprises).
+// - Mémoire libre instantanée = pointeur de pile - fin du tas.
+// - Sonde de fragmentation : parcours de la liste des blocs libres de malloc() (avr-libc).
+#ifndef DIAGNOSTIC_H
+#define DIAGNOSTIC_H
+
+#include <Arduino.h>
+#include "ecran.h"
+#include "conf.h"
+#include "modes.h"
+#include "geometrie.h"
+#include "sorties.h"
+#include "buzzer.h"
+
+extern enum Mode currentMode;
+
+struct MemoryStats {
+  unsigned int freeNow;        // Octets libres entre le tas et la pile (instantané)
+  unsigned int minFree;        // Marge minimale jamais atteinte (octets de peinture intacts)
+  unsigned int heapFreeBytes;  // Octets libres dans la liste des blocs libérés de malloc()
+  unsigned int heapLargest;    // Plus grand bloc libre de cette liste
+  byte heapFragments;          // Nombre de blocs dans cette liste
+};
+extern MemoryStats memoryStats;
+
+// Fonctions utilitaires du .ino principal que ce module appelle
+void resetActivityTimer();
+void playClickSound();
+void clearRestOfLine(byte startCol, byte row);
+
+void updateMemoryStats();       // Recalcule memoryStats (parcours de la zone peinte : ~1 ms)
+void serviceMemoryMonitor();    // À appeler dans loop() : mesure périodique + alerte série
+void reportMemoryStats();       // Envoie memoryStats sur le port série
+
+// Écran de diagnostic (gestionnaires de MODE_DIAGNOSTIC, modes.h)
+void enterDiagnosticMode();
+void displayDiagnosticScreen();
+void redrawDiagnosticScreen();
+void loopDiagnostic();
+void handleDiagnosticButton(ButtonEvent event);
+
+#endif // DIAGNOSTIC_H
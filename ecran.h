@@ -0,0 +1,27 @@
+// ecran.h - Afficheur utilisé par le minuteur, le métronome et les menus, choisi à la compilation
+//
+// DisplayDevice (objet LCD) et BigNumberDevice (objet bigNum) offrent la même interface quel que
+// soit le backend : setCursor / print / write / clear / createChar / (no)Backlight / (no)Display,
+// et endFrame() en fin de passe de rendu (serviceDisplay()) ou avant une action bloquante.
+//  - DISPLAY_OLED 0 : LCD HD44780 + PCF8574 (ecran_lcd.h), grands chiffres par caractères CGRAM.
+//  - DISPLAY_OLED 1 : OLED SSD1306 128x64 (ecran_oled.h), grille 20x4 émulée, envoi des cases modifiées.
+#ifndef ECRAN_H
+#define ECRAN_H
+
+#include "conf.h"
+
+#if DISPLAY_OLED
+#include "ecran_oled.h"
+typedef OledSsd1306 DisplayDevice;
+typedef OledBigNumbers BigNumberDevice;
+#else
+#include "ecran_lcd.h"
+#include "BigNumbers_I2C.h"
+typedef LcdHd44780 DisplayDevice;
+typedef BigNumbers_I2C BigNumberDevice;
+#endif
+
+extern DisplayDevice LCD;
+extern BigNumberDevice bigNum;
+
+#endif // ECRAN_H
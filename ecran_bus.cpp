@@ -0,0 +1,176 @@
+// ecran_bus.cpp - Liaison I2C commune aux afficheurs : file d'émission vidée par l'interruption TWI
+
+#include "ecran_bus.h"
+#include "rapport.h"
+#include <util/atomic.h>
+#include <util/twi.h>
+
+DisplayBusStats displayBusStats = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+
+static_assert((DISPLAY_BUS_QUEUE_SIZE & (DISPLAY_BUS_QUEUE_SIZE - 1)) == 0 && DISPLAY_BUS_QUEUE_SIZE <= 256,
+              "DISPLAY_BUS_QUEUE_SIZE : puissance de deux, 256 au plus");
+static_assert(DISPLAY_BUS_QUEUE_SIZE >= 2 * (DISPLAY_BUS_CHUNK + 1 + 2), "DISPLAY_BUS_QUEUE_SIZE trop petit");
+static const byte QUEUE_MASK = DISPLAY_BUS_QUEUE_SIZE - 1;
+static const byte RECORD_HEADER = 2; // Adresse, longueur
+static const byte MAX_RECORD_DATA = DISPLAY_BUS_QUEUE_SIZE - 1 - RECORD_HEADER; // Plus long enregistrement que la file peut contenir
+static_assert(DISPLAY_BUS_CHUNK + 1 <= MAX_RECORD_DATA, "DISPLAY_BUS_CHUNK ne tient pas dans la file");
+
+// Enregistrements [adresse][longueur][données...] ; une case reste vide pour distinguer plein et vide
+static byte queue[DISPLAY_BUS_QUEUE_SIZE];
+static volatile byte queueHead = 0;     // Écrit par displayBusWrite (interruptions coupées)
+static volatile byte queueTail = 0;     // Écrit par l'ISR
+static volatile byte txRemaining = 0;   // Octets de données restant dans la transmission en cours
+static volatile bool busy = false;      // Une transmission est en cours ou enchaînée (ISR armée)
+static volatile bool appendOpen = false; // Le dernier enregistrement peut encore être prolongé
+static byte openHeader = 0;             // Position de son en-tête
+
+// TWINT acquitte l'étape, TWEN garde le périphérique, TWIE rappelle l'ISR à l'étape suivante
+static const byte TWCR_NEXT = _BV(TWINT) | _BV(TWEN) | _BV(TWIE);
+
+static byte queuedBytes() {
+  return (byte)(queueHead - queueTail) & QUEUE_MASK;
+}
+
+static void serviceTwi();
+
+// Attente de l'ISR : interruptions coupées (appel depuis un ATOMIC_BLOCK ou une autre ISR), TWI_vect
+// ne viendrait jamais ; l'étape terminée (TWINT) est alors servie ici
+static void pollTwi() {
+  if (!(SREG & _BV(SREG_I)) && (TWCR & _BV(TWINT))) serviceTwi();
+}
+
+void displayBusBegin(unsigned long clockHz) {
+  displayBusFlush();
+  digitalWrite(SDA, HIGH); // Tirages internes, en appoint de ceux du module
+  digitalWrite(SCL, HIGH);
+  TWSR = 0;                                  // Pré-diviseur 1
+  TWBR = ((F_CPU / clockHz) - 16) / 2;       // SCL = F_CPU / (16 + 2 * TWBR)
+  TWCR = _BV(TWEN);
+}
+
+void displayBusWrite(byte address, const byte* data, byte len, bool append) {
+  if (len == 0) return;
+  // Plus long que la file (PCF8574 seulement : l'OLED écrit par DISPLAY_BUS_CHUNK) : découpé
+  while (len > MAX_RECORD_DATA) {
+    displayBusWrite(address, data, MAX_RECORD_DATA, append);
+    data += MAX_RECORD_DATA;
+    len -= MAX_RECORD_DATA;
+  }
+  // Contre-pression : la boucle attend que l'ISR ait libéré la place nécessaire
+  byte needed = len + RECORD_HEADER; // MAX_RECORD_DATA + RECORD_HEADER < 256
+  if (DISPLAY_BUS_QUEUE_SIZE - 1 - queuedBytes() < needed) {
+    unsigned long start = micros();
+    while (DISPLAY_BUS_QUEUE_SIZE - 1 - queuedBytes() < needed) { pollTwi(); }
+    displayBusStats.stalls++;
+    displayBusStats.stallMicros += micros() - start;
+  }
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    byte head = queueHead;
+    byte lenIndex = (openHeader + 1) & QUEUE_MASK;
+    if (append && appendOpen && queue[openHeader] == address && queue[lenIndex] <= 255 - len) {
+      queue[lenIndex] += len; // L'ISR n'a pas encore lu cet en-tête : même transmission, sans nouvelle adresse
+      displayBusStats.frameBytes += len;
+    } else {
+      openHeader = head;
+      queue[head] = address;
+      queue[(head + 1) & QUEUE_MASK] = len;
+      head = (head + RECORD_HEADER) & QUEUE_MASK;
+      appendOpen = append;
+      displayBusStats.frameBytes += len + 1; // + octet d'adresse
+    }
+    for (byte i = 0; i < len; i++) {
+      queue[head] = data[i];
+      head = (head + 1) & QUEUE_MASK;
+    }
+    queueHead = head;
+    byte queued = queuedBytes();
+    if (queued > displayBusStats.maxQueued) displayBusStats.maxQueued = queued;
+    if (!busy) {
+      busy = true;
+      while (TWCR & _BV(TWSTO)) {} // STOP précédent pas encore sur le bus (quelques µs)
+      TWCR = TWCR_NEXT | _BV(TWSTA);
+    }
+  }
+}
+
+void displayBusFlush() {
+  if (!busy && !(TWCR & _BV(TWSTO))) return;
+  unsigned long start = micros();
+  while (busy) { pollTwi(); }
+  while (TWCR & _BV(TWSTO)) {}
+  displayBusStats.flushes++;
+  displayBusStats.flushMicros += micros() - start;
+}
+
+// Enregistrement suivant : START répété s'il y en a un, sinon STOP et ISR désarmée
+static void nextTransmission(bool afterError) {
+  if (queueTail != queueHead) {
+    TWCR = TWCR_NEXT | _BV(TWSTA) | (afterError ? _BV(TWSTO) : 0); // STOP puis START après une erreur
+  } else {
+    TWCR = _BV(TWINT) | _BV(TWEN) | _BV(TWSTO);
+    busy = false;
+  }
+}
+
+ISR(TWI_vect) {
+  serviceTwi();
+}
+
+// Corps de l'ISR, appelé aussi par pollTwi() (un appel direct de TWI_vect finirait par reti)
+static void serviceTwi() {
+  switch (TW_STATUS) {
+    case TW_START:
+    case TW_REP_START: {
+      byte tail = queueTail;
+      if (appendOpen && tail == openHeader) appendOpen = false; // Longueur figée : plus de prolongement
+      TWDR = queue[tail] << 1 | TW_WRITE;
+      txRemaining = queue[(tail + 1) & QUEUE_MASK];
+      queueTail = (tail + RECORD_HEADER) & QUEUE_MASK;
+      TWCR = TWCR_NEXT;
+      break;
+    }
+    case TW_MT_SLA_ACK:
+    case TW_MT_DATA_ACK:
+      if (txRemaining > 0) {
+        TWDR = queue[queueTail];
+        queueTail = (queueTail + 1) & QUEUE_MASK;
+        txRemaining--;
+        TWCR = TWCR_NEXT;
+      } else {
+        nextTransmission(false);
+      }
+      break;
+    default: // Adresse ou donnée refusée, arbitrage perdu, erreur de bus : le reste de l'enregistrement est abandonné
+      displayBusStats.errors++;
+      queueTail = (queueTail + txRemaining) & QUEUE_MASK;
+      txRemaining = 0;
+      nextTransmission(true);
+      break;
+  }
+}
+
+void displayBusEndFrame() {
+  unsigned int bytes = displayBusStats.frameBytes;
+  if (bytes == 0) return;
+  displayBusStats.frameBytes = 0;
+  displayBusStats.frames++;
+  displayBusStats.totalBytes += bytes;
+  displayBusStats.lastFrameBytes = bytes;
+  if (bytes > displayBusStats.maxFrameBytes) displayBusStats.maxFrameBytes = bytes;
+}
+
+void reportDisplayBusStats() {
+  unsigned int errors;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { errors = displayBusStats.errors; } // Compté par l'ISR
+  Report.print(F("Ecran trames="));  Report.print(displayBusStats.frames);
+  Report.print(F(" octets="));       Report.print(displayBusStats.totalBytes);
+  Report.print(F(" derniere="));     Report.print(displayBusStats.lastFrameBytes);
+  Report.print(F(" max="));          Report.println(displayBusStats.maxFrameBytes);
+  Report.print(F("File I2C max="));  Report.print(displayBusStats.maxQueued);
+  Report.print('/');                 Report.print(DISPLAY_BUS_QUEUE_SIZE - 1);
+  Report.print(F(" attentes="));     Report.print(displayBusStats.stalls);
+  Report.print(F(" ("));             Report.print(displayBusStats.stallMicros);
+  Report.print(F(" us) vidages="));  Report.print(displayBusStats.flushes);
+  Report.print(F(" ("));             Report.print(displayBusStats.flushMicros);
+  Report.print(F(" us) erreurs="));  Report.println(errors);
+}
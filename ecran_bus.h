@@ -0,0 +1,48 @@
+// ecran_bus.h - Liaison I2C commune aux afficheurs (ecran_lcd, ecran_oled) et comptage par trame
+//
+// Chaque backend envoie ses octets par displayBusWrite() (une transmission, adresse comprise dans
+// le comptage) et clôt chaque passe de rendu par displayBusEndFrame(). Les statistiques donnent le
+// coût réel d'une trame sur le bus, quel que soit l'afficheur.
+//
+// Pilote TWI direct, sans Wire : displayBusWrite() copie la transmission dans une file circulaire
+// de DISPLAY_BUS_QUEUE_SIZE octets (conf.h) et rend la main ; l'ISR TWI_vect l'envoie octet par
+// octet et enchaîne les transmissions par START répété. Une mise à jour de l'heure (une dizaine
+// d'octets LCD, ~4 ms de bus à 100 kHz) ne coûte plus que la copie à loop(). File pleine : l'appel
+// attend la place nécessaire (contre-pression, comptée dans stalls/stallMicros) ; interruptions
+// coupées, cette attente et celle de displayBusFlush() servent elles-mêmes le TWI. Une écriture plus
+// longue que la file est découpée en plusieurs transmissions.
+// Avec append, deux écritures successives vers la même adresse partagent une transmission tant que
+// l'ISR n'a pas commencé la seconde (PCF8574 : chaque octet est un état des sorties ; jamais pour
+// l'OLED, dont l'octet de contrôle ouvre chaque transmission).
+// displayBusFlush() est la barrière des délais du contrôleur (effacement HD44780, initialisation)
+// et de la mise en veille : il rend la main une fois le dernier octet envoyé et le STOP émis.
+#ifndef ECRAN_BUS_H
+#define ECRAN_BUS_H
+
+#include <Arduino.h>
+#include "conf.h"
+
+const byte DISPLAY_BUS_CHUNK = 31; // Octets de données par écriture OLED (tampon sur la pile), octet de contrôle en plus
+
+struct DisplayBusStats {
+  unsigned long frames;         // Trames ayant envoyé au moins un octet
+  unsigned long totalBytes;     // Octets envoyés depuis le démarrage (adresses comprises)
+  unsigned int frameBytes;      // Octets de la trame en cours
+  unsigned int lastFrameBytes;  // Octets de la dernière trame
+  unsigned int maxFrameBytes;   // Plus grosse trame
+  unsigned int stalls;          // Écritures ayant attendu de la place dans la file
+  unsigned long stallMicros;    // Temps total de ces attentes (µs)
+  unsigned int flushes;         // Appels de displayBusFlush() ayant attendu
+  unsigned long flushMicros;    // Temps total de ces attentes (µs)
+  byte maxQueued;               // Remplissage maximal de la file (octets, en-têtes compris)
+  unsigned int errors;          // Transmissions refusées ou interrompues (écrit par l'ISR)
+};
+extern DisplayBusStats displayBusStats;
+
+void displayBusBegin(unsigned long clockHz);
+void displayBusWrite(byte address, const byte* data, byte len, bool append = false); // Mise en file, retour immédiat
+void displayBusFlush();       // Attend que la file soit vide et le bus libre
+void displayBusEndFrame();
+void reportDisplayBusStats(); // Envoie displayBusStats sur le port série
+
+#endif // ECRAN_BUS_H
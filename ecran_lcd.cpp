@@ -0,0 +1,124 @@
+// ecran_lcd.cpp - Backend LCD HD44780 derrière un PCF8574
+
+#include "ecran_lcd.h"
+#if INPUT_JOURNAL
+#include <string.h>
+#include <util/crc16.h>
+#endif
+
+// Bits du PCF8574
+const byte PCF_RS = 0x01;
+const byte PCF_EN2 = 0x02; // E du second contrôleur des 40x4, à la place de RW
+const byte PCF_EN = 0x04;
+const byte PCF_BACKLIGHT = 0x08;
+
+// Commandes HD44780
+const byte LCD_CMD_CLEAR = 0x01;
+const byte LCD_CMD_ENTRY_MODE = 0x06;     // Curseur vers la droite, pas de décalage
+const byte LCD_CMD_DISPLAY_CONTROL = 0x08;
+const byte LCD_DISPLAY_ON = 0x04;
+const byte LCD_CMD_FUNCTION_SET = 0x28;   // 4 bits, 2 lignes, 5x8
+const byte LCD_CMD_SET_CGRAM = 0x40;
+const byte LCD_CMD_SET_DDRAM = 0x80;
+const byte LCD_CONTROLLER_CELLS = 80;     // DDRAM d'un HD44780 : au-delà, un second contrôleur
+
+LcdHd44780::LcdHd44780(byte address, byte cols, byte rows)
+  : _address(address), _cols(cols), _rows(rows),
+    _enableAll(cols * rows > LCD_CONTROLLER_CELLS ? PCF_EN | PCF_EN2 : PCF_EN), _enable(PCF_EN),
+    _backlight(PCF_BACKLIGHT), _displayControl(LCD_CMD_DISPLAY_CONTROL | LCD_DISPLAY_ON) {}
+
+void LcdHd44780::begin() {
+  displayBusBegin(100000UL); // PCF8574 : 100 kHz
+  delay(50);                 // Alimentation du contrôleur (> 40 ms)
+  // Séquence d'initialisation par instructions (fiche HD44780, fig. 24) : repasse en 4 bits
+  // quel que soit l'état laissé par un redémarrage du MCU
+  writeNibble(0x30); delayMicroseconds(4500);
+  writeNibble(0x30); delayMicroseconds(4500);
+  writeNibble(0x30); delayMicroseconds(150);
+  writeNibble(0x20);
+  command(LCD_CMD_FUNCTION_SET);
+  command(_displayControl);
+  clear();
+  command(LCD_CMD_ENTRY_MODE);
+  endFrame();
+}
+
+void LcdHd44780::clear() {
+  command(LCD_CMD_CLEAR);
+  _enable = PCF_EN; // Curseur des deux contrôleurs en 0 : la suite s'écrit en ligne 0
+#if INPUT_JOURNAL
+  memset(_shadow, ' ', sizeof(_shadow));
+  _col = 0; _row = 0;
+#endif
+  displayBusFlush();       // Le délai court à partir de l'envoi effectif de la commande
+  delayMicroseconds(1600); // 1,52 ms d'exécution : seule instruction lente utilisée
+}
+
+void LcdHd44780::setCursor(byte col, byte row) {
+  if (row >= _rows) row = _rows - 1;
+  // Lignes 0/1 à 0x00/0x40, lignes 2/3 à leur suite (+ nombre de colonnes) ; sur 40x4, lignes 2/3
+  // aux mêmes adresses que 0/1, dans le second contrôleur
+  bool second = _enableAll != PCF_EN && row >= 2;
+  byte address = (row & 1 ? 0x40 : 0x00) + (row & 2 && !second ? _cols : 0) + col;
+  _enable = second ? PCF_EN2 : PCF_EN;
+  send(LCD_CMD_SET_DDRAM | address, 0, _enable);
+#if INPUT_JOURNAL
+  _col = col; _row = row;
+#endif
+}
+
+void LcdHd44780::backlight()   { _backlight = PCF_BACKLIGHT; command(_displayControl); }
+void LcdHd44780::noBacklight() { _backlight = 0; command(_displayControl); }
+void LcdHd44780::display()     { _displayControl |= LCD_DISPLAY_ON; command(_displayControl); }
+void LcdHd44780::noDisplay()   { _displayControl &= ~LCD_DISPLAY_ON; command(_displayControl); }
+
+void LcdHd44780::createChar(byte slot, const byte pattern[8]) {
+  command(LCD_CMD_SET_CGRAM | ((slot & 0x07) << 3));
+#if INPUT_JOURNAL
+  _col = 0xFF; // Écritures suivantes en CGRAM jusqu'au prochain setCursor()
+#endif
+  for (byte i = 0; i < 8; i++) { send(pattern[i], PCF_RS, _enableAll); } // CGRAM propre à chaque contrôleur
+}
+
+void LcdHd44780::endFrame() {
+  displayBusEndFrame();
+}
+
+#if INPUT_JOURNAL
+uint16_t LcdHd44780::screenChecksum() const {
+  const byte* cells = &_shadow[0][0];
+  uint16_t crc = 0xFFFF;
+  for (unsigned int i = 0; i < sizeof(_shadow); i++) crc = _crc16_update(crc, cells[i]);
+  return crc;
+}
+#endif
+
+size_t LcdHd44780::write(uint8_t value) {
+#if INPUT_JOURNAL
+  if (_col < LCD_COLS && _row < LCD_ROWS) _shadow[_row][_col++] = value; // Au-delà de la ligne : ignoré
+#endif
+  send(value, PCF_RS, _enable);
+  return 1;
+}
+
+// Instruction commune à tous les contrôleurs
+void LcdHd44780::command(byte value) {
+  send(value, 0, _enableAll);
+}
+
+// Octet complet en une transmission : quartet haut puis bas, chacun validé par un front de E.
+// À 100 kHz chaque octet I2C dure ~90 µs : largeur de E et temps d'exécution (37 µs) respectés.
+// Les octets suivants prolongent la même transmission tant que l'ISR ne l'a pas commencée.
+void LcdHd44780::send(byte value, byte mode, byte enable) {
+  byte high = (value & 0xF0) | mode | _backlight;
+  byte low = ((value << 4) & 0xF0) | mode | _backlight;
+  byte frame[4] = { (byte)(high | enable), high, (byte)(low | enable), low };
+  displayBusWrite(_address, frame, sizeof(frame), true);
+}
+
+void LcdHd44780::writeNibble(byte nibble) {
+  byte value = (nibble & 0xF0) | _backlight;
+  byte frame[2] = { (byte)(value | _enableAll), value };
+  displayBusWrite(_address, frame, sizeof(frame));
+  displayBusFlush(); // Initialisation seulement : chaque quartet est suivi d'un délai du contrôleur
+}
@@ -0,0 +1,56 @@
+// ecran_lcd.h - Backend LCD HD44780 (mode 4 bits) derrière un expandeur PCF8574 (module I2C courant)
+//
+// Câblage du module : P0=RS, P1=RW, P2=E, P3=rétroéclairage, P4..P7=D4..D7.
+// 40x4 (plus de 80 cases) : deux contrôleurs HD44780 partagent RS et D4..D7, chacun a sa broche E.
+// E1 (lignes 0 et 1) reste sur P2, E2 (lignes 2 et 3) se câble sur P1 ; RW, jamais lu, est relié
+// à la masse. setCursor() choisit le contrôleur de la ligne, les instructions communes
+// (initialisation, effacement, affichage, caractères personnalisés) partent aux deux à la fois.
+// Chaque octet part en UNE transmission de 4 octets (deux quartets, E haut puis bas) au lieu des
+// six transmissions de LiquidCrystal_I2C. Les écritures partent dans la file I2C (ecran_bus.h) :
+// endFrame() ne fait que clore le comptage de la trame.
+//
+// Avec INPUT_JOURNAL (conf.h), une copie du contenu des cases (LCD_COLS x LCD_ROWS octets) est
+// tenue à jour pour screenChecksum() : l'écran lui-même n'est jamais relu.
+#ifndef ECRAN_LCD_H
+#define ECRAN_LCD_H
+
+#include <Arduino.h>
+#include "conf.h"
+#include "ecran_bus.h"
+
+class LcdHd44780 : public Print {
+  public:
+    LcdHd44780(byte address, byte cols, byte rows);
+    void begin();
+    void clear();
+    void setCursor(byte col, byte row);
+    void backlight();
+    void noBacklight();
+    void display();
+    void noDisplay();
+    void createChar(byte slot, const byte pattern[8]);
+    void endFrame();
+#if INPUT_JOURNAL
+    uint16_t screenChecksum() const; // CRC-16 du contenu des cases (journal.h)
+#endif
+    virtual size_t write(uint8_t value);
+    using Print::write;
+  private:
+    void command(byte value);
+    void send(byte value, byte mode, byte enable);
+    void writeNibble(byte nibble); // Initialisation seulement (mode 8 bits)
+    byte _address;
+    byte _cols;
+    byte _rows;
+    byte _enableAll;       // Broches E de tous les contrôleurs (P2, et P1 sur 40x4)
+    byte _enable;          // Broche E du contrôleur de la ligne courante
+    byte _backlight;       // Bit P3 du PCF8574
+    byte _displayControl;  // Commande 0x08 | afficheur / curseur / clignotement
+#if INPUT_JOURNAL
+    byte _shadow[LCD_ROWS][LCD_COLS]; // Contenu des cases
+    byte _col;                        // Position d'écriture (_col = 0xFF : compteur en CGRAM)
+    byte _row;
+#endif
+};
+
+#endif // ECRAN_LCD_H
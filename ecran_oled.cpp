@@ -0,0 +1,323 @@
+// ecran_oled.cpp - Backend OLED SSD1306 128x64 émulant la grille de texte 20x4
+
+#include "ecran_oled.h"
+#include <util/crc16.h>
+
+// Compilé avec les deux backends (seul celui de DisplayDevice est lié) : la contrainte ne vaut qu'avec l'OLED
+static_assert(!DISPLAY_OLED || (LCD_COLS * OLED_CELL_WIDTH <= 128 && LCD_ROWS <= 4),
+              "OLED 128x64 : la grille de texte doit tenir en 21 colonnes et 4 lignes (LCD_PANEL 2004 ou 1602)");
+
+// Police 5x7, ASCII 0x20..0x7E : une colonne par octet, bit 0 en haut
+static const byte OLED_FONT_5X7[95][5] PROGMEM = {
+  { 0x00, 0x00, 0x00, 0x00, 0x00 }, // espace
+  { 0x00, 0x00, 0x5F, 0x00, 0x00 }, // !
+  { 0x00, 0x07, 0x00, 0x07, 0x00 }, // "
+  { 0x14, 0x7F, 0x14, 0x7F, 0x14 }, // #
+  { 0x24, 0x2A, 0x7F, 0x2A, 0x12 }, // $
+  { 0x23, 0x13, 0x08, 0x64, 0x62 }, // %
+  { 0x36, 0x49, 0x55, 0x22, 0x50 }, // &
+  { 0x00, 0x05, 0x03, 0x00, 0x00 }, // '
+  { 0x00, 0x1C, 0x22, 0x41, 0x00 }, // (
+  { 0x00, 0x41, 0x22, 0x1C, 0x00 }, // )
+  { 0x08, 0x2A, 0x1C, 0x2A, 0x08 }, // *
+  { 0x08, 0x08, 0x3E, 0x08, 0x08 }, // +
+  { 0x00, 0x50, 0x30, 0x00, 0x00 }, // ,
+  { 0x08, 0x08, 0x08, 0x08, 0x08 }, // -
+  { 0x00, 0x60, 0x60, 0x00, 0x00 }, // .
+  { 0x20, 0x10, 0x08, 0x04, 0x02 }, // /
+  { 0x3E, 0x51, 0x49, 0x45, 0x3E }, // 0
+  { 0x00, 0x42, 0x7F, 0x40, 0x00 }, // 1
+  { 0x42, 0x61, 0x51, 0x49, 0x46 }, // 2
+  { 0x21, 0x41, 0x45, 0x4B, 0x31 }, // 3
+  { 0x18, 0x14, 0x12, 0x7F, 0x10 }, // 4
+  { 0x27, 0x45, 0x45, 0x45, 0x39 }, // 5
+  { 0x3C, 0x4A, 0x49, 0x49, 0x30 }, // 6
+  { 0x01, 0x71, 0x09, 0x05, 0x03 }, // 7
+  { 0x36, 0x49, 0x49, 0x49, 0x36 }, // 8
+  { 0x06, 0x49, 0x49, 0x29, 0x1E }, // 9
+  { 0x00, 0x36, 0x36, 0x00, 0x00 }, // :
+  { 0x00, 0x56, 0x36, 0x00, 0x00 }, // ;
+  { 0x08, 0x14, 0x22, 0x41, 0x00 }, // <
+  { 0x14, 0x14, 0x14, 0x14, 0x14 }, // =
+  { 0x00, 0x41, 0x22, 0x14, 0x08 }, // >
+  { 0x02, 0x01, 0x51, 0x09, 0x06 }, // ?
+  { 0x32, 0x49, 0x79, 0x41, 0x3E }, // @
+  { 0x7E, 0x11, 0x11, 0x11, 0x7E }, // A
+  { 0x7F, 0x49, 0x49, 0x49, 0x36 }, // B
+  { 0x3E, 0x41, 0x41, 0x41, 0x22 }, // C
+  { 0x7F, 0x41, 0x41, 0x22, 0x1C }, // D
+  { 0x7F, 0x49, 0x49, 0x49, 0x41 }, // E
+  { 0x7F, 0x09, 0x09, 0x09, 0x01 }, // F
+  { 0x3E, 0x41, 0x49, 0x49, 0x7A }, // G
+  { 0x7F, 0x08, 0x08, 0x08, 0x7F }, // H
+  { 0x00, 0x41, 0x7F, 0x41, 0x00 }, // I
+  { 0x20, 0x40, 0x41, 0x3F, 0x01 }, // J
+  { 0x7F, 0x08, 0x14, 0x22, 0x41 }, // K
+  { 0x7F, 0x40, 0x40, 0x40, 0x40 }, // L
+  { 0x7F, 0x02, 0x0C, 0x02, 0x7F }, // M
+  { 0x7F, 0x04, 0x08, 0x10, 0x7F }, // N
+  { 0x3E, 0x41, 0x41, 0x41, 0x3E }, // O
+  { 0x7F, 0x09, 0x09, 0x09, 0x06 }, // P
+  { 0x3E, 0x41, 0x51, 0x21, 0x5E }, // Q
+  { 0x7F, 0x09, 0x19, 0x29, 0x46 }, // R
+  { 0x46, 0x49, 0x49, 0x49, 0x31 }, // S
+  { 0x01, 0x01, 0x7F, 0x01, 0x01 }, // T
+  { 0x3F, 0x40, 0x40, 0x40, 0x3F }, // U
+  { 0x1F, 0x20, 0x40, 0x20, 0x1F }, // V
+  { 0x3F, 0x40, 0x38, 0x40, 0x3F }, // W
+  { 0x63, 0x14, 0x08, 0x14, 0x63 }, // X
+  { 0x07, 0x08, 0x70, 0x08, 0x07 }, // Y
+  { 0x61, 0x51, 0x49, 0x45, 0x43 }, // Z
+  { 0x00, 0x7F, 0x41, 0x41, 0x00 }, // [
+  { 0x02, 0x04, 0x08, 0x10, 0x20 }, // antislash
+  { 0x00, 0x41, 0x41, 0x7F, 0x00 }, // ]
+  { 0x04, 0x02, 0x01, 0x02, 0x04 }, // ^
+  { 0x40, 0x40, 0x40, 0x40, 0x40 }, // _
+  { 0x00, 0x01, 0x02, 0x04, 0x00 }, // `
+  { 0x20, 0x54, 0x54, 0x54, 0x78 }, // a
+  { 0x7F, 0x48, 0x44, 0x44, 0x38 }, // b
+  { 0x38, 0x44, 0x44, 0x44, 0x20 }, // c
+  { 0x38, 0x44, 0x44, 0x48, 0x7F }, // d
+  { 0x38, 0x54, 0x54, 0x54, 0x18 }, // e
+  { 0x08, 0x7E, 0x09, 0x01, 0x02 }, // f
+  { 0x0C, 0x52, 0x52, 0x52, 0x3E }, // g
+  { 0x7F, 0x08, 0x04, 0x04, 0x78 }, // h
+  { 0x00, 0x44, 0x7D, 0x40, 0x00 }, // i
+  { 0x20, 0x40, 0x44, 0x3D, 0x00 }, // j
+  { 0x7F, 0x10, 0x28, 0x44, 0x00 }, // k
+  { 0x00, 0x41, 0x7F, 0x40, 0x00 }, // l
+  { 0x7C, 0x04, 0x18, 0x04, 0x78 }, // m
+  { 0x7C, 0x08, 0x04, 0x04, 0x78 }, // n
+  { 0x38, 0x44, 0x44, 0x44, 0x38 }, // o
+  { 0x7C, 0x14, 0x14, 0x14, 0x08 }, // p
+  { 0x08, 0x14, 0x14, 0x18, 0x7C }, // q
+  { 0x7C, 0x08, 0x04, 0x04, 0x08 }, // r
+  { 0x48, 0x54, 0x54, 0x54, 0x20 }, // s
+  { 0x04, 0x3F, 0x44, 0x40, 0x20 }, // t
+  { 0x3C, 0x40, 0x40, 0x20, 0x7C }, // u
+  { 0x1C, 0x20, 0x40, 0x20, 0x1C }, // v
+  { 0x3C, 0x40, 0x30, 0x40, 0x3C }, // w
+  { 0x44, 0x28, 0x10, 0x28, 0x44 }, // x
+  { 0x0C, 0x50, 0x50, 0x50, 0x3C }, // y
+  { 0x44, 0x64, 0x54, 0x4C, 0x44 }, // z
+  { 0x00, 0x08, 0x36, 0x41, 0x00 }, // {
+  { 0x00, 0x00, 0x7F, 0x00, 0x00 }, // |
+  { 0x00, 0x41, 0x36, 0x08, 0x00 }, // }
+  { 0x10, 0x08, 0x08, 0x10, 0x08 }, // ~
+};
+
+// Quartet -> octet, chaque bit doublé (police étirée x2 en hauteur)
+static const byte STRETCH_X2[16] PROGMEM = {
+  0x00, 0x03, 0x0C, 0x0F, 0x30, 0x33, 0x3C, 0x3F, 0xC0, 0xC3, 0xCC, 0xCF, 0xF0, 0xF3, 0xFC, 0xFF
+};
+
+// Initialisation SSD1306 128x64, pompe de charge interne, adressage horizontal
+static const byte SSD1306_INIT[] PROGMEM = {
+  0xAE,        // Écran éteint pendant la configuration
+  0xD5, 0x80,  // Horloge d'affichage
+  0xA8, 0x3F,  // 64 lignes
+  0xD3, 0x00,  // Pas de décalage vertical
+  0x40,        // Ligne de départ 0
+  0x8D, 0x14,  // Pompe de charge activée
+  0x20, 0x00,  // Adressage horizontal : les données bouclent dans la fenêtre colonne/page
+  0xA1, 0xC8,  // Orientation (colonne 127 = SEG0, balayage inversé)
+  0xDA, 0x12,  // Configuration des broches COM
+  0x81, 0xCF,  // Contraste
+  0xD9, 0xF1,  // Précharge
+  0xDB, 0x40,  // Niveau VCOMH
+  0xA4, 0xA6   // Affichage de la RAM, non inversé
+};
+
+const byte SSD1306_CONTROL_COMMAND = 0x00;
+const byte SSD1306_CONTROL_DATA = 0x40;
+const byte SSD1306_DISPLAY_OFF = 0xAE;
+const byte SSD1306_DISPLAY_ON = 0xAF;
+const byte OLED_BLANK_CELL = 0xFE;  // Code hors police : case vide
+
+OledSsd1306::OledSsd1306(byte address, byte cols, byte rows)
+  : _address(address), _col(0), _row(0), _backlight(true), _display(true) {
+  // La taille de la grille est fixée à la compilation (LCD_COLS x LCD_ROWS)
+  (void)cols; (void)rows;
+}
+
+void OledSsd1306::begin() {
+  displayBusBegin(400000UL); // SSD1306 : I2C rapide
+  byte init[sizeof(SSD1306_INIT)];
+  memcpy_P(init, SSD1306_INIT, sizeof(init));
+  commands(init, sizeof(init));
+
+  // RAM de l'écran quelconque à la mise sous tension : effacement complet, marges comprises
+  const byte fullWindow[] = { 0x21, 0, 127, 0x22, 0, 7 };
+  commands(fullWindow, sizeof(fullWindow));
+  byte zeros[DISPLAY_BUS_CHUNK + 1] = { SSD1306_CONTROL_DATA };
+  for (unsigned int sent = 0; sent < 128U * 8; sent += DISPLAY_BUS_CHUNK) {
+    byte len = min((unsigned int)DISPLAY_BUS_CHUNK, 128U * 8 - sent);
+    displayBusWrite(_address, zeros, len + 1);
+  }
+
+  memset(_cells, OLED_BLANK_CELL, sizeof(_cells));
+  memset(_glyphs, 0, sizeof(_glyphs));
+  for (byte r = 0; r < LCD_ROWS; r++) { _dirtyFrom[r] = LCD_COLS; _dirtyTo[r] = 0; }
+  applyPower();
+  endFrame();
+}
+
+// Seules les cases qui changent seront renvoyées : effacer un écran déjà presque vide ne coûte rien
+void OledSsd1306::clear() {
+  for (byte r = 0; r < LCD_ROWS; r++) {
+    for (byte c = 0; c < LCD_COLS; c++) { putCell(c, r, ' '); }
+  }
+  _col = 0; _row = 0;
+}
+
+void OledSsd1306::setCursor(byte col, byte row) {
+  _col = col;
+  _row = row < LCD_ROWS ? row : LCD_ROWS - 1;
+}
+
+// Pas de rétroéclairage sur un OLED : "éteindre le rétroéclairage" éteint l'affichage
+void OledSsd1306::backlight()   { _backlight = true;  applyPower(); }
+void OledSsd1306::noBacklight() { _backlight = false; applyPower(); }
+void OledSsd1306::display()     { _display = true;    applyPower(); }
+void OledSsd1306::noDisplay()   { _display = false;   applyPower(); }
+
+void OledSsd1306::createChar(byte slot, const byte pattern[8]) {
+  slot &= 0x07;
+  if (memcmp(_glyphs[slot], pattern, 8) == 0) return;
+  memcpy(_glyphs[slot], pattern, 8);
+  // Les cases qui affichent déjà ce caractère doivent être retramées
+  for (byte r = 0; r < LCD_ROWS; r++) {
+    for (byte c = 0; c < LCD_COLS; c++) {
+      if (_cells[r][c] == slot) {
+        if (c < _dirtyFrom[r]) _dirtyFrom[r] = c;
+        if (c > _dirtyTo[r]) _dirtyTo[r] = c;
+      }
+    }
+  }
+}
+
+void OledSsd1306::putCell(byte col, byte row, byte code) {
+  if (col >= LCD_COLS || row >= LCD_ROWS) return; // Hors grille : ignoré (le HD44780 l'écrirait hors écran)
+  if (_cells[row][col] == code) return;
+  _cells[row][col] = code;
+  if (col < _dirtyFrom[row]) _dirtyFrom[row] = col;
+  if (col > _dirtyTo[row]) _dirtyTo[row] = col;
+}
+
+uint16_t OledSsd1306::screenChecksum() const {
+  const byte* cells = &_cells[0][0];
+  uint16_t crc = 0xFFFF;
+  for (unsigned int i = 0; i < sizeof(_cells); i++) crc = _crc16_update(crc, cells[i]);
+  return crc;
+}
+
+size_t OledSsd1306::write(uint8_t value) {
+  putCell(_col, _row, value);
+  if (_col < LCD_COLS) _col++;
+  return 1;
+}
+
+void OledSsd1306::endFrame() {
+  for (byte r = 0; r < LCD_ROWS; r++) { flushRow(r); }
+  displayBusEndFrame();
+}
+
+void OledSsd1306::commands(const byte* list, byte len) {
+  byte frame[DISPLAY_BUS_CHUNK + 1];
+  frame[0] = SSD1306_CONTROL_COMMAND;
+  while (len > 0) {
+    byte n = min(len, DISPLAY_BUS_CHUNK);
+    memcpy(frame + 1, list, n);
+    displayBusWrite(_address, frame, n + 1);
+    list += n; len -= n;
+  }
+}
+
+void OledSsd1306::applyPower() {
+  byte cmd = (_backlight && _display) ? SSD1306_DISPLAY_ON : SSD1306_DISPLAY_OFF;
+  commands(&cmd, 1);
+}
+
+// Envoie la plage sale d'une ligne de texte : deux pages de 8 pixels, fenêtre limitée aux colonnes modifiées
+void OledSsd1306::flushRow(byte row) {
+  byte from = _dirtyFrom[row];
+  byte to = _dirtyTo[row];
+  if (from > to) return;
+  _dirtyFrom[row] = LCD_COLS; _dirtyTo[row] = 0;
+
+  byte x0 = OLED_X_OFFSET + from * OLED_CELL_WIDTH;
+  byte x1 = OLED_X_OFFSET + (to + 1) * OLED_CELL_WIDTH - 1;
+  for (byte pageInRow = 0; pageInRow < 2; pageInRow++) {
+    byte page = row * 2 + pageInRow;
+    const byte window[] = { 0x21, x0, x1, 0x22, page, page };
+    commands(window, sizeof(window));
+
+    byte frame[DISPLAY_BUS_CHUNK + 1];
+    frame[0] = SSD1306_CONTROL_DATA;
+    byte n = 0;
+    for (byte c = from; c <= to; c++) {
+      byte code = _cells[row][c];
+      for (byte x = 0; x < OLED_CELL_WIDTH; x++) {
+        frame[1 + n++] = cellColumn(code, x, pageInRow);
+        if (n == DISPLAY_BUS_CHUNK) { displayBusWrite(_address, frame, n + 1); n = 0; }
+      }
+    }
+    if (n > 0) displayBusWrite(_address, frame, n + 1);
+  }
+}
+
+// Colonne de 8 pixels (bit 0 en haut) de la colonne x d'une case, moitié haute ou basse
+byte OledSsd1306::cellColumn(byte code, byte x, byte pageInRow) const {
+  if (code >= OLED_BIG_DIGIT_CODE && code < OLED_BIG_DIGIT_CODE + 60) {
+    // Grand chiffre : bloc de 3x2 cases (18x32 pixels), glyphe 5x7 agrandi x3 / x4, marges 1 px / 2 px
+    byte part = code - OLED_BIG_DIGIT_CODE;
+    byte digit = part / 6;
+    part %= 6;
+    byte blockX = (part % 3) * OLED_CELL_WIDTH + x;
+    if (blockX < 1 || blockX > 15) return 0;
+    byte glyph = pgm_read_byte(&OLED_FONT_5X7['0' - 0x20 + digit][(blockX - 1) / 3]);
+    byte blockY = (part / 3) * 16 + pageInRow * 8;
+    byte column = 0;
+    for (byte bit = 0; bit < 8; bit++, blockY++) {
+      if (blockY >= 2 && blockY < 30 && (glyph >> ((blockY - 2) / 4)) & 1) column |= 1 << bit;
+    }
+    return column;
+  }
+
+  byte glyph = 0;
+  if (x >= 5) {
+    glyph = 0; // Espacement entre caractères
+  } else if (code < 8) {
+    // Caractère personnalisé : 8 lignes de 5 bits (bit 4 à gauche), transposées en colonne
+    for (byte r = 0; r < 8; r++) {
+      if ((_glyphs[code][r] >> (4 - x)) & 1) glyph |= 1 << r;
+    }
+  } else if (code >= 0x20 && code <= 0x7E) {
+    glyph = pgm_read_byte(&OLED_FONT_5X7[code - 0x20][x]);
+  } else if (code == PROGRESS_FULL_CHAR) {
+    glyph = 0xFF; // Pavé plein de la ROM HD44780 (barre de progression)
+  }
+  return pgm_read_byte(&STRETCH_X2[pageInRow ? glyph >> 4 : glyph & 0x0F]);
+}
+
+// --- Grands chiffres ---
+
+// Seul le caractère 1 (barre haute) sert en dehors des chiffres : marqueur de temps du métronome
+static byte upperBarGlyph[8] = { B11111, B11111, B11111, B00000, B00000, B00000, B00000, B00000 };
+
+OledBigNumbers::OledBigNumbers(OledSsd1306* oled) : _oled(oled) {}
+
+void OledBigNumbers::begin() {
+  _oled->createChar(1, upperBarGlyph);
+}
+
+void OledBigNumbers::clearLargeNumber(byte x, byte y) {
+  for (byte part = 0; part < 6; part++) { _oled->putCell(x + part % 3, y + part / 3, ' '); }
+}
+
+void OledBigNumbers::displayLargeNumber(byte n, byte x, byte y) {
+  if (n > 9) return;
+  for (byte part = 0; part < 6; part++) {
+    _oled->putCell(x + part % 3, y + part / 3, OLED_BIG_DIGIT_CODE + n * 6 + part);
+  }
+}
@@ -0,0 +1,66 @@
+// ecran_oled.h - Backend OLED SSD1306 128x64 (I2C) émulant la grille de texte 20x4
+//
+// Un framebuffer bitmap complet (1 Ko) ne tient pas à côté du sketch dans les 2 Ko du Nano : le
+// tampon garde donc le CONTENU de chaque case (80 octets) et chaque page de 8 pixels est
+// tramée à la volée au moment de l'envoi. Une ligne de texte couvre deux pages (cases de
+// 6x16 pixels, police 5x7 étirée en hauteur) ; seules les cases modifiées depuis la dernière
+// trame sont renvoyées (plage de colonnes sale par ligne). Rien ne part sur le bus avant
+// endFrame(), appelée par serviceDisplay() à chaque passe de loop().
+//
+// Les grands chiffres (OledBigNumbers) occupent 3x2 cases, comme BigNumbers_I2C, et sont tracés
+// depuis la même police 5x7 agrandie (x3 en largeur, x4 en hauteur).
+#ifndef ECRAN_OLED_H
+#define ECRAN_OLED_H
+
+#include <Arduino.h>
+#include "conf.h"
+#include "ecran_bus.h"
+
+const byte OLED_CELL_WIDTH = 6;                                     // Pixels par colonne de texte
+const byte OLED_X_OFFSET = LCD_COLS * OLED_CELL_WIDTH < 128 ? (128 - LCD_COLS * OLED_CELL_WIDTH) / 2 : 0; // Grille centrée
+const byte OLED_BIG_DIGIT_CODE = 0x80;                              // Cases 0x80 + chiffre*6 + partie
+
+class OledSsd1306 : public Print {
+  public:
+    OledSsd1306(byte address, byte cols, byte rows);
+    void begin();
+    void clear();
+    void setCursor(byte col, byte row);
+    void backlight();
+    void noBacklight();
+    void display();
+    void noDisplay();
+    void createChar(byte slot, const byte pattern[8]);
+    void endFrame();                              // Envoie les cases modifiées puis clôt la trame
+    void putCell(byte col, byte row, byte code);  // Écrit une case sans déplacer le curseur
+    uint16_t screenChecksum() const;              // CRC-16 du contenu des cases (journal.h)
+    virtual size_t write(uint8_t value);
+    using Print::write;
+  private:
+    void commands(const byte* list, byte len);
+    void applyPower();
+    void flushRow(byte row);
+    byte cellColumn(byte code, byte x, byte pageInRow) const;
+    byte _address;
+    byte _col;
+    byte _row;
+    bool _backlight;
+    bool _display;
+    byte _cells[LCD_ROWS][LCD_COLS];
+    byte _glyphs[8][8];           // Caractères personnalisés (createChar), lignes de 5 bits
+    byte _dirtyFrom[LCD_ROWS];    // Plage de colonnes à renvoyer (from > to : ligne propre)
+    byte _dirtyTo[LCD_ROWS];
+};
+
+// Même interface que BigNumbers_I2C
+class OledBigNumbers {
+  public:
+    OledBigNumbers(OledSsd1306* oled);
+    void begin();
+    void clearLargeNumber(byte x, byte y);
+    void displayLargeNumber(byte n, byte x, byte y);
+  private:
+    OledSsd1306* _oled;
+};
+
+#endif // ECRAN_OLED_H
@@ -0,0 +1,95 @@
+// geometrie.h - Disposition de l'écran, résolue à la compilation pour le panneau choisi (LCD_PANEL, conf.h)
+//
+// Toutes les positions sont des constantes déduites de LCD_COLS / LCD_ROWS : la disposition est
+// spécialisée à chaque compilation, sans aucun calcul de géométrie à l'exécution. Les tests
+// "if (LCD_TALL)" portent sur des constantes et sont éliminés par le compilateur.
+//
+// Panneaux prévus :
+//  - 20x4 : disposition de référence (statut / grands chiffres / infos).
+//  - 40x4 : même disposition, blocs centrés. Ces modules ont deux contrôleurs HD44780 (deux
+//           broches E) : ecran_lcd pilote le second (lignes 2 et 3) par P1 du PCF8574 (ecran_lcd.h).
+//  - 16x2 : grands chiffres sur les deux lignes, statut abrégé à droite, pas de ligne d'infos ;
+//           les menus affichent une option à la fois.
+#ifndef GEOMETRIE_H
+#define GEOMETRIE_H
+
+#include <Arduino.h>
+#include "conf.h"
+
+static_assert((LCD_COLS == 16 && LCD_ROWS == 2) || (LCD_COLS == 20 && LCD_ROWS == 4) || (LCD_COLS == 40 && LCD_ROWS == 4),
+              "LCD_PANEL : panneaux pris en charge 1602, 2004 et 4004");
+
+// Longueur d'une chaîne littérale, connue à la compilation (remplace strlen("..."))
+template <size_t N>
+constexpr byte textLen(const char (&)[N]) { return N - 1; }
+
+// Colonne de départ pour centrer 'len' caractères (0 si le texte est plus large que l'écran)
+constexpr byte centeredCol(byte len) { return len >= LCD_COLS ? 0 : (LCD_COLS - len) / 2; }
+
+const bool LCD_TALL = LCD_ROWS >= 4;  // Une ligne de statut au-dessus et une ligne d'infos sous les grands chiffres
+
+// --- Menus : titre sur la ligne 0, options en dessous, flèches de défilement dans la dernière colonne ---
+const byte MENU_FIRST_ROW = 1;
+const byte MENU_LINES = LCD_ROWS - 1;      // Fenêtre de défilement (options visibles)
+const byte MENU_ARROW_COL = LCD_COLS - 1;
+
+// Messages plein écran (démarrage, veille) : deux lignes centrées verticalement
+const byte MESSAGE_ROW = LCD_TALL ? 1 : 0;
+
+// --- Minuteur : MM.SS en grands chiffres (4 x 3 colonnes + séparateur) suivi de ".CS", centré ---
+const byte CLOCK_WIDTH = 16;
+const byte BIG_NUM_ROW = LCD_TALL ? 1 : 0;                 // Ligne supérieure des grands chiffres
+const byte BIG_M1_COL = (LCD_COLS - CLOCK_WIDTH) / 2;      // Colonne début Dizaines Minutes
+const byte BIG_M2_COL = BIG_M1_COL + 3;                    // Colonne début Unités Minutes
+const byte COLON_COL = BIG_M2_COL + 3;                     // Colonne du séparateur ":" ou "."
+const byte BIG_S1_COL = COLON_COL + 1;                     // Colonne début Dizaines Secondes
+const byte BIG_S2_COL = BIG_S1_COL + 3;                    // Colonne début Unités Secondes
+const byte CS_ROW = BIG_NUM_ROW + 1;                       // Ligne d'affichage des centisecondes
+const byte CS_COL = BIG_S2_COL + 3;                        // Colonne de départ pour ".CS"
+const byte STATUS_ROW = 0;
+const byte STATUS_COL_START = LCD_TALL ? 0 : CS_COL;       // 16x2 : statut abrégé au-dessus des centisecondes
+const byte MELODY_NAME_ROW = LCD_ROWS - 1;                 // Ligne d'infos (mélodie | preset), 4 lignes seulement
+const byte MELODY_NAME_COL = 1;                            // Colonne de départ pour icône + nom
+const byte PROGRESS_CELLS = LCD_TALL ? 20 : 0;             // Barre de progression (0 = pas de barre sur 16x2)
+const byte PROGRESS_ROW = MELODY_NAME_ROW;                 // Remplace la ligne d'infos pendant un décompte
+const byte PROGRESS_COL = centeredCol(PROGRESS_CELLS);
+
+// --- Métronome : BPM en grands chiffres (3 x 3 colonnes) ---
+const byte METRO_STATUS_ROW = 0;                           // "METRO RUN/STOP", 4 lignes seulement
+const byte METRO_STATUS_COL = 0;
+const byte METRO_BPM_BIG_NUM_ROW = LCD_TALL ? 1 : 0;
+const byte METRO_BPM_BIG_NUM_COL = LCD_TALL ? (LCD_COLS - 8) / 2 : 0;
+const byte METRO_BPM_LABEL_ROW = METRO_BPM_BIG_NUM_ROW + 1; // Texte "BPM", 4 lignes seulement
+const byte METRO_BPM_LABEL_COL = METRO_BPM_BIG_NUM_COL + 10;
+const byte METRO_TS_ROW = 0;
+const byte METRO_TS_COL = LCD_COLS - 7;                    // "TS:16/8" au plus
+const byte METRO_SYNC_COL = METRO_STATUS_COL + 11;         // Repère de synchro MIDI après "METRO STOP", 4 lignes seulement
+const byte METRO_BEAT_VISUAL_ROW = LCD_ROWS - 1;           // Marqueurs de temps (+ nom du tempo)
+const byte METRO_BEAT_MARKER_START_COL = LCD_TALL ? 1 : METRO_BPM_BIG_NUM_COL + 10; // 16x2 : à droite du BPM
+
+// --- Pratique : reste de la séance (grands chiffres MM.SS sur 4 lignes), BPM, marqueurs de temps ---
+const byte PRACTICE_STATE_ROW = LCD_TALL ? 0 : 1;            // "Marche", "Pause"... (6 caractères)
+const byte PRACTICE_STATE_COL = 0;
+const byte PRACTICE_TS_COL = 8;                              // "16/8" au plus, 4 lignes seulement
+const byte PRACTICE_BPM_ROW = 0;
+const byte PRACTICE_BPM_COL = LCD_COLS - 6;                  // "120BPM"
+const byte PRACTICE_TIME_ROW = 0;                            // 16x2 : "MM:SS" en petits chiffres
+const byte PRACTICE_TIME_COL = 0;
+
+// --- Presets : liste "NOM      MM:SS", éditeur avec repère du champ sous la ligne éditée ---
+const byte PRESET_MENU_TIME_COL = 1 + PRESET_NAME_LEN + 1;  // Après le curseur ">" et le nom
+const byte PRESET_EDIT_ROW = LCD_TALL ? 1 : 0;
+const byte PRESET_EDIT_TIME_COL = PRESET_NAME_LEN + 1;
+const byte PRESET_EDIT_MARK_ROW = PRESET_EDIT_ROW + 1;
+const byte PRESET_EDIT_ACTION_ROW = LCD_TALL ? PRESET_EDIT_ROW + 2 : PRESET_EDIT_MARK_ROW; // 16x2 : partagée avec le repère
+
+static_assert(PROGRESS_COL + PROGRESS_CELLS <= LCD_COLS, "La barre de progression dépasse de l'écran");
+static_assert(PROGRESS_CELLS * PROGRESS_COLS_PER_CELL <= 250, "Positions de la barre de progression : un octet");
+static_assert(!LCD_TALL || PRACTICE_TS_COL + 4 < PRACTICE_BPM_COL, "La signature chevauche le BPM (Pratique)");
+static_assert(LCD_TALL || (PRACTICE_TIME_COL + 5 < PRACTICE_BPM_COL && PRACTICE_STATE_COL + 6 < METRO_BEAT_MARKER_START_COL),
+              "Disposition de la Pratique sur 2 lignes");
+static_assert(PRESET_MENU_TIME_COL + 5 <= MENU_ARROW_COL, "La durée des presets chevauche les flèches du menu");
+static_assert(!LCD_TALL || METRO_SYNC_COL < METRO_TS_COL, "Le repère de synchro MIDI chevauche la signature");
+static_assert(LCD_TALL || METRO_BPM_BIG_NUM_COL + 9 <= METRO_TS_COL, "Les grands chiffres du BPM chevauchent la signature");
+
+#endif // GEOMETRIE_H
@@ -0,0 +1,213 @@
+// journal.cpp - Anneau des entrées, trame de la console, rejeu depuis l'EEPROM, empreinte de l'état
+
+#include "journal.h"
+
+#if INPUT_JOURNAL
+
+#include "rapport.h"
+#include "ecran.h"
+#include "timer.h"     // Mode, état du minuteur, temps cible
+#include "metronome.h" // État du métronome, BPM, signature
+#include <util/crc16.h>
+
+static_assert(EEPROM_ADDR_JOURNAL > EEPROM_ADDR_BENCH_SCRATCH, "Journal après l'octet de mesure du banc");
+static_assert(EEPROM_ADDR_JOURNAL + 1 + sizeof(JournalBlob) <= 1024, "Le journal dépasse l'EEPROM du Nano (1 Ko)");
+static_assert(JOURNAL_ENTRIES <= 255, "JournalHeader::count tient sur un octet");
+
+static const byte CODE_BUTTON = 0x80;
+static const int MAX_DELTA = 63;      // Crans signés sur 7 bits
+
+JournalBlob journalBlob;
+
+static bool recording = false;        // Entre journalBegin() et une trame REJOUER
+static bool replaying = false;
+static byte head = 0;                 // Entrée la plus ancienne de l'anneau
+static byte replayIndex = 0;          // Prochaine entrée à rejouer
+static unsigned long startMs = 0;     // millis() de journalBegin()
+static unsigned long lastMs = 0;      // Instant de l'entrée précédente (enregistrée ou rejouée)
+
+static uint16_t crcOf(uint16_t crc, const void* data, unsigned int len) {
+  const byte* bytes = (const byte*)data;
+  for (unsigned int i = 0; i < len; i++) crc = _crc16_update(crc, bytes[i]);
+  return crc;
+}
+
+static uint16_t fingerprint() {
+  byte state[] = { (byte)currentMode, (byte)currentTimerState, (byte)currentMetroState,
+                   (byte)targetTotalSeconds, (byte)(targetTotalSeconds >> 8),
+                   (byte)currentBPM, (byte)(currentBPM >> 8), timeSignatureNum, timeSignatureDen };
+  uint16_t crc = crcOf(0xFFFF, state, sizeof(state));
+  crc = crcOf(crc, &settings, sizeof(settings));
+  uint16_t screen = LCD.screenChecksum();
+  return crcOf(crc, &screen, sizeof(screen));
+}
+
+// --- Enregistrement ---
+
+static void push(uint16_t dtMs, byte code) {
+  JournalHeader& h = journalBlob.header;
+  if (h.count < JOURNAL_ENTRIES) {
+    journalBlob.entries[(head + h.count) % JOURNAL_ENTRIES] = { dtMs, code };
+    h.count++;
+  } else {
+    journalBlob.entries[head] = { dtMs, code }; // Le plus ancien est écrasé
+    head = (head + 1) % JOURNAL_ENTRIES;
+    h.flags |= JOURNAL_TRUNCATED;
+  }
+}
+
+static void record(byte code) {
+  if (!recording) return;
+  unsigned long now = millis();
+  unsigned long dt = now - lastMs;
+  for (; dt > 0xFFFF; dt -= 0xFFFF) push(0xFFFF, 0); // Attentes de plus d'une minute
+  push(dt, code);
+  lastMs = now;
+}
+
+void journalEncoder(int delta) {
+  for (; delta > MAX_DELTA; delta -= MAX_DELTA) record(MAX_DELTA);
+  for (; delta < -MAX_DELTA; delta += MAX_DELTA) record((byte)-MAX_DELTA & 0x7F);
+  if (delta != 0) record((byte)delta & 0x7F);
+}
+
+void journalButton(ButtonEvent event) {
+  record(CODE_BUTTON | event);
+}
+
+// --- Rejeu ---
+
+void journalSetup() {
+  if (EEPROM.read(EEPROM_ADDR_JOURNAL) != JOURNAL_MAGIC) return;
+  eepromWriteBegin();
+  EEPROM.update(EEPROM_ADDR_JOURNAL, 0xFF); // Un seul rejeu, même si celui-ci n'aboutit pas
+  eepromWriteEnd();
+  byte* bytes = (byte*)&journalBlob;
+  int address = EEPROM_ADDR_JOURNAL + 1;
+  for (unsigned int i = 0; i < sizeof(JournalHeader); i++) bytes[i] = EEPROM.read(address++);
+  if (journalBlob.header.count > JOURNAL_ENTRIES) { Report.println(F("Rejeu: journal invalide")); return; }
+  unsigned int length = sizeof(JournalHeader) + journalBlob.header.count * sizeof(JournalEntry);
+  for (unsigned int i = sizeof(JournalHeader); i < length; i++) bytes[i] = EEPROM.read(address++);
+  uint16_t crc;
+  EEPROM.get(address, crc);
+  if (crc != crcOf(0xFFFF, bytes, length)) { Report.println(F("Rejeu: journal invalide")); return; }
+  settings = journalBlob.header.settings; // Relus par les setup...() comme au démarrage enregistré
+  head = 0;
+  replayIndex = 0;
+  replaying = true;
+  Report.print(F("Rejeu de ")); Report.print(journalBlob.header.count); Report.println(F(" entrees"));
+}
+
+void journalBegin() {
+  startMs = millis();
+  lastMs = startMs;
+  if (replaying) return;
+  JournalHeader& h = journalBlob.header;
+  h.settings = settings;
+  h.count = 0;
+  h.flags = 0;
+  head = 0;
+  recording = true;
+}
+
+bool journalReplaying() {
+  return replaying;
+}
+
+// Entrée suivante due, attentes seules franchies
+static const JournalEntry* dueEntry() {
+  if (!replaying) return nullptr;
+  while (replayIndex < journalBlob.header.count) {
+    const JournalEntry& entry = journalBlob.entries[replayIndex];
+    if (millis() - lastMs < entry.dtMs) return nullptr;
+    if (entry.code != 0) return &entry;
+    lastMs += entry.dtMs;
+    replayIndex++;
+  }
+  return nullptr;
+}
+
+static void consume(const JournalEntry* entry) {
+  lastMs += entry->dtMs; // Échéances cumulées : pas de dérive due aux passes
+  replayIndex++;
+}
+
+bool journalReplayDue() {
+  return dueEntry() != nullptr;
+}
+
+int journalReplayEncoder() {
+  const JournalEntry* entry = dueEntry();
+  if (entry == nullptr || (entry->code & CODE_BUTTON)) return 0;
+  int delta = (int8_t)(entry->code << 1) >> 1; // Extension du signe des 7 bits
+  consume(entry);
+  return delta;
+}
+
+ButtonEvent journalReplayButton() {
+  const JournalEntry* entry = dueEntry();
+  if (entry == nullptr || !(entry->code & CODE_BUTTON)) return BTN_NONE;
+  ButtonEvent event = (ButtonEvent)(entry->code & ~CODE_BUTTON);
+  consume(entry);
+  return event;
+}
+
+void serviceJournal() {
+  if (!replaying || replayIndex < journalBlob.header.count) return;
+  if (millis() - startMs < journalBlob.header.durationMs) return;
+  replaying = false;
+  uint16_t state = fingerprint();
+  Report.print(F("Rejeu ETAT="));  Report.print(state, HEX);
+  Report.print(F(" attendu="));    Report.print(journalBlob.header.fingerprint, HEX);
+  Report.println(state == journalBlob.header.fingerprint ? F(" identique") : F(" ECART"));
+}
+
+// --- Console ---
+
+static void printHex(const void* data, unsigned int len) {
+  const byte* bytes = (const byte*)data;
+  for (unsigned int i = 0; i < len; i++) {
+    if (bytes[i] < 0x10) Report.print('0');
+    Report.print(bytes[i], HEX);
+  }
+}
+
+void journalDump(unsigned int bytes) {
+  if (bytes != 0) { Report.println(F("ERR format")); return; }
+  JournalHeader& h = journalBlob.header;
+  h.format = JOURNAL_FORMAT;
+  h.settingsVersion = SETTINGS_VERSION;
+  h.durationMs = millis() - startMs;
+  h.fingerprint = fingerprint();
+  Report.print(F("JOURNAL "));
+  printHex(&h, sizeof(h));
+  uint16_t crc = crcOf(0xFFFF, &h, sizeof(h));
+  for (byte i = 0; i < h.count; i++) { // Dans l'ordre, du plus ancien au plus récent
+    const JournalEntry& entry = journalBlob.entries[(head + i) % JOURNAL_ENTRIES];
+    printHex(&entry, sizeof(entry));
+    crc = crcOf(crc, &entry, sizeof(entry));
+  }
+  printHex(&crc, sizeof(crc));
+  Report.println();
+}
+
+// La trame a été reçue dans journalBlob : l'enregistrement en cours est perdu
+void journalImport(unsigned int bytes) {
+  const JournalHeader& h = journalBlob.header;
+  byte* data = (byte*)&journalBlob;
+  unsigned int length = sizeof(JournalHeader) + h.count * sizeof(JournalEntry);
+  recording = false;
+  head = 0;
+  if (bytes < sizeof(JournalHeader) || h.count > JOURNAL_ENTRIES || bytes != length + 2) { Report.println(F("ERR format")); return; }
+  if ((data[length] | data[length + 1] << 8) != crcOf(0xFFFF, data, length)) { Report.println(F("ERR crc")); return; }
+  if (h.format != JOURNAL_FORMAT || h.settingsVersion != SETTINGS_VERSION) { Report.println(F("ERR version")); return; }
+  if (h.flags & JOURNAL_TRUNCATED) { Report.println(F("ERR tronque")); return; }
+  if (currentTimerState != STATE_IDLE || currentMetroState != METRO_STOPPED) { Report.println(F("ERR occupe")); return; }
+  eepromWriteBegin();
+  for (unsigned int i = 0; i < bytes; i++) EEPROM.update(EEPROM_ADDR_JOURNAL + 1 + i, data[i]);
+  EEPROM.update(EEPROM_ADDR_JOURNAL, JOURNAL_MAGIC); // En dernier : une trame coupée n'est pas armée
+  eepromWriteEnd();
+  Report.println(F("OK"));
+}
+
+#endif // INPUT_JOURNAL
@@ -0,0 +1,88 @@
+// journal.h - Journal des entrées (encodeur, bouton) et rejeu déterministe, INPUT_JOURNAL
+//
+// Tel que handleEncoder() / handleButton() les voient, chaque cran (somme des crans d'une passe)
+// et chaque geste du bouton entre dans un anneau de JOURNAL_ENTRIES entrées de 3 octets : délai
+// depuis l'entrée précédente (ms) et code. Code 0 = attente seule (délai plafonné à 65535 ms),
+// bit 7 = geste (ButtonEvent dans les bits bas), sinon crans signés sur 7 bits (-63..63).
+// Le temps part de journalBegin(), à la fin de setup() ; les réglages de ce moment sont gardés.
+//
+// Console série (reglages.h) :
+//   "JOURNAL"         -> "JOURNAL <hex>" : format, réglages du départ, durée, empreinte de l'état
+//                        actuel, nombre d'entrées, entrées dans l'ordre, CRC-16
+//   "REJOUER <hex>"   -> "OK" (rejeu armé en EEPROM), ou "ERR crc" / "ERR version" / "ERR tronque"
+//                        / "ERR occupe" / "ERR format". Le journal en cours est abandonné.
+// Au démarrage suivant, les réglages du journal remplacent ceux de l'unité, puis encodeur et
+// bouton physiques sont ignorés : les entrées sont rejouées à leur milliseconde (à la passe de
+// loop() près). À la durée enregistrée, l'empreinte recalculée est comparée à celle du journal :
+//   "Rejeu ETAT=xxxx attendu=yyyy identique" (ou "ECART").
+// Empreinte = CRC-16 du mode, des états du minuteur et du métronome, du temps cible, du BPM, de la
+// signature, des réglages et du contenu de l'écran (screenChecksum(), ecran.h).
+//
+// Limites : la bibliothèque de presets et les points de reprise (checkpoint.h) ne font pas partie
+// du journal, l'unité de rejeu doit avoir les mêmes. Un journal dont le début a été écrasé est
+// refusé. Les tours du chrono sont datés à l'injection, pas au front d'origine. Sur un écran qui
+// défile (centièmes d'un décompte en cours), l'empreinte n'est comparable qu'à la passe près :
+// vider le journal à l'arrêt. tools/journal.py décode, envoie et relance le rejeu.
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <Arduino.h>
+#include "conf.h"
+#include "bouton.h"
+#include "reglages.h"
+
+#if INPUT_JOURNAL
+
+struct JournalEntry {
+  uint16_t dtMs;           // Depuis l'entrée précédente (la première : depuis journalBegin())
+  byte code;               // 0 = attente, 0x80 | ButtonEvent, sinon crans (int8_t)
+};
+
+// Trame JOURNAL / REJOUER et copie EEPROM : en-tête, count entrées, puis le CRC-16 de l'ensemble
+struct JournalHeader {
+  byte format;             // JOURNAL_FORMAT
+  byte settingsVersion;    // SETTINGS_VERSION de l'unité enregistrée
+  Settings settings;       // Réglages à journalBegin()
+  uint32_t durationMs;     // Instant de l'empreinte, depuis journalBegin()
+  uint16_t fingerprint;    // Empreinte de l'état à cet instant
+  byte flags;              // JOURNAL_TRUNCATED
+  byte count;              // Entrées (JOURNAL_ENTRIES au plus)
+};
+const byte JOURNAL_TRUNCATED = 0x01; // Des entrées ont été écrasées : rejeu impossible
+
+struct JournalBlob {
+  JournalHeader header;
+  JournalEntry entries[JOURNAL_ENTRIES]; // Anneau pendant l'enregistrement
+  uint16_t crc;                          // Place du CRC d'une trame pleine (reçue : juste après la dernière entrée)
+};
+extern JournalBlob journalBlob;          // Reçoit aussi la trame REJOUER (reglages.cpp)
+
+void journalSetup();             // Après loadSettings() : rejeu armé -> réglages du journal
+void journalBegin();             // Fin de setup() : origine des temps, réglages du départ
+void journalEncoder(int delta);  // Crans d'une passe, tels que modeEncoder() les reçoit
+void journalButton(ButtonEvent event);
+bool journalReplaying();         // Entrées physiques ignorées
+bool journalReplayDue();         // Une entrée rejouée est due (ferme l'écran de démarrage)
+int journalReplayEncoder();      // Crans dus, 0 sinon
+ButtonEvent journalReplayButton(); // Geste dû, BTN_NONE sinon
+void serviceJournal();           // Fin du rejeu et comparaison, à chaque passe de loop()
+
+// Commandes de la console (reglages.cpp) : bytes = octets reçus après la commande
+void journalDump(unsigned int bytes);
+void journalImport(unsigned int bytes);
+
+#else
+
+inline void journalSetup() {}
+inline void journalBegin() {}
+inline void journalEncoder(int) {}
+inline void journalButton(ButtonEvent) {}
+inline bool journalReplaying() { return false; }
+inline bool journalReplayDue() { return false; }
+inline int journalReplayEncoder() { return 0; }
+inline ButtonEvent journalReplayButton() { return BTN_NONE; }
+inline void serviceJournal() {}
+
+#endif // INPUT_JOURNAL
+
+#endif // JOURNAL_H
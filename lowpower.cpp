@@ -0,0 +1,200 @@
+// lowpower.cpp - Décompte en basse consommation (veille profonde + chien de garde)
+
+#include "lowpower.h"
+#include "rapport.h"
+#include <avr/sleep.h>
+#include <avr/wdt.h>
+#include <util/atomic.h>
+#include "timer.h"
+#include "sorties.h"
+
+extern "C" volatile unsigned long timer0_millis;         // Compteur de millis() (wiring.c)
+extern "C" volatile unsigned long timer0_overflow_count; // Base de micros() : un débordement = 1024 µs à 16 MHz
+extern unsigned long lastActivityTime;
+
+LowPowerStats lowPowerStats = {0, 0, 0, false};
+
+// Réveil par l'encodeur, CLK D2 (PCINT18) et DT D4 (PCINT20) ; le bouton (PCINT22) est toujours armé (bouton.h)
+static const byte WAKE_PCINT_MASK = _BV(PCINT18) | _BV(PCINT20);
+// Le compteur du WDT est illisible et Timer0 est arrêté en power-down : après un réveil par une
+// entrée, la part dormie n'est connue qu'au débordement suivant. Les périodes sont donc bornées
+// à ~256 ms (retard de millis() après le rallumage) ; un réveil de plus par période coûte ~10 µA,
+// devant ~1,3 mA.
+static const byte WDT_MAX_STEP = 4;   // 16 ms << 4 = ~256 ms
+static const byte WDT_MIN_STEP = 4;   // En dessous, rester éveillé ne coûte rien
+static const byte WDT_NO_STEP = 0xFF;
+
+static volatile bool wdtFired = false;
+static unsigned long wdtMicrosPerTick = 16000; // Période de base (16 ms nominal) mesurée
+static unsigned int millisRemainder = 0;       // µs dormies pas encore comptées dans millis()
+static unsigned int microsRemainder = 0;       // µs dormies pas encore comptées dans micros()
+static bool calibrated = false;                // wdtMicrosPerTick mesuré pour ce décompte
+static bool creditPending = false;             // Réveil par une entrée : période WDT en cours à créditer
+static unsigned long pendingPeriodMicros = 0;  // Durée de cette période
+static unsigned long pendingWakeMicros = 0;    // micros() au réveil
+
+ISR(WDT_vect) {
+  wdtFired = true; // Mode interruption seule (WDE = 0) : pas de reset
+}
+
+static void startWatchdog(byte step) {
+  byte prescaler = (step & 0x07) | ((step & 0x08) ? _BV(WDP3) : 0);
+  wdtFired = false;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    wdt_reset();
+    MCUSR &= ~_BV(WDRF);
+    WDTCSR = _BV(WDCE) | _BV(WDE);  // Séquence temporisée de modification
+    WDTCSR = _BV(WDIE) | prescaler;
+  }
+}
+
+static void stopWatchdog() {
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    wdt_reset();
+    WDTCSR = _BV(WDCE) | _BV(WDE);
+    WDTCSR = 0;
+  }
+}
+
+static unsigned long stepMicros(byte step) {
+  return wdtMicrosPerTick << step;
+}
+
+static unsigned long stepMillis(byte step) {
+  return stepMicros(step) / 1000;
+}
+
+// Durée dormie créditée à millis() et à micros(), restes reportés : les deux horloges restent alignées
+static void addSleepMicros(unsigned long us) {
+  unsigned long ms = (us + millisRemainder) / 1000;
+  millisRemainder = (us + millisRemainder) % 1000;
+  unsigned long overflows = (us + microsRemainder) / 1024;
+  microsRemainder = (us + microsRemainder) % 1024;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    timer0_millis += ms;
+    timer0_overflow_count += overflows;
+  }
+  lowPowerStats.sleepMillis += ms;
+}
+
+// Mesure la période réelle de l'oscillateur du WDT (varie avec la tension et la température)
+static void calibrateWatchdog() {
+  startWatchdog(0);
+  while (!wdtFired) {}              // Se caler sur un premier débordement
+  unsigned long start = micros();
+  for (byte i = 0; i < WDT_CALIBRATION_TICKS; i++) {
+    wdtFired = false;
+    while (!wdtFired) {}
+  }
+  wdtMicrosPerTick = (micros() - start) / WDT_CALIBRATION_TICKS;
+  stopWatchdog();
+}
+
+// Plus longue période WDT qui se termine avant la marge de fin de décompte
+static byte choosePeriod(long budgetMillis) {
+  for (byte step = WDT_MAX_STEP; step >= WDT_MIN_STEP; step--) {
+    if ((long)stepMillis(step) <= budgetMillis) return step;
+  }
+  return WDT_NO_STEP;
+}
+
+static long millisToDeadline() {
+  return (long)(modeState.timer.targetEndTime - millis());
+}
+
+bool serviceLowPowerRun() {
+  if (!LOW_POWER_RUN_ENABLED || currentTimerState != STATE_RUNNING || creditPending) return false;
+  if (millis() - lastActivityTime < LOW_POWER_IDLE_DELAY) return false;
+  if (millisToDeadline() < (long)LOW_POWER_WAKE_MARGIN + (long)stepMillis(WDT_MIN_STEP)) return false;
+  if (outputsMillisToNextEdge() < (long)stepMillis(WDT_MIN_STEP)) return false; // Train d'impulsions en cours
+
+  Report.flush();
+  if (!calibrated) {
+    calibrateWatchdog(); // ~80 ms éveillé : une fois par décompte
+    calibrated = true;
+  }
+  LCD.noBacklight();
+  LCD.noDisplay();
+  displayBusFlush(); // File I2C vidée avant le premier power-down
+
+  bool inputWake = false;
+  while (true) {
+    long budget = millisToDeadline() - (long)LOW_POWER_WAKE_MARGIN;
+    long nextEdge = outputsMillisToNextEdge(); // Ne pas dormir au-delà du prochain front de sortie
+    if (nextEdge < budget) budget = nextEdge;
+    byte step = choosePeriod(budget);
+    if (step == WDT_NO_STEP) break; // Fin du décompte ou front proche : la suite se fait éveillé
+
+    awokeByInterrupt = false;
+    startWatchdog(step);
+    PCIFR = _BV(PCIF2);
+    PCMSK2 |= WAKE_PCINT_MASK;
+    PCICR |= _BV(PCIE2);
+    set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+    cli();
+    if (!awokeByInterrupt && !wdtFired) {
+      sleep_enable();
+      sei();
+      sleep_cpu();
+      sleep_disable();
+    }
+    sei();
+    PCMSK2 &= ~WAKE_PCINT_MASK;
+
+    if (wdtFired && !awokeByInterrupt) {
+      stopWatchdog();
+      addSleepMicros(stepMicros(step));
+      lowPowerStats.wakeups++;
+      serviceOutputs();
+      serviceCheckpoint(modeState.timer.targetEndTime - millis());
+      continue;
+    }
+    // Réveil par une entrée : l'interface se rallume sans attendre. La fin de la période WDT, vécue
+    // éveillé (Timer0 compte), donnera la part dormie à serviceLowPowerWake().
+    pendingWakeMicros = micros();
+    pendingPeriodMicros = stepMicros(step);
+    creditPending = true;
+    inputWake = true;
+    break;
+  }
+
+  LCD.display();
+  LCD.backlight();
+  modeState.timer.lastDisplayedMIN = -1;
+  modeState.timer.lastDisplayedSEC = -1;
+  requestDisplay(DISP_PRIO_SECONDS, updateStaticDisplay);
+  requestDisplay(DISP_PRIO_CENTIS, updateCentisecondsDisplay);
+  return inputWake;
+}
+
+void serviceLowPowerWake() {
+  if (!creditPending || !wdtFired) return;
+  stopWatchdog();
+  creditPending = false;
+  unsigned long awake = micros() - pendingWakeMicros;
+  if (pendingPeriodMicros > awake) addSleepMicros(pendingPeriodMicros - awake);
+}
+
+void lowPowerRunBegin() {
+  calibrated = false; // Tension et température ont pu changer depuis le dernier décompte
+  lowPowerStats.runStart = millis();
+  lowPowerStats.sleepMillis = 0;
+  lowPowerStats.wakeups = 0;
+  lowPowerStats.active = true;
+}
+
+void lowPowerRunEnd() {
+  if (!lowPowerStats.active) return;
+  lowPowerStats.active = false;
+  unsigned long totalSec = (millis() - lowPowerStats.runStart) / 1000;
+  if (totalSec == 0) return;
+  unsigned long sleepSec = lowPowerStats.sleepMillis / 1000;
+  unsigned long averageUA = ((totalSec - sleepSec) * AWAKE_CURRENT_UA + sleepSec * SLEEP_CURRENT_UA) / totalSec;
+  Report.print(F("Decompte: ")); Report.print(totalSec);
+  Report.print(F(" s dont ")); Report.print(sleepSec);
+  Report.print(F(" s en veille (")); Report.print(lowPowerStats.wakeups);
+  Report.print(F(" reveils), courant moyen estime ")); Report.print(averageUA / 1000);
+  Report.print(F(".")); Report.print((averageUA / 100) % 10);
+  Report.print(F(" mA (")); Report.print(AWAKE_CURRENT_UA / 1000);
+  Report.println(F(" mA sans veille)"));
+}
@@ -0,0 +1,38 @@
+// lowpower.h - Décompte en basse consommation (veille profonde + chien de garde)
+//
+// Pendant un long décompte sans action de l'utilisateur, l'écran est éteint et le MCU passe en
+// SLEEP_MODE_PWR_DOWN entre deux réveils du chien de garde (WDT). Timer0 étant arrêté en veille,
+// millis() et micros() sont recalés de la durée dormie à chaque réveil : loopTimer(), les sorties,
+// le chronomètre et le banc restent exacts.
+// Le sommeil ne dépasse jamais le prochain front prévu par le calendrier des sorties (sorties.h).
+// La période du WDT (oscillateur 128 kHz, ±10 %) est étalonnée sur micros() à la première mise en
+// veille de chaque décompte, et les LOW_POWER_WAKE_MARGIN dernières ms sont décomptées éveillé,
+// écran rallumé.
+// Un appui bouton ou un cran d'encodeur (PCINT2) rallume l'interface aussitôt. La part dormie de la
+// période WDT en cours n'est connue qu'à sa fin (~256 ms au plus) : serviceLowPowerWake() la
+// crédite alors, et millis() rattrape d'un coup ce retard.
+//
+// Timer2 asynchrone (quartz 32 kHz sur TOSC1/TOSC2) n'est pas utilisable sur un Nano : ces broches
+// portent le quartz 16 MHz. Le WDT est la seule base de temps qui tourne en power-down.
+#ifndef LOWPOWER_H
+#define LOWPOWER_H
+
+#include <Arduino.h>
+#include "conf.h"
+
+struct LowPowerStats {
+  unsigned long runStart;      // millis() au départ du décompte
+  unsigned long sleepMillis;   // Temps passé en power-down pendant ce décompte
+  unsigned int wakeups;        // Réveils du WDT
+  bool active;                 // Un décompte est mesuré
+};
+
+extern LowPowerStats lowPowerStats;
+extern volatile bool awokeByInterrupt; // Positionné par ISR(PCINT2_vect) (bouton.cpp)
+
+bool serviceLowPowerRun();        // Appelée pendant le décompte ; true si une entrée a réveillé l'interface
+void serviceLowPowerWake();       // Appelée par loop() : crédite la veille interrompue par une entrée
+void lowPowerRunBegin();          // Départ du décompte : remise à zéro des statistiques
+void lowPowerRunEnd();            // Fin ou arrêt : courant moyen estimé envoyé sur le port série
+
+#endif // LOWPOWER_H
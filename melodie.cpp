@@ -1,200 +1,54 @@
-// melodie.cpp - Définitions (code) des fonctions mélodies
-
-#include "melodie.h" // Inclut les déclarations et les définitions de notes
-#include "conf.h"    // Requis pour la constante BUZZER_PIN
-
-// --- Définitions des Fonctions Mélodies ---
-
-// Fonction pour jouer la mélodie Mario (BLOQUANTE - version rythmée)
-void playMarioMelody() {
-  // Utilise les notes spécifiques définies dans melodie.h
-  int tempo = 120; 
-  int quarterNote = 60000 / tempo; 
-  int eighthNote = quarterNote / 2;
-  int halfNote = quarterNote * 2; 
-  int dotQuarterNote = quarterNote * 1.5;
-  int pause = eighthNote / 3; 
-  int noteDur = 0; 
-  int delayTime = 0;
-
-  auto playNote = [&](int note, int durationType) {
-    noteDur = durationType - pause; if(noteDur < 10) noteDur = 10;
-    delayTime = durationType;
-    tone(BUZZER_PIN, note, noteDur); // BUZZER_PIN vient de conf.h via melodie.h
-    delay(delayTime);
-  };
-
-  playNote(NOTE_E6_MARIO, eighthNote); playNote(NOTE_E6_MARIO, eighthNote); playNote(NOTE_E6_MARIO, eighthNote);
-  playNote(NOTE_C6_MARIO, eighthNote); playNote(NOTE_E6_MARIO, quarterNote); playNote(NOTE_G6_MARIO, quarterNote);
-  playNote(NOTE_G5_MARIO, halfNote);
-  delay(quarterNote);
-  playNote(NOTE_C6_MARIO, quarterNote); playNote(NOTE_G5_MARIO, quarterNote); playNote(NOTE_E5_MARIO, quarterNote);
-  playNote(NOTE_A5_MARIO, eighthNote); playNote(NOTE_Bb5_MARIO, eighthNote); playNote(NOTE_A5_ALT_MARIO, eighthNote);
-  playNote(NOTE_G5_MARIO, dotQuarterNote); playNote(NOTE_E6_MARIO, eighthNote); playNote(NOTE_G6_ALT_MARIO, eighthNote);
-  playNote(NOTE_A6_MARIO, quarterNote); playNote(NOTE_F6_MARIO, eighthNote); playNote(NOTE_G6_ALT_MARIO, halfNote);
-  noTone(BUZZER_PIN);
-}
-
-// Fonction pour jouer la Marche Impériale (BLOQUANTE)
-void playImperialMarch() {
-  // Utilise les notes spécifiques définies dans melodie.h
-  int tempo = 110; int quarterNote = 60000 / tempo; int eighthNote = quarterNote / 2;
-  int dottedEighthNote = eighthNote * 1.5; int sixteenthNote = quarterNote / 4;
-  int halfNote = quarterNote * 2; int pause = eighthNote / 2;
-
-  tone(BUZZER_PIN, NOTE_A4, quarterNote); delay(quarterNote + pause);
-  tone(BUZZER_PIN, NOTE_A4, quarterNote); delay(quarterNote + pause);
-  tone(BUZZER_PIN, NOTE_A4, quarterNote); delay(quarterNote + pause);
-  tone(BUZZER_PIN, NOTE_F4, dottedEighthNote); delay(dottedEighthNote + pause);
-  tone(BUZZER_PIN, NOTE_C5, sixteenthNote); delay(sixteenthNote + pause);
-  tone(BUZZER_PIN, NOTE_A4, quarterNote); delay(quarterNote + pause);
-  tone(BUZZER_PIN, NOTE_F4, dottedEighthNote); delay(dottedEighthNote + pause);
-  tone(BUZZER_PIN, NOTE_C5, sixteenthNote); delay(sixteenthNote + pause);
-  tone(BUZZER_PIN, NOTE_A4, halfNote); delay(halfNote + pause);
-  delay(quarterNote);
-  tone(BUZZER_PIN, NOTE_DS5, quarterNote); delay(quarterNote + pause);
-  tone(BUZZER_PIN, NOTE_DS5, quarterNote); delay(quarterNote + pause);
-  tone(BUZZER_PIN, NOTE_DS5, quarterNote); delay(quarterNote + pause);
-  tone(BUZZER_PIN, NOTE_F5, dottedEighthNote); delay(dottedEighthNote + pause);
-  tone(BUZZER_PIN, NOTE_C5, sixteenthNote); delay(sixteenthNote + pause);
-  tone(BUZZER_PIN, NOTE_GS4, quarterNote); delay(quarterNote + pause);
-  tone(BUZZER_PIN, NOTE_F4, dottedEighthNote); delay(dottedEighthNote + pause);
-  tone(BUZZER_PIN, NOTE_C5, sixteenthNote); delay(sixteenthNote + pause);
-  tone(BUZZER_PIN, NOTE_A4, halfNote); delay(halfNote + pause);
-  noTone(BUZZER_PIN);
+// melodie.cpp - Lecteur des mélodies compactées (PROGMEM)
+
+#include "melodie.h"      // Déclarations et format compact
+#include "melodie_data.h" // Mélodies générées depuis tools/melodies.rtttl
+#include "conf.h"         // Requis pour BUZZER_PIN et NUM_MELODIES
+#include "buzzer.h"       // Notes en priorité SOUND_ALARM
+
+static_assert(MELODY_DATA_COUNT == NUM_MELODIES, "melodie_data.h et NUM_MELODIES (conf.h) ne correspondent pas");
+
+// Fréquences de l'octave 4 (C4..B4), les autres octaves s'obtiennent par décalage
+const unsigned int OCTAVE4_FREQUENCIES[12] PROGMEM = {
+  262, 277, 294, 311, 330, 349, 370, 392, 415, 440, 466, 494
+};
+
+unsigned int midiNoteFrequency(byte midiNote) {
+  byte octave = midiNote / 12;      // MIDI 60 (C4) -> 5
+  unsigned int freq = pgm_read_word(&OCTAVE4_FREQUENCIES[midiNote % 12]);
+  if (octave >= 5) { freq <<= (octave - 5); }
+  else { freq >>= (5 - octave); }
+  return freq;
 }
 
-// Fonction pour jouer thème Zelda (BLOQUANTE - Exemple simple)
-// Fonction pour jouer thème Zelda (BLOQUANTE - Exemple simple corrigé)
-void playZeldaTheme() {
-  int tempo = 130;
-  int quarterNote = 60000 / tempo;
-  int halfNote = quarterNote * 2;
-  // int wholeNote = quarterNote * 4; // SUPPRIMÉ (inutilisé)
-  int pause = quarterNote / 4;
-  int noteDur = 0;
-
-  noteDur = quarterNote - pause; if(noteDur<10) noteDur=10;
-  tone(BUZZER_PIN, NOTE_G4, noteDur); delay(quarterNote);
-  tone(BUZZER_PIN, NOTE_A4, noteDur); delay(quarterNote);
-  tone(BUZZER_PIN, NOTE_B4, noteDur); delay(quarterNote);
-  noteDur = halfNote - pause; if(noteDur<10) noteDur=10;
-  tone(BUZZER_PIN, NOTE_C5, noteDur); delay(halfNote); // Note plus longue
-  noTone(BUZZER_PIN);
+// Durée (ms) d'un code de durée, calculée en entiers à partir de la ronde
+static unsigned int packedDuration(byte code, unsigned int wholeNote) {
+  if (code == MELODY_DUR_DOTTED_QUARTER) { return (wholeNote >> 2) + (wholeNote >> 3); }
+  if (code == MELODY_DUR_DOTTED_EIGHTH)  { return (wholeNote >> 3) + (wholeNote >> 4); }
+  return wholeNote >> code;
 }
 
-// --- Nouvelle Mélodie : Nokia Tune ---
-void playNokiaTune() {
-  int tempo = 180; // Tempo rapide
-  int eighthNote = (60000 / tempo) / 2;
-  int quarterNote = eighthNote * 2;
-  // int dottedQuarterNote = quarterNote * 1.5;
-  int pause = eighthNote / 4; // Petite pause entre notes
-  int noteDur = 0;
-
-  // Séquence simplifiée mais reconnaissable
-  noteDur = eighthNote - pause; if(noteDur<10) noteDur=10;
-  tone(BUZZER_PIN, NOTE_E5, noteDur); delay(eighthNote);
-  tone(BUZZER_PIN, NOTE_D5, noteDur); delay(eighthNote);
-  noteDur = quarterNote - pause; if(noteDur<10) noteDur=10;
-  tone(BUZZER_PIN, NOTE_FS4, noteDur); delay(quarterNote);
-  tone(BUZZER_PIN, NOTE_GS4, noteDur); delay(quarterNote);
-  noteDur = eighthNote - pause; if(noteDur<10) noteDur=10;
-  tone(BUZZER_PIN, NOTE_CS5, noteDur); delay(eighthNote);
-  tone(BUZZER_PIN, NOTE_B4, noteDur); delay(eighthNote);
-  noteDur = quarterNote - pause; if(noteDur<10) noteDur=10;
-  tone(BUZZER_PIN, NOTE_D4, noteDur); delay(quarterNote);
-  tone(BUZZER_PIN, NOTE_E4, noteDur); delay(quarterNote); // Note E4 déjà définie ? Sinon ajoutez #define NOTE_E4 330
-  noteDur = eighthNote - pause; if(noteDur<10) noteDur=10;
-  tone(BUZZER_PIN, NOTE_B4, noteDur); delay(eighthNote);
-  tone(BUZZER_PIN, NOTE_A4, noteDur); delay(eighthNote);
-  noteDur = quarterNote - pause; if(noteDur<10) noteDur=10;
-  tone(BUZZER_PIN, NOTE_CS4, noteDur); delay(quarterNote);
-  tone(BUZZER_PIN, NOTE_E4, noteDur); delay(quarterNote); // Note E4 déjà définie ?
-  noteDur = quarterNote * 2 - pause; if(noteDur<10) noteDur=10; // Note longue finale
-  tone(BUZZER_PIN, NOTE_A4, noteDur); delay(quarterNote * 2);
-
-  noTone(BUZZER_PIN);
+void playPackedMelody(const uint8_t* melody) {
+  byte noteCount = pgm_read_byte(melody);
+  byte bpm = pgm_read_byte(melody + 1);
+  if (bpm < MELODY_MIN_BPM) return; // Tempo invalide : 0 diviserait par zéro, 1..3 déborderaient
+  unsigned int wholeNote = 240000UL / bpm; // Durée d'une ronde (ms)
+  byte baseNote = pgm_read_byte(melody + 2);
+
+  for (byte i = 0; i < noteCount; i++) {
+    byte packed = pgm_read_byte(melody + MELODY_HEADER_SIZE + i);
+    unsigned int duration = packedDuration(packed >> MELODY_DUR_SHIFT, wholeNote);
+    byte note = packed & MELODY_NOTE_MASK;
+    if (note != 0) {
+      unsigned int noteDur = duration - (duration >> 3); // Petite pause entre les notes (1/8)
+      if (noteDur < 10) noteDur = 10;
+      playSound(SOUND_ALARM, midiNoteFrequency(baseNote + note - 1), noteDur);
+    }
+    delay(duration);
+  }
+  buzzerSilence(SOUND_ALARM);
 }
 
-// --- Nouvelle Mélodie : Tetris Theme (Thème A) ---
-void playTetrisTheme() {
-  int tempo = 145;
-  int quarterNote = 60000 / tempo;
-  int eighthNote = quarterNote / 2;
-  int halfNote = quarterNote * 2;
-  int pause = eighthNote / 4;
-  int noteDur = 0;
-
-  // Mesure 1
-  noteDur = quarterNote - pause; if(noteDur<10) noteDur=10;
-  tone(BUZZER_PIN, NOTE_E5, noteDur); delay(quarterNote);
-  noteDur = eighthNote - pause; if(noteDur<10) noteDur=10;
-  tone(BUZZER_PIN, NOTE_B4, noteDur); delay(eighthNote);
-  tone(BUZZER_PIN, NOTE_C5, noteDur); delay(eighthNote);
-  noteDur = quarterNote - pause; if(noteDur<10) noteDur=10;
-  tone(BUZZER_PIN, NOTE_D5, noteDur); delay(quarterNote);
-  noteDur = eighthNote - pause; if(noteDur<10) noteDur=10;
-  tone(BUZZER_PIN, NOTE_C5, noteDur); delay(eighthNote);
-  tone(BUZZER_PIN, NOTE_B4, noteDur); delay(eighthNote);
-
-  // Mesure 2
-  noteDur = quarterNote - pause; if(noteDur<10) noteDur=10;
-  tone(BUZZER_PIN, NOTE_A4, noteDur); delay(quarterNote);
-  // tone(BUZZER_PIN, NOTE_A4, noteDur); delay(quarterNote); // Répétition A4 enlevée pour simplifier
-  tone(BUZZER_PIN, NOTE_C5, noteDur); delay(quarterNote);
-  tone(BUZZER_PIN, NOTE_E5, noteDur); delay(quarterNote);
-  noteDur = quarterNote - pause; if(noteDur<10) noteDur=10;
-  tone(BUZZER_PIN, NOTE_D5, noteDur); delay(quarterNote);
-  noteDur = eighthNote - pause; if(noteDur<10) noteDur=10;
-  tone(BUZZER_PIN, NOTE_C5, noteDur); delay(eighthNote);
-  tone(BUZZER_PIN, NOTE_B4, noteDur); delay(eighthNote);
-
-  // Mesure 3 (identique mesure 1)
-  noteDur = quarterNote - pause; if(noteDur<10) noteDur=10;
-  tone(BUZZER_PIN, NOTE_E5, noteDur); delay(quarterNote);
-  noteDur = eighthNote - pause; if(noteDur<10) noteDur=10;
-  tone(BUZZER_PIN, NOTE_B4, noteDur); delay(eighthNote);
-  tone(BUZZER_PIN, NOTE_C5, noteDur); delay(eighthNote);
-  noteDur = quarterNote - pause; if(noteDur<10) noteDur=10;
-  tone(BUZZER_PIN, NOTE_D5, noteDur); delay(quarterNote);
-  noteDur = eighthNote - pause; if(noteDur<10) noteDur=10;
-  tone(BUZZER_PIN, NOTE_C5, noteDur); delay(eighthNote);
-  tone(BUZZER_PIN, NOTE_B4, noteDur); delay(eighthNote);
-
-  // Mesure 4
-  noteDur = quarterNote - pause; if(noteDur<10) noteDur=10;
-  tone(BUZZER_PIN, NOTE_A4, noteDur); delay(quarterNote);
-  // tone(BUZZER_PIN, NOTE_A4, noteDur); delay(quarterNote); // Répétition A4 enlevée
-  tone(BUZZER_PIN, NOTE_C5, noteDur); delay(quarterNote);
-  noteDur = halfNote - pause; if(noteDur<10) noteDur=10; // Note longue
-  tone(BUZZER_PIN, NOTE_E5, noteDur); delay(halfNote);
-
-  // Petite variation pour finir ?
-  delay(quarterNote); // Pause
-  noteDur = quarterNote - pause; if(noteDur<10) noteDur=10;
-  tone(BUZZER_PIN, NOTE_D5, noteDur); delay(quarterNote);
-  noteDur = halfNote - pause; if(noteDur<10) noteDur=10;
-  tone(BUZZER_PIN, NOTE_C5, noteDur); delay(halfNote); // Fin sur C5
-
-  noTone(BUZZER_PIN);
-}
-
-
-// --- Nouvelle Mélodie : Bip-Bip ---
-void playBipBipMelody() {
-  // Utilise les constantes de fréquence et de durée du métronome
-  // définies dans conf.h (qui est inclus via melodie.h ou directement si besoin).
-  // BUZZER_PIN est également défini dans conf.h.
-
-  // Premier "Bip" (son accentué du métronome)
-  tone(BUZZER_PIN, METRONOME_ACCENT_FREQ, METRONOME_ACCENT_DURATION);
-  delay(METRONOME_ACCENT_DURATION + 70); // Durée du son + 70ms de pause
-
-  // Deuxième "Bip" (son accentué du métronome)
-  tone(BUZZER_PIN, METRONOME_ACCENT_FREQ, METRONOME_ACCENT_DURATION);
-  delay(METRONOME_ACCENT_DURATION + 70); // Durée du son + 70ms de pause
-
-  noTone(BUZZER_PIN); // S'assurer que le buzzer s'arrête
+void playMelody(byte melodyIndex) {
+  if (melodyIndex >= NUM_MELODIES) return; // Sécurité
+  playPackedMelody((const uint8_t*)pgm_read_ptr(&MELODY_TABLE[melodyIndex]));
 }
-// --- FIN des définitions --
\ No newline at end of file
@@ -1,49 +1,26 @@
-// melodie.h - Déclarations des fonctions mélodies et définitions des notes
+// melodie.h - Déclarations des fonctions mélodies et format compact des mélodies
 
 #ifndef MELODIE_H
 #define MELODIE_H
 
 #include <Arduino.h> // Pour les types comme byte (implicite mais bon)
 
-// --- Fréquences des Notes ---
-// (Toutes les définitions #define NOTE_... restent ici)
-#define NOTE_A4  440
-#define NOTE_F4  349
-#define NOTE_C5  523
-#define NOTE_AS4 466  // A#4 / Bb4
-#define NOTE_G4  392
-#define NOTE_E4  330
-#define NOTE_FS4 370  // F#4 / Gb4
-#define NOTE_GS4 415  // G#4 / Ab4
-#define NOTE_CS5 554  // C#5 / Db5
-#define NOTE_DS5 622  // D#5 / Eb5
-#define NOTE_D5  587
-#define NOTE_F5  698
-#define NOTE_E5  659  // E5
-#define NOTE_D4  294  // D4
-#define NOTE_CS4 277  // C#4 / Db4
-#define NOTE_B4  494  // Pour Zelda
-// Notes "Mario" spécifiques
-#define NOTE_E6_MARIO  660
-#define NOTE_C6_MARIO  510
-#define NOTE_G6_MARIO  770
-#define NOTE_G5_MARIO  380
-#define NOTE_E5_MARIO  320
-#define NOTE_A5_MARIO  440
-#define NOTE_Bb5_MARIO 480
-#define NOTE_A5_ALT_MARIO 450
-#define NOTE_G6_ALT_MARIO 760
-#define NOTE_A6_MARIO 860
-#define NOTE_F6_MARIO 700
-
+// --- Format Compact des Mélodies (PROGMEM) ---
+// Les mélodies sont écrites au format RTTTL dans tools/melodies.rtttl puis converties
+// par tools/rtttl2melodie.py en tableaux d'octets dans melodie_data.h :
+//   [nombre de notes] [tempo BPM] [note MIDI de base] puis 1 octet par note
+//   bits 7-5 : code de durée (voir MELODY_DUR_...), bits 4-0 : note (0 = silence, n = base + n - 1)
+const byte MELODY_HEADER_SIZE = 3;
+const byte MELODY_NOTE_MASK   = 0x1F;
+const byte MELODY_DUR_SHIFT   = 5;
+const byte MELODY_DUR_DOTTED_QUARTER = 6; // Codes 0..5 = ronde..triple croche
+const byte MELODY_DUR_DOTTED_EIGHTH  = 7;
+const byte MELODY_MIN_BPM = 4; // 240000 / 4 = 60000 ms : la ronde tient encore dans un unsigned int
 
 // --- Déclarations des Fonctions Mélodies ---
-// Les définitions (le code complet) sont maintenant dans melodie.cpp
-void playMarioMelody();
-void playImperialMarch();
-void playZeldaTheme();
-void playNokiaTune(); 
-void playTetrisTheme(); 
-void playBipBipMelody();
+// Les définitions (le code complet) sont dans melodie.cpp
+void playMelody(byte melodyIndex);              // Joue la mélodie n° melodyIndex (BLOQUANT)
+void playPackedMelody(const uint8_t* melody);   // Joue une mélodie compactée en PROGMEM (BLOQUANT)
+unsigned int midiNoteFrequency(byte midiNote);  // Fréquence (Hz) d'une note MIDI, sans calcul flottant
 
-#endif // MELODIE_H
\ No newline at end of file
+#endif // MELODIE_H
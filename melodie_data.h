@@ -0,0 +1,61 @@
+// melodie_data.h - Mélodies compactées en PROGMEM
+// FICHIER GÉNÉRÉ par tools/rtttl2melodie.py depuis tools/melodies.rtttl : ne pas modifier à la main.
+
+#ifndef MELODIE_DATA_H
+#define MELODIE_DATA_H
+
+#include <Arduino.h>
+#include <avr/pgmspace.h>
+
+const byte MELODY_DATA_COUNT = 6;
+
+// Mario : 20 notes, 120 BPM
+const uint8_t MELODY_MARIO[] PROGMEM = {
+  20, 120, 64,
+  0x6D, 0x6D, 0x6D, 0x69, 0x4D, 0x50, 0x24, 0x40, 0x49, 0x44, 0x41, 0x66,
+  0x67, 0x66, 0xC4, 0x6D, 0x70, 0x52, 0x6E, 0x30
+};
+
+// StarWars : 19 notes, 110 BPM
+const uint8_t MELODY_STARWARS[] PROGMEM = {
+  19, 110, 65,
+  0x45, 0x45, 0x45, 0xE1, 0x88, 0x45, 0xE1, 0x88, 0x25, 0x40, 0x4B, 0x4B,
+  0x4B, 0xED, 0x88, 0x44, 0xE1, 0x88, 0x25
+};
+
+// Zelda : 4 notes, 130 BPM
+const uint8_t MELODY_ZELDA[] PROGMEM = {
+  4, 130, 67,
+  0x41, 0x43, 0x45, 0x26
+};
+
+// Nokia : 13 notes, 180 BPM
+const uint8_t MELODY_NOKIA[] PROGMEM = {
+  13, 180, 61,
+  0x70, 0x6E, 0x46, 0x48, 0x6D, 0x6B, 0x42, 0x44, 0x6B, 0x69, 0x41, 0x44,
+  0x29
+};
+
+// Tetris : 24 notes, 145 BPM
+const uint8_t MELODY_TETRIS[] PROGMEM = {
+  24, 145, 69,
+  0x48, 0x63, 0x64, 0x46, 0x64, 0x63, 0x41, 0x44, 0x48, 0x46, 0x64, 0x63,
+  0x48, 0x63, 0x64, 0x46, 0x64, 0x63, 0x41, 0x44, 0x28, 0x40, 0x46, 0x24
+};
+
+// Bip-Bip : 4 notes, 125 BPM
+const uint8_t MELODY_BIP_BIP[] PROGMEM = {
+  4, 125, 100,
+  0xA1, 0xA0, 0xA1, 0xA0
+};
+
+const uint8_t* const MELODY_TABLE[MELODY_DATA_COUNT] PROGMEM = {
+  MELODY_MARIO,
+  MELODY_STARWARS,
+  MELODY_ZELDA,
+  MELODY_NOKIA,
+  MELODY_TETRIS,
+  MELODY_BIP_BIP
+};
+
+#endif // MELODIE_DATA_H
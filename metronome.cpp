@@ -1,52 +1,187 @@
 // metronome.cpp
 
 #include "metronome.h"
+#include "rapport.h"
 
 // État pour l'édition dans le menu de la signature rythmique
 enum TSEditState { EDIT_NUM, EDIT_DEN, CONFIRM_TS };
 static TSEditState currentTSEditState; // Garder l'état actuel de l'édition
 
+static byte beatMarkersShown = 0; // Nombre de marqueurs de temps actuellement affichés (ligne 3)
+static bool stopAtMeasureEnd = false; // Arrêt demandé au lieu du prochain temps fort (mode Pratique)
+
+MetronomeTiming metronomeTiming = { 0, 0, 0 };
+
+static int shownBPM = -1;             // BPM en grands chiffres à l'écran (-1 : écran redessiné, tout à écrire)
+static byte shownTempoMarking = 0;    // Indication de tempo affichée
+static bool tempoSavePending = false; // BPM modifié, pas encore enregistré
+static unsigned long tempoChangedAt = 0;
+
+// Accelerando / ritardando en cours : un palier à chaque temps fort
+static int rampFromBPM = 0;
+static int rampToBPM = 0;
+static byte rampMeasures = 0;         // 0 = pas de rampe
+static byte rampMeasure = 0;          // Paliers déjà appliqués
+
+static void drawMetronomeBPM();
+static void stepTempoRamp();
+
 void setupMetronome() {
-  // Charger le BPM depuis l'EEPROM
-  int temp_bpm;
-  EEPROM.get(EEPROM_ADDR_METRONOME_BPM, temp_bpm);
-  if (temp_bpm < MIN_BPM || temp_bpm > MAX_BPM) {
-    currentBPM = DEFAULT_BPM;
-    EEPROM.put(EEPROM_ADDR_METRONOME_BPM, currentBPM); 
-  } else {
-    currentBPM = temp_bpm;
+  // Charger le BPM depuis les réglages (reglages.h, enregistrés par setup())
+  if (settings.bpm < MIN_BPM || settings.bpm > MAX_BPM) {
+    settings.bpm = DEFAULT_BPM;
   }
+  currentBPM = settings.bpm;
 
-  // Charger le numérateur de la signature rythmique depuis l'EEPROM
-  byte savedTSNum = EEPROM.read(EEPROM_ADDR_METRONOME_TS_NUM);
-  if (savedTSNum < MIN_TIME_SIGNATURE_NUMERATOR || savedTSNum > MAX_TIME_SIGNATURE_NUMERATOR) {
-    timeSignatureNum = DEFAULT_TIME_SIGNATURE_NUMERATOR;
-    EEPROM.update(EEPROM_ADDR_METRONOME_TS_NUM, timeSignatureNum);
-  } else {
-    timeSignatureNum = savedTSNum;
+  // Charger le numérateur de la signature rythmique
+  if (settings.tsNum < MIN_TIME_SIGNATURE_NUMERATOR || settings.tsNum > MAX_TIME_SIGNATURE_NUMERATOR) {
+    settings.tsNum = DEFAULT_TIME_SIGNATURE_NUMERATOR;
   }
+  timeSignatureNum = settings.tsNum;
 
-  // Charger le dénominateur de la signature rythmique depuis l'EEPROM // <<< NOUVEAU
-  byte savedTSDen = EEPROM.read(EEPROM_ADDR_METRONOME_TS_DEN);
-  if (savedTSDen < MIN_TIME_SIGNATURE_DENOMINATOR || savedTSDen > MAX_TIME_SIGNATURE_DENOMINATOR) {
-    timeSignatureDen = DEFAULT_TIME_SIGNATURE_DENOMINATOR;
-    EEPROM.update(EEPROM_ADDR_METRONOME_TS_DEN, timeSignatureDen);
-  } else {
-    timeSignatureDen = savedTSDen;
+  // Charger le dénominateur de la signature rythmique // <<< NOUVEAU
+  if (settings.tsDen < MIN_TIME_SIGNATURE_DENOMINATOR || settings.tsDen > MAX_TIME_SIGNATURE_DENOMINATOR) {
+    settings.tsDen = DEFAULT_TIME_SIGNATURE_DENOMINATOR;
   }
+  timeSignatureDen = settings.tsDen;
 }
 
 void enterMetronomeMode() {
     resetActivityTimer();
-    currentMode = MODE_METRONOME;
     currentMetroState = METRO_STOPPED;
     // LCD.clear(); // displayMetronomeScreen s'en chargera
     bigNum.begin(); 
+    displayMetronomeScreen();
+}
 
-    encoder.setPosition(currentBPM); // Initialiser l'encodeur avec le BPM actuel
-    metroEncoderLastPos = currentBPM; 
+void exitMetronomeMode() {
+    if (currentMetroState == METRO_RUNNING) { 
+        stopMetronome();
+    }
+    flushTempo();
+}
 
-    displayMetronomeScreen();
+// Esclave MIDI : Start / Continue / Stop reçus et tempo estimé par la boucle de phase
+static void followMidiClock() {
+    MidiTransport transport = midiTransportEvent();
+    if ((transport == MIDI_START || transport == MIDI_CONTINUE) && currentMetroState == METRO_STOPPED) {
+        startMetronome(transport == MIDI_START);
+        displayMetronomeScreen();
+    } else if (transport == MIDI_STOP && currentMetroState == METRO_RUNNING) {
+        stopMetronome();
+        displayMetronomeScreen();
+    }
+
+    int bpm = midiTempoBPM();
+    if (bpm != 0 && bpm != currentBPM) {
+        currentBPM = bpm; // Pas sauvegardé : le tempo appartient au maître
+        if (currentMetroState == METRO_RUNNING) { requestDisplay(DISP_PRIO_SECONDS, drawMetronomeBPM); }
+        else { displayMetronomeScreen(); }
+    }
+}
+
+void tickMetronomeMode() {
+    if (midiSyncMode() == MIDI_SYNC_SLAVE) { followMidiClock(); }
+    handleMetronomeLogic();
+    serviceTempo();
+    // Esclave : pas de veille, un Start reçu doit trouver le métronome prêt
+    if (currentMetroState == METRO_STOPPED && midiSyncMode() != MIDI_SYNC_SLAVE) { checkIdleSleep(); }
+}
+
+void handleMetronomeEncoder(int delta) {
+    if (midiSyncMode() == MIDI_SYNC_SLAVE) return;  // Tempo imposé par l'horloge reçue
+    int newBPM = constrain(currentBPM + delta, MIN_BPM, MAX_BPM);
+    if (currentBPM != newBPM) { 
+        if (currentMetroState == METRO_STOPPED) playClickSound(); // En marche, un clic brouillerait la pulsation
+        resetActivityTimer();
+        rampMeasures = 0; // Le réglage à la main reprend la main sur une rampe en cours
+        setTempo(newBPM);
+    }
+}
+
+void handleMetronomeButton(ButtonEvent event) {
+    if (event == BTN_LONG_PRESS) {
+        setMode(MODE_MENU_MAIN); // Retourne au "Menu Réglages"
+        return;
+    }
+    if (!isClickEvent(event)) return;
+    if (event == BTN_DOUBLE_CLICK && currentMetroState == METRO_RUNNING && midiSyncMode() != MIDI_SYNC_SLAVE) {
+        // Le premier clic vient de lancer le métronome : double-clic à l'arrêt = départ en accelerando
+        startTempoRamp(currentBPM + TEMPO_RAMP_BPM, TEMPO_RAMP_MEASURES);
+        return;
+    }
+    if (currentMetroState == METRO_STOPPED) {
+        startMetronome(true);
+    } else { 
+        stopMetronome();
+    }
+    displayMetronomeScreen(); 
+}
+
+void startMetronome(bool fromTop) {
+    currentMetroState = METRO_RUNNING;
+    stopAtMeasureEnd = false;
+    modeState.metro.lastBeatTime = millis(); 
+    modeState.metro.beatFraction = 0;
+    metronomeTiming = { 0, 0, 0 };
+    if (fromTop) modeState.metro.beatInMeasure = 0;     
+    for (byte b = 0; b < timeSignatureNum; ++b) {
+         LCD.setCursor(METRO_BEAT_MARKER_START_COL + b, METRO_BEAT_VISUAL_ROW);
+         LCD.print(" ");
+    }
+    midiStart(); // Maître : Start et horloge, premier temps immédiat
+}
+
+void stopMetronome() {
+    currentMetroState = METRO_STOPPED;
+    stopAtMeasureEnd = false;
+    rampMeasures = 0;
+    buzzerSilence(SOUND_BEAT); // Une mélodie ou un carillon en cours continue
+    midiStop();
+    reportMetronomeTiming();
+}
+
+void reportMetronomeTiming() {
+    if (metronomeTiming.beats == 0) return;
+    Report.print(F("Metronome temps="));  Report.print(metronomeTiming.beats);
+    Report.print(F(" retard max="));      Report.print(metronomeTiming.maxLateMs);
+    Report.print(F(" ms recalages="));    Report.println(metronomeTiming.resyncs);
+    metronomeTiming.beats = 0;
+}
+
+// Chiffres du BPM aux trois positions des grands chiffres (-1 = case vide)
+static void bpmDigits(int bpm, int8_t digits[3]) {
+    digits[0] = bpm >= 100 ? bpm / 100 : -1;
+    digits[1] = bpm >= 10 ? (bpm / 10) % 10 : -1;
+    digits[2] = bpm % 10;
+}
+
+// Nom de l'indication de tempo après les marqueurs de temps, reste de la ligne effacé
+static void drawTempoName() {
+    byte col = METRO_BEAT_MARKER_START_COL + timeSignatureNum;
+    if (col < LCD_COLS - 1) col++; // Espace séparateur si au moins un caractère du nom tient ensuite
+    shownTempoMarking = currentTempoMarking();
+    if (col >= LCD_COLS) return;
+    LCD.setCursor(col, METRO_BEAT_VISUAL_ROW);
+    byte len = printTempoMarkingName(shownTempoMarking, LCD_COLS - col); // Tronqué si trop long
+    clearRestOfLine(col + len, METRO_BEAT_VISUAL_ROW);
+}
+
+// BPM en grands chiffres sur METRO_BPM_BIG_NUM_ROW et la ligne suivante : seuls les chiffres qui
+// changent sont redessinés (un cran = en général le seul chiffre des unités), puis le nom du tempo
+static void drawMetronomeBPM() {
+    int8_t digits[3], shown[3];
+    bpmDigits(currentBPM, digits);
+    if (shownBPM >= 0) bpmDigits(shownBPM, shown);
+    for (byte i = 0; i < 3; i++) {
+        if (shownBPM >= 0 && digits[i] == shown[i]) continue;
+        byte col = METRO_BPM_BIG_NUM_COL + 3 * i;
+        if (digits[i] < 0) bigNum.clearLargeNumber(col, METRO_BPM_BIG_NUM_ROW);
+        else bigNum.displayLargeNumber(digits[i], col, METRO_BPM_BIG_NUM_ROW);
+    }
+    bool nameChanged = shownBPM >= 0 && currentTempoMarking() != shownTempoMarking;
+    shownBPM = currentBPM;
+    if (nameChanged) drawTempoName();
 }
 
 void displayMetronomeScreen() {
@@ -54,11 +189,19 @@ void displayMetronomeScreen() {
     LCD.clear(); // Effacer pour redessiner
 
     // Affichage du statut (RUN/STOP) et de la Signature Rythmique (TS) sur METRO_STATUS_ROW (ligne 0)
-    LCD.setCursor(METRO_STATUS_COL, METRO_STATUS_ROW);
-    if (currentMetroState == METRO_RUNNING) {
-        LCD.print(F("METRO RUN "));
-    } else {
-        LCD.print(F("METRO STOP"));
+    if (LCD_TALL) { // 16x2 : pas de place, les marqueurs de temps montrent déjà la marche
+        LCD.setCursor(METRO_STATUS_COL, METRO_STATUS_ROW);
+        if (currentMetroState == METRO_RUNNING) {
+            LCD.print(F("METRO RUN "));
+        } else {
+            LCD.print(F("METRO STOP"));
+        }
+        // Synchro MIDI : M = maître, S = esclave verrouillé, s = esclave en recherche
+        MidiSync sync = midiSyncMode();
+        if (sync != MIDI_SYNC_OFF) {
+            LCD.setCursor(METRO_SYNC_COL, METRO_STATUS_ROW);
+            LCD.print(sync == MIDI_SYNC_MASTER ? 'M' : (midiLocked() ? 'S' : 's'));
+        }
     }
     LCD.setCursor(METRO_TS_COL, METRO_TS_ROW);
     LCD.print(F("TS:"));
@@ -75,104 +218,90 @@ void displayMetronomeScreen() {
     else tsTextLen++;
     clearRestOfLine(METRO_TS_COL + tsTextLen , METRO_TS_ROW);;
 
-    // Affichage du BPM en grands chiffres sur METRO_BPM_BIG_NUM_ROW (lignes 1 et 2)
-    if (currentBPM < 10) { // Normalement MIN_BPM est > 10
-        bigNum.clearLargeNumber(METRO_BPM_BIG_NUM_COL, METRO_BPM_BIG_NUM_ROW);
-        bigNum.clearLargeNumber(METRO_BPM_BIG_NUM_COL + 3, METRO_BPM_BIG_NUM_ROW);
-        bigNum.displayLargeNumber(currentBPM, METRO_BPM_BIG_NUM_COL + 6, METRO_BPM_BIG_NUM_ROW);
-    } else if (currentBPM < 100) {
-        bigNum.clearLargeNumber(METRO_BPM_BIG_NUM_COL, METRO_BPM_BIG_NUM_ROW);
-        bigNum.displayLargeNumber(currentBPM / 10, METRO_BPM_BIG_NUM_COL + 3, METRO_BPM_BIG_NUM_ROW);
-        bigNum.displayLargeNumber(currentBPM % 10, METRO_BPM_BIG_NUM_COL + 6, METRO_BPM_BIG_NUM_ROW);
-    } else {
-        bigNum.displayLargeNumber(currentBPM / 100, METRO_BPM_BIG_NUM_COL, METRO_BPM_BIG_NUM_ROW);
-        bigNum.displayLargeNumber((currentBPM / 10) % 10, METRO_BPM_BIG_NUM_COL + 3, METRO_BPM_BIG_NUM_ROW);
-        bigNum.displayLargeNumber(currentBPM % 10, METRO_BPM_BIG_NUM_COL + 6, METRO_BPM_BIG_NUM_ROW);
-    }
-
-    // Gestion de METRO_BEAT_VISUAL_ROW (ligne 3)
-    LCD.setCursor(0, METRO_BEAT_VISUAL_ROW);
-    for (byte c = 0; c < LCD_COLS; c++) { LCD.print(" "); } // Effacer toute la ligne d'abord
-
-    // --- AJOUT : Affichage du nom du Tempo Classique ---
-    const char* currentTempoClassName = nullptr;
-    for (byte i = 0; i < NUM_TEMPO_PRESETS; i++) {
-        // tempoPresets est défini dans le .ino et déclaré extern dans conf.h
-        // NUM_TEMPO_PRESETS est défini dans conf.h
-        if (tempoPresets[i].bpm == currentBPM) {
-            currentTempoClassName = tempoPresets[i].name;
-            break;
-        }
-    }
-
-    if (currentTempoClassName != nullptr) {
-        // Calculer la position de départ pour le nom du tempo
-        // Il sera affiché APRÈS les marqueurs de temps pour la signature actuelle.
-        // Les marqueurs de temps vont de METRO_BEAT_MARKER_START_COL
-        // jusqu'à METRO_BEAT_MARKER_START_COL + timeSignatureNum - 1.
-        byte tempoNameStartCol = METRO_BEAT_MARKER_START_COL + timeSignatureNum;
-
-        // Ajouter un espace de séparation si possible
-        if (tempoNameStartCol < LCD_COLS -1 ) { // -1 pour laisser de la place au moins pour 1 caractère du nom
-            LCD.setCursor(tempoNameStartCol, METRO_BEAT_VISUAL_ROW);
-            LCD.print(" "); // Espace séparateur
-            tempoNameStartCol++;
-        }
+    shownBPM = -1; // Écran effacé : tous les chiffres sont à écrire
+    drawMetronomeBPM();
 
-        // Vérifier si on a de la place pour afficher le nom
-        if (tempoNameStartCol < LCD_COLS) {
-            LCD.setCursor(tempoNameStartCol, METRO_BEAT_VISUAL_ROW);
-            byte availableSpace = LCD_COLS - tempoNameStartCol;
-            String nameToPrint = String(currentTempoClassName);
+    // Gestion de METRO_BEAT_VISUAL_ROW (dernière ligne)
+    clearRestOfLine(METRO_BEAT_MARKER_START_COL, METRO_BEAT_VISUAL_ROW); // Sur 16x2, la ligne est partagée avec le BPM
+    beatMarkersShown = 0;
 
-            if (nameToPrint.length() > availableSpace) {
-                nameToPrint = nameToPrint.substring(0, availableSpace); // Troncquer si trop long
-            }
-            LCD.print(nameToPrint);
-        }
-    }
+    // --- AJOUT : Affichage du nom du Tempo Classique (tout BPM a une indication) ---
+    // Après les marqueurs de temps (METRO_BEAT_MARKER_START_COL .. + timeSignatureNum - 1)
+    drawTempoName();
     // --- FIN AJOUT ---
         
-    // Positionnement du texte "BPM" selon votre modification
-    LCD.setCursor(METRO_BEAT_VISUAL_COL + 7, METRO_BEAT_VISUAL_ROW - 1); // Ligne 2, colonne 16
-    LCD.print(F("BPM"));
+    // Texte "BPM" à droite des grands chiffres (4 lignes seulement : sur 16x2 la place sert aux marqueurs)
+    if (LCD_TALL) {
+        LCD.setCursor(METRO_BPM_LABEL_COL, METRO_BPM_LABEL_ROW);
+        LCD.print(F("BPM"));
+    }
 
     // Si le métronome est arrêté, les marqueurs sont effacés par le nettoyage de ligne ci-dessus.
     // Si le métronome démarre, handleMetronomeLogic dessinera les marqueurs.
 }
 
+// Métronome autonome : le temps n tombe à n * 60000 / BPM ms du départ. Les échéances s'ajoutent
+// (le retard d'une passe ne se reporte pas sur les temps suivants) et le reste de la division est
+// réparti comme un tracé de Bresenham : la dérive cumulée reste sous la milliseconde à tout BPM.
+static bool millisBeatDue() {
+    unsigned long currentTime = millis();
+    if (currentBPM == 0) return false; // Évite la division par zéro
+    unsigned int fraction = modeState.metro.beatFraction + 60000U % currentBPM;
+    unsigned long beatInterval = 60000U / currentBPM + (fraction >= (unsigned int)currentBPM ? 1 : 0);
+    unsigned long late = currentTime - modeState.metro.lastBeatTime;
+    if (late < beatInterval) return false;
+    late -= beatInterval;
+    if (late >= beatInterval) {
+        // Passe bloquée plus d'un intervalle (mélodie, EEPROM) : un seul temps, grille recalée
+        modeState.metro.lastBeatTime = currentTime;
+        modeState.metro.beatFraction = 0;
+        metronomeTiming.resyncs++;
+    } else {
+        modeState.metro.lastBeatTime += beatInterval;
+        modeState.metro.beatFraction = fraction >= (unsigned int)currentBPM ? fraction - currentBPM : fraction;
+    }
+    metronomeTiming.beats++;
+    if (late > metronomeTiming.maxLateMs) metronomeTiming.maxLateMs = late;
+    return true;
+}
+
+// Tempo changé en marche : la fraction du temps déjà écoulée est gardée et le prochain temps tombe
+// à la même phase au nouveau tempo (ni temps sauté, ni temps doublé)
+static void retimeBeat(int oldBPM, int newBPM) {
+    unsigned long now = millis();
+    unsigned long elapsed = now - modeState.metro.lastBeatTime;
+    unsigned long oldInterval = 60000UL / oldBPM;
+    if (elapsed > oldInterval) elapsed = oldInterval; // Temps dû pas encore vu : il tombe tout de suite
+    modeState.metro.lastBeatTime = now - elapsed * oldBPM / newBPM;
+    modeState.metro.beatFraction = 0;
+}
+
+// Palier de la rampe, au temps fort qui vient d'être battu : interpolation linéaire par mesure
+static void stepTempoRamp() {
+    rampMeasure++;
+    setTempo(rampFromBPM + (long)(rampToBPM - rampFromBPM) * rampMeasure / rampMeasures);
+    if (rampMeasure >= rampMeasures) rampMeasures = 0; // Tempo final atteint, il reste
+}
+
 void handleMetronomeLogic() {
     if (currentMetroState == METRO_RUNNING) {
-        unsigned long currentTime = millis();
-        if (currentBPM == 0) return; // Évite la division par zéro
-        unsigned long beatInterval = 60000UL / currentBPM;
-
-        if (currentTime - lastMetroBeatTime >= beatInterval) {
-            lastMetroBeatTime = currentTime;
-
-            currentBeatInMeasure++;
-            if (currentBeatInMeasure > timeSignatureNum || currentBeatInMeasure == 0) { // currentBeatInMeasure == 0 pour le tout premier temps
-                currentBeatInMeasure = 1;
-                // Début d'une nouvelle mesure : effacer les anciens marqueurs
-                for (byte b = 0; b < timeSignatureNum; ++b) {
-                    // S'assurer de ne pas écrire par-dessus "BPM" si METRO_BEAT_VISUAL_ROW est la même
-                    // et que MAX_TIME_SIGNATURE_NUMERATOR est grand.
-                    // Avec "BPM" sur la ligne du dessus, pas de souci ici.
-                    LCD.setCursor(METRO_BEAT_MARKER_START_COL + b, METRO_BEAT_VISUAL_ROW);
-                    LCD.print(" "); // Efface la position du marqueur
-                }
+        // Synchro MIDI : les temps viennent de l'horloge (Timer1 du maître ou boucle de phase de l'esclave)
+        bool beatDue = midiSyncMode() == MIDI_SYNC_OFF ? millisBeatDue() : midiBeatDue();
+        if (beatDue && stopAtMeasureEnd && modeState.metro.beatInMeasure >= timeSignatureNum) {
+            stopMetronome(); // Dernier temps de la mesure joué : le temps fort suivant n'est pas battu
+            return;
+        }
+        if (beatDue) {
+            modeState.metro.beatInMeasure++;
+            if (modeState.metro.beatInMeasure > timeSignatureNum || modeState.metro.beatInMeasure == 0) { // beatInMeasure == 0 pour le tout premier temps
+                modeState.metro.beatInMeasure = 1; // Début d'une nouvelle mesure
             }
 
-            playMetronomeBeatSound(currentBeatInMeasure == 1); // Joue le son du temps
-
-            // Afficher le marqueur de temps actuel
-            int beatDisplayColumn = METRO_BEAT_MARKER_START_COL + (currentBeatInMeasure - 1);
-            // Vérifier que la colonne est valide et dans les limites de l'écran
-            if (beatDisplayColumn < (METRO_BEAT_MARKER_START_COL + MAX_TIME_SIGNATURE_NUMERATOR) && beatDisplayColumn < LCD_COLS) {
-                 LCD.setCursor(beatDisplayColumn, METRO_BEAT_VISUAL_ROW);
-                 LCD.write(METRO_BEAT_MARKER_CHAR); // Affiche le caractère upperBar
-            }
+            playMetronomeBeatSound(modeState.metro.beatInMeasure == 1); // Le son part tout de suite...
+            midiBeatNote(modeState.metro.beatInMeasure == 1);
+            requestDisplay(DISP_PRIO_BEAT, drawBeatMarkers);   // ...l'affichage passe par l'ordonnanceur
             resetActivityTimer();
+            if (modeState.metro.beatInMeasure == 1 && rampMeasures != 0) stepTempoRamp();
         }
     } else { // currentMetroState == METRO_STOPPED
         // Aucune action dynamique d'affichage des temps n'est nécessaire ici,
@@ -180,63 +309,161 @@ void handleMetronomeLogic() {
     }
 }
 
+void stopMetronomeAtMeasureEnd() {
+    if (currentMetroState == METRO_RUNNING) stopAtMeasureEnd = true;
+}
+
+void resetBeatMarkers() {
+    beatMarkersShown = 0;
+}
+
+// Met à jour les marqueurs de temps (ligne METRO_BEAT_VISUAL_ROW) d'après beatInMeasure.
+// N'écrit que les cases qui changent : un marqueur par temps, effacement complet en début de mesure.
+void drawBeatMarkers() {
+    if (modeState.metro.beatInMeasure < beatMarkersShown) { // Nouvelle mesure : effacer les anciens marqueurs
+        LCD.setCursor(METRO_BEAT_MARKER_START_COL, METRO_BEAT_VISUAL_ROW);
+        for (byte b = 0; b < beatMarkersShown; ++b) { LCD.print(" "); }
+        beatMarkersShown = 0;
+    }
+    if (beatMarkersShown < modeState.metro.beatInMeasure) {
+        LCD.setCursor(METRO_BEAT_MARKER_START_COL + beatMarkersShown, METRO_BEAT_VISUAL_ROW);
+        while (beatMarkersShown < modeState.metro.beatInMeasure) {
+            // Rester dans les limites de l'écran (MAX_TIME_SIGNATURE_NUMERATOR peut être grand)
+            if (METRO_BEAT_MARKER_START_COL + beatMarkersShown >= LCD_COLS) break;
+            LCD.write(METRO_BEAT_MARKER_CHAR); // Affiche le caractère upperBar
+            beatMarkersShown++;
+        }
+    }
+}
+
 void playMetronomeBeatSound(bool isAccent) {
-    noTone(BUZZER_PIN); // Arrêter le son précédent au cas où
+    // Remplace le temps précédent, coupe un clic de l'interface, attend derrière une alarme
     if (isAccent) {
-        tone(BUZZER_PIN, METRONOME_ACCENT_FREQ, METRONOME_ACCENT_DURATION);
+        playSound(SOUND_BEAT, METRONOME_ACCENT_FREQ, METRONOME_ACCENT_DURATION);
     } else {
-        tone(BUZZER_PIN, METRONOME_CLICK_FREQ, METRONOME_CLICK_DURATION);
+        playSound(SOUND_BEAT, METRONOME_CLICK_FREQ, METRONOME_CLICK_DURATION);
     }
 }
 
+void setTempo(int bpm) {
+    bpm = constrain(bpm, MIN_BPM, MAX_BPM);
+    if (bpm == currentBPM) return;
+    if (currentMetroState == METRO_RUNNING && midiSyncMode() == MIDI_SYNC_OFF) retimeBeat(currentBPM, bpm);
+    currentBPM = bpm;
+    midiTempoChanged(); // Maître : période de l'horloge recalculée dès l'impulsion suivante
+    tempoSavePending = true;
+    tempoChangedAt = millis();
+    if (currentMode == MODE_METRONOME) requestDisplay(DISP_PRIO_SECONDS, drawMetronomeBPM);
+}
+
+void startTempoRamp(int targetBPM, byte measures) {
+    targetBPM = constrain(targetBPM, MIN_BPM, MAX_BPM);
+    if (currentMetroState != METRO_RUNNING || measures == 0 || targetBPM == currentBPM) return;
+    rampFromBPM = currentBPM;
+    rampToBPM = targetBPM;
+    rampMeasure = 0;
+    rampMeasures = measures;
+}
+
+void serviceTempo() {
+    if (rampMeasures != 0) return; // Rampe en cours : enregistrée une fois, au tempo où elle s'arrête
+    if (tempoSavePending && millis() - tempoChangedAt >= TEMPO_SAVE_DELAY_MS) flushTempo();
+}
+
+void flushTempo() {
+    if (!tempoSavePending) return;
+    tempoSavePending = false;
+    saveBPMToEEPROM(currentBPM);
+}
+
 void saveBPMToEEPROM(int bpmValue) {
-    EEPROM.put(EEPROM_ADDR_METRONOME_BPM, bpmValue);
+    settings.bpm = bpmValue;
+    saveSettings();
+}
+
+// --- Indications de tempo ---
+
+byte findTempoMarking(int bpm) {
+    // Dernière plage dont le début est <= bpm (table triée) ; en dessous de la première : la première
+    byte low = 0, high = NUM_TEMPO_MARKINGS - 1;
+    while (low < high) {
+        byte mid = (low + high + 1) / 2;
+        if ((int)pgm_read_byte(&tempoMarkings[mid].minBpm) <= bpm) low = mid;
+        else high = mid - 1;
+    }
+    return low;
+}
+
+byte currentTempoMarking() {
+    static int cachedBPM = -1; // Recherche refaite seulement quand currentBPM change
+    static byte cachedIndex = 0;
+    if (currentBPM != cachedBPM) {
+        cachedIndex = findTempoMarking(currentBPM);
+        cachedBPM = currentBPM;
+    }
+    return cachedIndex;
+}
+
+byte printTempoMarkingName(byte index, byte maxLen) {
+    const char* name = tempoMarkings[index].name;
+    byte len = 0;
+    for (; len < maxLen; len++) {
+        char c = pgm_read_byte(name + len);
+        if (c == '\0') break;
+        LCD.print(c);
+    }
+    return len;
 }
 
 // Fonctions pour le menu de réglage de la signature rythmique du métronome
 void enterTSMetroMenu() {
     resetActivityTimer();
-    currentMode = MODE_MENU_TS_METRO;
     currentTSEditState = EDIT_NUM; // Commencer par éditer le numérateur
-    encoder.setPosition(timeSignatureNum); // Initialiser l'encodeur avec la valeur du numérateur
-    lastEncoderMenuPos = timeSignatureNum; // Pour la navigation relative si vous l'utilisez ainsi
     displayTSMetroMenu();
 }
 
+// Ligne d'une option du menu TS : les trois options sur 4 lignes, l'option en cours seule sur 16x2
+static byte tsMenuRow(TSEditState item) { return LCD_TALL ? MENU_FIRST_ROW + item : MENU_FIRST_ROW; }
+
 void displayTSMetroMenu() {
     LCD.clear();
     LCD.setCursor(0, 0);
-    LCD.print(F("Signature Rythmique")); // Titre
+    LCD.print(LCD_COLS >= textLen("Signature Rythmique") ? F("Signature Rythmique") : F("Signature")); // Titre
 
     // Affichage Numérateur
-    LCD.setCursor(0, 1);
-    LCD.print(currentTSEditState == EDIT_NUM ? F(">") : F(" "));
-    LCD.print(F("Num: "));
-    if (timeSignatureNum < 10) LCD.print(F(" ")); // Alignement
-    LCD.print(timeSignatureNum);
-    LCD.print(F(" (")); LCD.print(MIN_TIME_SIGNATURE_NUMERATOR);
-    LCD.print(F("-")); LCD.print(MAX_TIME_SIGNATURE_NUMERATOR); LCD.print(F(")"));
-    clearRestOfLine(strlen(" Num: XX (AA-BB)") + 1, 1);
-
+    if (LCD_TALL || currentTSEditState == EDIT_NUM) {
+        LCD.setCursor(0, tsMenuRow(EDIT_NUM));
+        LCD.print(currentTSEditState == EDIT_NUM ? F(">") : F(" "));
+        LCD.print(F("Num: "));
+        if (timeSignatureNum < 10) LCD.print(F(" ")); // Alignement
+        LCD.print(timeSignatureNum);
+        LCD.print(F(" (")); LCD.print(MIN_TIME_SIGNATURE_NUMERATOR);
+        LCD.print(F("-")); LCD.print(MAX_TIME_SIGNATURE_NUMERATOR); LCD.print(F(")"));
+        clearRestOfLine(textLen(" Num: XX (AA-BB)") + 1, tsMenuRow(EDIT_NUM));
+    }
 
     // Affichage Dénominateur
-    LCD.setCursor(0, 2);
-    LCD.print(currentTSEditState == EDIT_DEN ? F(">") : F(" "));
-    LCD.print(F("Den: "));
-    if (timeSignatureDen < 10) LCD.print(F(" ")); // Alignement
-    LCD.print(timeSignatureDen);
-    LCD.print(F(" (")); LCD.print(MIN_TIME_SIGNATURE_DENOMINATOR);
-    LCD.print(F("-")); LCD.print(MAX_TIME_SIGNATURE_DENOMINATOR); LCD.print(F(")"));
-    clearRestOfLine(strlen(" Den: X (A-B)") + 1, 2);
+    if (LCD_TALL || currentTSEditState == EDIT_DEN) {
+        LCD.setCursor(0, tsMenuRow(EDIT_DEN));
+        LCD.print(currentTSEditState == EDIT_DEN ? F(">") : F(" "));
+        LCD.print(F("Den: "));
+        if (timeSignatureDen < 10) LCD.print(F(" ")); // Alignement
+        LCD.print(timeSignatureDen);
+        LCD.print(F(" (")); LCD.print(MIN_TIME_SIGNATURE_DENOMINATOR);
+        LCD.print(F("-")); LCD.print(MAX_TIME_SIGNATURE_DENOMINATOR); LCD.print(F(")"));
+        clearRestOfLine(textLen(" Den: X (A-B)") + 1, tsMenuRow(EDIT_DEN));
+    }
 
     // Affichage Valider
-    LCD.setCursor(0, 3);
-    LCD.print(currentTSEditState == CONFIRM_TS ? F(">") : F(" "));
-    LCD.print(F("Valider & Quitter"));
-    clearRestOfLine(strlen(" Valider & Quitter") + 1, 3);
+    if (LCD_TALL || currentTSEditState == CONFIRM_TS) {
+        LCD.setCursor(0, tsMenuRow(CONFIRM_TS));
+        LCD.print(currentTSEditState == CONFIRM_TS ? F(">") : F(" "));
+        byte len = 1 + LCD.print(LCD_COLS > textLen(" Valider & Quitter") ? F("Valider & Quitter") : F("Valider"));
+        clearRestOfLine(len, tsMenuRow(CONFIRM_TS));
+    }
 }
 
-void navigateTSMetroMenu(int diff) { // diff est déjà relatif grâce à la gestion dans handleEncoder
+void navigateTSMetroMenu(int diff) { // diff : crans de l'encodeur (relatif)
     int tempVal;
     bool changed = false;
 
@@ -246,7 +473,6 @@ void navigateTSMetroMenu(int diff) { // diff est déjà relatif grâce à la ges
         if (tempVal > MAX_TIME_SIGNATURE_NUMERATOR) tempVal = MAX_TIME_SIGNATURE_NUMERATOR;
         if (timeSignatureNum != (byte)tempVal) {
             timeSignatureNum = (byte)tempVal;
-            encoder.setPosition(timeSignatureNum); // Mettre à jour la position de l'encodeur
             changed = true;
         }
     } else if (currentTSEditState == EDIT_DEN) {
@@ -255,7 +481,6 @@ void navigateTSMetroMenu(int diff) { // diff est déjà relatif grâce à la ges
         if (tempVal > MAX_TIME_SIGNATURE_DENOMINATOR) tempVal = MAX_TIME_SIGNATURE_DENOMINATOR;
         if (timeSignatureDen != (byte)tempVal) {
             timeSignatureDen = (byte)tempVal;
-            encoder.setPosition(timeSignatureDen); // Mettre à jour la position de l'encodeur
             changed = true;
         }
     }
@@ -264,26 +489,24 @@ void navigateTSMetroMenu(int diff) { // diff est déjà relatif grâce à la ges
     if (changed) {
         playClickSound();
         resetActivityTimer();
-        lastEncoderMenuPos = encoder.getPosition(); // Mettre à jour pour la prochaine diff relative
         displayTSMetroMenu();
     }
 }
 
-void selectTSMetroMenuItem() {
-    playClickSound();
+void selectTSMetroMenuItem(ButtonEvent event) {
+    if (!isClickEvent(event)) return;
     resetActivityTimer();
 
     if (currentTSEditState == EDIT_NUM) {
         currentTSEditState = EDIT_DEN;
-        encoder.setPosition(timeSignatureDen); // Préparer l'encodeur pour éditer le dénominateur
-        lastEncoderMenuPos = timeSignatureDen; 
     } else if (currentTSEditState == EDIT_DEN) {
         currentTSEditState = CONFIRM_TS;
         // Pas besoin de changer la position de l'encodeur ici, car on ne règle plus de valeur
     } else if (currentTSEditState == CONFIRM_TS) {
-        EEPROM.update(EEPROM_ADDR_METRONOME_TS_NUM, timeSignatureNum);
-        EEPROM.update(EEPROM_ADDR_METRONOME_TS_DEN, timeSignatureDen);
-        enterMainMenu(); // Revenir au menu principal des réglages
+        settings.tsNum = timeSignatureNum;
+        settings.tsDen = timeSignatureDen;
+        saveSettings();
+        setMode(MODE_MENU_MAIN); // Revenir au menu principal des réglages
         return; // Important pour ne pas juste rafraîchir le menu TS
     }
     displayTSMetroMenu();
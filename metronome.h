@@ -4,14 +4,17 @@
 
 #include <Arduino.h>
 #include <EEPROM.h> // Important pour les fonctions EEPROM
-#include "LiquidCrystal_I2C.h"
-#include "BigNumbers_I2C.h"
+#include "ecran.h"         // Afficheur (LCD ou OLED) : objets LCD et bigNum
 #include "RotaryEncoder.h" 
 #include "conf.h"          
+#include "affichage.h" // Ordonnanceur de rafraîchissement
+#include "modes.h"     // Table des modes (setMode)
+#include "geometrie.h" // Disposition de l'écran (panneau choisi à la compilation)
+#include "midi.h"      // Horloge MIDI maître / esclave (MIDI_ENABLED)
+#include "reglages.h"  // Réglages persistants (BPM, signature)
+#include "buzzer.h"    // Arbitrage du buzzer
 
 // Références externes aux objets et variables globales définis dans le .ino principal
-extern LiquidCrystal_I2C LCD;
-extern BigNumbers_I2C bigNum;
 extern RotaryEncoder encoder;
 
 // Extern pour les états et variables globales du .ino principal que ce module utilise/modifie
@@ -19,32 +22,61 @@ extern enum Mode currentMode;
 extern enum MetronomeRunState currentMetroState; 
 
 extern int currentBPM;
-extern unsigned long lastMetroBeatTime;
-extern byte currentBeatInMeasure;
 extern byte timeSignatureNum;
 extern byte timeSignatureDen; // <<< CETTE LIGNE DOIT ÊTRE LÀ
-extern int metroEncoderLastPos;
-extern int lastEncoderMenuPos; 
 
 // Fonctions utilitaires du .ino principal que ce module appelle
 void resetActivityTimer();
 void playClickSound();
-void enterMainMenu(); 
-void saveChoiceToEEPROM(int address, byte value); 
+void checkIdleSleep();
 void clearRestOfLine(byte startCol, byte row); 
 
+// Précision du métronome autonome depuis le départ (hors synchro MIDI), envoyée à l'arrêt
+struct MetronomeTiming {
+  unsigned int beats;      // Temps battus
+  unsigned long maxLateMs; // Plus grand retard d'un temps sur son échéance (latence de loop())
+  unsigned int resyncs;    // Grille recalée après une passe bloquée plus d'un intervalle
+};
+extern MetronomeTiming metronomeTiming;
+
 // Fonctions spécifiques au module Métronome
 void setupMetronome(); 
+void reportMetronomeTiming();
+
+// Gestionnaires de MODE_METRONOME (modes.h)
 void enterMetronomeMode();
+void exitMetronomeMode();
+void tickMetronomeMode();
+void handleMetronomeEncoder(int delta);
+void handleMetronomeButton(ButtonEvent event);
+
 void displayMetronomeScreen();
 void handleMetronomeLogic();
+void startMetronome(bool fromTop);  // fromTop : la mesure repart du premier temps
+void stopMetronome();               // Envoie aussi la précision des temps battus (reportMetronomeTiming)
+void stopMetronomeAtMeasureEnd();   // S'arrête au lieu de battre le prochain temps fort (mode Pratique)
+void resetBeatMarkers();            // La ligne des marqueurs vient d'être effacée par l'appelant
 void playMetronomeBeatSound(bool isAccent);
+void drawBeatMarkers();
 void saveBPMToEEPROM(int bpmValue);
 
+// Tempo modifiable en marche (encodeur, rampes) : phase du temps en cours gardée, grands chiffres
+// redessinés chiffre par chiffre en MODE_METRONOME, enregistrement TEMPO_SAVE_DELAY_MS après le
+// dernier changement (l'EEPROM n'est pas programmée à chaque cran)
+void setTempo(int bpm);
+void startTempoRamp(int targetBPM, byte measures); // Palier à chaque temps fort, jusqu'à targetBPM ; coupée par l'arrêt ou l'encodeur
+void serviceTempo();                               // Enregistrement différé du BPM, à chaque passe du mode
+void flushTempo();                                 // Enregistre tout de suite un BPM en attente (sortie du mode)
+
+// Indications de tempo (tempoMarkings, PROGMEM)
+byte findTempoMarking(int bpm);                      // Recherche dichotomique de la plage contenant bpm
+byte currentTempoMarking();                          // Indication de currentBPM (mise en cache)
+byte printTempoMarkingName(byte index, byte maxLen); // Nom à la position courante (au plus maxLen caractères), rend la longueur
+
 // Fonctions pour le sous-menu de la Signature Rythmique (TS) du métronome
 void enterTSMetroMenu();
 void displayTSMetroMenu();
 void navigateTSMetroMenu(int diff);
-void selectTSMetroMenuItem();
+void selectTSMetroMenuItem(ButtonEvent event);
 
 #endif // METRONOME_H
\ No newline at end of file
@@ -0,0 +1,375 @@
+// midi.cpp - UART MIDI, horloge maître (Timer1) et boucle de phase de l'esclave
+
+#include "midi.h"
+
+#if MIDI_ENABLED
+
+#include <util/atomic.h>
+#include "rapport.h"
+#include "reglages.h"
+
+NullReport Report;
+MidiStats midiStats;
+
+extern int currentBPM;
+
+static const byte MIDI_CLOCK_MSG = 0xF8;
+static const byte MIDI_START_MSG = 0xFA;
+static const byte MIDI_CONTINUE_MSG = 0xFB;
+static const byte MIDI_STOP_MSG = 0xFC;
+static const byte MIDI_NOTE_ON = 0x90;
+static const byte MIDI_NOTE_OFF = 0x80;
+
+static const unsigned long TIMER1_COUNTS_PER_MINUTE = 60000000UL / 4 / MIDI_PPQN; // Pas de 4 µs : 625000 / BPM par impulsion
+static const unsigned long MIN_TICK_US = 60000000UL / MIDI_PPQN / MAX_BPM;
+static const unsigned long MAX_TICK_US = 60000000UL / MIDI_PPQN / MIN_BPM;
+static_assert(TIMER1_COUNTS_PER_MINUTE / MIN_BPM <= 65535, "MIN_BPM : période d'horloge trop longue pour OCR1A");
+
+static MidiSync syncMode = MIDI_SYNC_OFF;
+static byte soundingNote = 0; // Note du dernier temps (0 = aucune)
+
+// --- Émission : file d'octets + un octet temps réel prioritaire ---
+static volatile byte txRing[MIDI_TX_RING_SIZE];
+static volatile byte txHead = 0; // Écrit par loop()
+static volatile byte txTail = 0; // Écrit par l'ISR
+static volatile byte realtimePending = 0; // 0 = aucun (les octets temps réel valent 0xF8..0xFF)
+
+ISR(USART_UDRE_vect) {
+  if (realtimePending) {
+    UDR0 = realtimePending;
+    realtimePending = 0;
+  } else if (txTail != txHead) {
+    UDR0 = txRing[txTail];
+    txTail = (txTail + 1) % MIDI_TX_RING_SIZE;
+  } else {
+    UCSR0B &= ~_BV(UDRIE0);
+  }
+}
+
+// Interruptions coupées (ISR ou bloc atomique) : l'octet passe devant la file, au besoin entre
+// deux octets d'un message (les messages temps réel le permettent)
+static void sendRealtime(byte b) {
+  while (realtimePending) { // Un seul octet prioritaire en attente : attendre qu'il parte
+    if (UCSR0A & _BV(UDRE0)) { UDR0 = realtimePending; realtimePending = 0; }
+  }
+  if (UCSR0A & _BV(UDRE0)) {
+    UDR0 = b;
+  } else {
+    realtimePending = b;
+    UCSR0B |= _BV(UDRIE0);
+  }
+}
+
+static void sendByte(byte b) {
+  byte next = (txHead + 1) % MIDI_TX_RING_SIZE;
+  while (next == txTail) {} // File pleine : l'ISR d'émission la vide
+  txRing[txHead] = b;
+  txHead = next;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { UCSR0B |= _BV(UDRIE0); }
+}
+
+static void noteOff() {
+  if (!soundingNote) return;
+  sendByte(MIDI_NOTE_OFF | MIDI_BEAT_CHANNEL);
+  sendByte(soundingNote);
+  sendByte(0);
+  soundingNote = 0;
+}
+
+// --- Maître : horloge du Timer1 ---
+static volatile byte masterClockInBeat = 0;
+static volatile byte beatsPending = 0;
+static unsigned int tickBpm = DEFAULT_BPM;
+static unsigned int tickBase = 0;      // Comptes de 4 µs par impulsion (partie entière)
+static unsigned int tickRemainder = 0; // Reste de TIMER1_COUNTS_PER_MINUTE / BPM
+static unsigned int tickAccumulator = 0;
+
+// Interruptions coupées
+static void masterTick() {
+  sendRealtime(MIDI_CLOCK_MSG);
+  if (masterClockInBeat == 0 && beatsPending < 255) beatsPending++;
+  if (++masterClockInBeat >= MIDI_PPQN) masterClockInBeat = 0;
+}
+
+ISR(TIMER1_COMPA_vect) {
+  // Période suivante de tickBase ou tickBase + 1 comptes : la moyenne vaut exactement 625000 / BPM
+  tickAccumulator += tickRemainder;
+  if (tickAccumulator >= tickBpm) {
+    tickAccumulator -= tickBpm;
+    OCR1A = tickBase;
+  } else {
+    OCR1A = tickBase - 1;
+  }
+  masterTick();
+}
+
+static void stopMasterClock() {
+  TIMSK1 &= ~_BV(OCIE1A);
+  TCCR1B = 0;
+}
+
+// --- Esclave : réception horodatée et boucle de phase ---
+struct RxEvent {
+  byte type;
+  unsigned long time; // micros() à la réception
+};
+
+static volatile RxEvent rxQueue[MIDI_RX_QUEUE_SIZE];
+static volatile byte rxHead = 0; // Écrit par l'ISR
+static volatile byte rxTail = 0; // Écrit par serviceMidi()
+
+static bool havePrevious = false;   // Une impulsion reçue depuis le dernier silence
+static bool havePeriod = false;     // Période estimée : la boucle prévoit l'impulsion suivante
+static bool locked = false;
+static unsigned long previousClockUs = 0;
+static unsigned long nextClockUs = 0;   // Instant prévu de la prochaine impulsion
+static unsigned long periodFx = 0;      // Période estimée (µs x 16)
+static byte goodClocks = 0;             // Impulsions consécutives dans la tolérance
+static unsigned long lockStartMs = 0;
+static byte slaveClockInBeat = 0;       // Rang de la prochaine impulsion dans la noire (0 = temps)
+static bool beatScheduled = false;      // Le temps de la prochaine impulsion de rang 0 est déjà prévu
+static bool beatArmed = false;
+static unsigned long beatDueUs = 0;
+static int tempoBPM = 0;
+static MidiTransport pendingTransport = MIDI_NONE;
+
+ISR(USART_RX_vect) {
+  unsigned long now = micros(); // Fin du bit de stop : retard fixe d'un octet (320 µs), sans gigue
+  byte status = UCSR0A;
+  byte b = UDR0;
+  if (status & (_BV(FE0) | _BV(DOR0))) { midiStats.rxErrors++; return; }
+  if (b != MIDI_CLOCK_MSG && b != MIDI_START_MSG && b != MIDI_CONTINUE_MSG && b != MIDI_STOP_MSG) return; // Le reste ne concerne pas le métronome
+  byte next = (rxHead + 1) % MIDI_RX_QUEUE_SIZE;
+  if (next == rxTail) return; // File pleine : impulsion perdue, la boucle de phase s'en remet
+  rxQueue[rxHead].type = b;
+  rxQueue[rxHead].time = now;
+  rxHead = next;
+}
+
+static bool popRxEvent(RxEvent& event) {
+  bool available = false;
+  noInterrupts();
+  if (rxTail != rxHead) {
+    event.type = rxQueue[rxTail].type;
+    event.time = rxQueue[rxTail].time;
+    rxTail = (rxTail + 1) % MIDI_RX_QUEUE_SIZE;
+    available = true;
+  }
+  interrupts();
+  return available;
+}
+
+static void scheduleBeat(unsigned long at) {
+  beatDueUs = at;
+  beatArmed = true;
+}
+
+static void loseLock() {
+  locked = false;
+  goodClocks = 0;
+  lockStartMs = millis();
+}
+
+static void updateTempo() {
+  unsigned long bpmX16 = (60000000UL * 16 * 16 / MIDI_PPQN) / periodFx; // periodFx est en µs x 16
+  if (tempoBPM == 0 || labs((long)bpmX16 - (long)tempoBPM * 16) > MIDI_TEMPO_HYSTERESIS_X16) {
+    tempoBPM = constrain((int)((bpmX16 + 8) / 16), MIN_BPM, MAX_BPM);
+  }
+}
+
+static void trackClock(unsigned long t) {
+  unsigned long interval = t - previousClockUs;
+  if (!havePrevious || interval > 2 * MAX_TICK_US) { // Première impulsion, ou reprise après un silence
+    havePrevious = true;
+    previousClockUs = t;
+    havePeriod = false;
+    loseLock();
+    return;
+  }
+  previousClockUs = t;
+
+  if (!havePeriod) {
+    periodFx = constrain(interval, MIN_TICK_US, MAX_TICK_US) << 4;
+    nextClockUs = t + (periodFx >> 4);
+    havePeriod = true;
+    updateTempo();
+    return;
+  }
+
+  long error = (long)(t - nextClockUs);
+  unsigned long absError = labs(error);
+  if (absError > (periodFx >> 4) / 2) { // Changement de tempo brutal ou impulsion perdue : recalage
+    midiStats.resyncs++;
+    periodFx = constrain(interval, MIN_TICK_US, MAX_TICK_US) << 4;
+    nextClockUs = t + (periodFx >> 4);
+    loseLock();
+    updateTempo();
+    return;
+  }
+
+  periodFx = constrain((long)periodFx + error / 4, (long)(MIN_TICK_US << 4), (long)(MAX_TICK_US << 4)); // Gain de période 1/64
+  nextClockUs += (periodFx >> 4) + error / 4;                                                           // Gain de phase 1/4
+  updateTempo();
+
+  if (locked) {
+    if (absError > 4UL * MIDI_LOCK_TOLERANCE_US) loseLock();
+    else if (absError > midiStats.maxPhaseErrorUs) midiStats.maxPhaseErrorUs = absError;
+  } else if (absError < MIDI_LOCK_TOLERANCE_US) {
+    if (++goodClocks >= MIDI_PPQN) {
+      locked = true;
+      midiStats.lockMillis = millis() - lockStartMs;
+      midiStats.maxPhaseErrorUs = 0;
+    }
+  } else {
+    goodClocks = 0;
+  }
+}
+
+static void slaveClock(unsigned long t) {
+  midiStats.clocksIn++;
+  if (slaveClockInBeat == 0) {
+    if (!beatScheduled) scheduleBeat(t); // Pas encore de prévision : temps joué à réception
+    beatScheduled = false;
+  }
+  trackClock(t);
+  if (++slaveClockInBeat >= MIDI_PPQN) slaveClockInBeat = 0;
+  if (slaveClockInBeat == 0 && havePeriod) { // Prochaine impulsion = temps : joué à l'instant prévu
+    scheduleBeat(nextClockUs);
+    beatScheduled = true;
+  }
+}
+
+static void slaveTransport(byte type, unsigned long t) {
+  if (type == MIDI_START_MSG) { // La première impulsion après Start est le premier temps
+    slaveClockInBeat = 0;
+    beatArmed = false;
+    beatScheduled = havePeriod && (long)(nextClockUs - t) > 0;
+    if (beatScheduled) scheduleBeat(nextClockUs);
+    pendingTransport = MIDI_START;
+  } else if (type == MIDI_CONTINUE_MSG) {
+    pendingTransport = MIDI_CONTINUE;
+  } else {
+    beatArmed = false;
+    pendingTransport = MIDI_STOP;
+  }
+}
+
+// --- Interface ---
+
+void setupMidi() {
+  if (settings.midiSync >= MIDI_SYNC_COUNT) settings.midiSync = MIDI_SYNC_OFF; // Enregistré par setup()
+  syncMode = (MidiSync)settings.midiSync;
+  UBRR0H = 0;
+  UBRR0L = F_CPU / 16 / MIDI_BAUD - 1;  // 31 à 16 MHz : 31250 bauds exacts
+  UCSR0A = 0;
+  UCSR0C = _BV(UCSZ01) | _BV(UCSZ00);   // 8N1
+  UCSR0B = _BV(RXEN0) | _BV(TXEN0) | _BV(RXCIE0);
+}
+
+MidiSync midiSyncMode() {
+  return syncMode;
+}
+
+void setMidiSyncMode(MidiSync mode) {
+  midiStop();
+  syncMode = mode;
+  havePrevious = havePeriod = false;
+  beatArmed = beatScheduled = false;
+  tempoBPM = 0;
+  loseLock();
+  pendingTransport = MIDI_NONE;
+  settings.midiSync = mode;
+  saveSettings();
+}
+
+void serviceMidi() {
+  RxEvent event;
+  while (popRxEvent(event)) {
+    if (syncMode != MIDI_SYNC_SLAVE) continue; // Maître ou arrêt : le flux entrant est ignoré
+    if (event.type == MIDI_CLOCK_MSG) slaveClock(event.time);
+    else slaveTransport(event.type, event.time);
+  }
+}
+
+void midiStart() {
+  if (syncMode != MIDI_SYNC_MASTER) return;
+  tickBpm = constrain(currentBPM, MIN_BPM, MAX_BPM);
+  tickBase = TIMER1_COUNTS_PER_MINUTE / tickBpm;
+  tickRemainder = TIMER1_COUNTS_PER_MINUTE % tickBpm;
+  tickAccumulator = 0;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    sendRealtime(MIDI_START_MSG);
+    masterClockInBeat = 0;
+    beatsPending = 0;
+    TCCR1B = 0;
+    TCCR1A = 0;
+    TCNT1 = 0;
+    OCR1A = tickBase - 1;
+    TIFR1 = _BV(OCF1A);
+    TIMSK1 |= _BV(OCIE1A);
+    TCCR1B = _BV(WGM12) | _BV(CS11) | _BV(CS10); // CTC, prédiviseur 64 : 4 µs par compte
+    masterTick(); // Première impulsion après Start = premier temps, tout de suite
+  }
+}
+
+void midiTempoChanged() {
+  if (syncMode != MIDI_SYNC_MASTER || !TCCR1B) return;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { // L'impulsion en cours finit à l'ancienne période
+    tickBpm = constrain(currentBPM, MIN_BPM, MAX_BPM);
+    tickBase = TIMER1_COUNTS_PER_MINUTE / tickBpm;
+    tickRemainder = TIMER1_COUNTS_PER_MINUTE % tickBpm;
+    if (tickAccumulator >= tickBpm) tickAccumulator = 0;
+  }
+}
+
+void midiStop() {
+  if (syncMode == MIDI_SYNC_MASTER && TCCR1B) {
+    stopMasterClock();
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+      sendRealtime(MIDI_STOP_MSG);
+      beatsPending = 0;
+    }
+  }
+  beatArmed = false;
+  noteOff();
+}
+
+bool midiBeatDue() {
+  if (syncMode == MIDI_SYNC_MASTER) {
+    bool due = false;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+      if (beatsPending) { beatsPending--; due = true; }
+    }
+    return due;
+  }
+  if (syncMode == MIDI_SYNC_SLAVE && beatArmed && (long)(micros() - beatDueUs) >= 0) {
+    beatArmed = false;
+    return true;
+  }
+  return false;
+}
+
+void midiBeatNote(bool accent) {
+  if (syncMode == MIDI_SYNC_OFF) return;
+  noteOff();
+  soundingNote = accent ? MIDI_NOTE_ACCENT : MIDI_NOTE_BEAT;
+  sendByte(MIDI_NOTE_ON | MIDI_BEAT_CHANNEL);
+  sendByte(soundingNote);
+  sendByte(MIDI_BEAT_VELOCITY);
+}
+
+MidiTransport midiTransportEvent() {
+  MidiTransport event = pendingTransport;
+  pendingTransport = MIDI_NONE;
+  return event;
+}
+
+int midiTempoBPM() {
+  return syncMode == MIDI_SYNC_SLAVE && havePeriod ? tempoBPM : 0;
+}
+
+bool midiLocked() {
+  return syncMode == MIDI_SYNC_SLAVE && locked;
+}
+
+#endif // MIDI_ENABLED
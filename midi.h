@@ -0,0 +1,74 @@
+// midi.h - Horloge MIDI (24 PPQN) du métronome : maître ou esclave, sur l'UART du Nano
+//
+// Compilé seulement avec MIDI_ENABLED (conf.h) : l'UART passe à 31250 bauds et ce module la pilote
+// directement (ses propres ISR d'émission et de réception, HardwareSerial n'est plus lié). Les
+// rapports texte (rapport.h) sont alors coupés, ils seraient lus comme des notes par l'appareil
+// MIDI. Sans MIDI_ENABLED, les fonctions ci-dessous sont des coquilles vides.
+//
+// Maître : le Timer1 (CTC, pas de 4 µs, reste de la division réparti comme un tracé de Bresenham)
+// émet l'horloge 0xF8 depuis son ISR ; un octet temps réel passe devant les octets en attente
+// (permis par la norme), la gigue de sortie est donc d'au plus un octet (320 µs). Un temps sur
+// MIDI_PPQN impulsions est signalé au métronome ; Start (0xFA) et Stop (0xFC) suivent le
+// départ et l'arrêt.
+//
+// Esclave : l'ISR de réception horodate chaque 0xF8 (micros()). Une boucle à verrouillage de phase
+// du second ordre suit la période : l'erreur entre l'impulsion prévue et l'impulsion reçue corrige
+// la phase (1/4) et la période (1/64). Les temps sont joués à l'instant PRÉVU par la boucle (la
+// gigue de l'horloge reçue est lissée), currentBPM suit le tempo estimé, et Start / Continue /
+// Stop pilotent METRO_RUNNING / METRO_STOPPED. Verrouillé = erreur < MIDI_LOCK_TOLERANCE_US
+// pendant une noire entière.
+//
+// Dans les deux modes, chaque temps joué envoie une note (canal MIDI_BEAT_CHANNEL, accent sur le
+// premier temps) : tools/midiclock.py s'en sert pour mesurer la gigue de l'horloge émise et le
+// temps de verrouillage de l'esclave, sur un port série ou un pseudo-terminal Linux.
+#ifndef MIDI_H
+#define MIDI_H
+
+#include <Arduino.h>
+#include "conf.h"
+
+enum MidiSync : byte { MIDI_SYNC_OFF, MIDI_SYNC_MASTER, MIDI_SYNC_SLAVE, MIDI_SYNC_COUNT };
+enum MidiTransport : byte { MIDI_NONE, MIDI_START, MIDI_CONTINUE, MIDI_STOP };
+
+#if MIDI_ENABLED
+
+struct MidiStats {
+  unsigned long clocksIn;       // Impulsions 0xF8 reçues
+  unsigned int resyncs;         // Erreur > une demi-période : boucle recalée sur l'impulsion reçue
+  unsigned int rxErrors;        // Octets reçus avec erreur de trame ou débordement
+  unsigned long lockMillis;     // Durée du dernier verrouillage (premier 0xF8 -> verrouillé)
+  unsigned int maxPhaseErrorUs; // Plus grande erreur de phase une fois verrouillé
+};
+extern MidiStats midiStats;
+
+void setupMidi();                 // UART 31250 bauds, mode de synchro relu dans settings (après loadSettings)
+MidiSync midiSyncMode();
+void setMidiSyncMode(MidiSync mode); // Sauvegardé dans settings.midiSync
+void serviceMidi();               // Boucle de phase de l'esclave, à chaque passe de loop()
+void midiStart();                 // Maître : Start puis horloge au tempo currentBPM (premier temps immédiat)
+void midiStop();                  // Maître : Stop, horloge arrêtée ; esclave : note en cours coupée
+void midiTempoChanged();          // Maître en marche : période des impulsions suivantes au nouveau currentBPM
+bool midiBeatDue();               // Un temps est dû (une fois par temps)
+void midiBeatNote(bool accent);   // Note du temps joué (la précédente est coupée)
+MidiTransport midiTransportEvent(); // Esclave : dernier Start / Continue / Stop reçu, puis MIDI_NONE
+int midiTempoBPM();               // Esclave : tempo estimé (0 = pas encore d'horloge)
+bool midiLocked();
+
+#else
+
+inline void setupMidi() {}
+inline MidiSync midiSyncMode() { return MIDI_SYNC_OFF; }
+inline void setMidiSyncMode(MidiSync) {}
+inline void serviceMidi() {}
+inline void midiStart() {}
+inline void midiStop() {}
+inline void midiTempoChanged() {}
+inline bool midiBeatDue() { return false; }
+inline void midiBeatNote(bool) {}
+inline MidiTransport midiTransportEvent() { return MIDI_NONE; }
+inline int midiTempoBPM() { return 0; }
+inline bool midiLocked() { return false; }
+
+#endif // MIDI_ENABLED
+
+#endif // MIDI_H
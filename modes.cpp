@@ -0,0 +1,40 @@
+// modes.cpp - Répartition des appels vers la table des modes
+
+#include "modes.h"
+#include <string.h>
+
+ModeState modeState; // Zéro au démarrage : état initial de MODE_TIMER, rempli par setupTimer()
+
+static ModeHook hookOf(Mode mode, ModeHook ModeHandlers::*member) {
+  return (ModeHook)pgm_read_ptr(&(MODE_TABLE[mode].*member));
+}
+
+void setMode(Mode mode) {
+  if (mode >= MODE_COUNT) return;
+  ModeHook exitHook = hookOf(currentMode, &ModeHandlers::exit);
+  if (exitHook) exitHook();
+  if (mode != currentMode) memset(&modeState, 0, sizeof(modeState)); // État du nouveau mode : initialisé par enter()
+  currentMode = mode;
+  ModeHook enterHook = hookOf(mode, &ModeHandlers::enter);
+  if (enterHook) enterHook();
+}
+
+void modeTick() {
+  ModeHook tick = hookOf(currentMode, &ModeHandlers::tick);
+  if (tick) tick();
+}
+
+void modeEncoder(int delta) {
+  ModeEncoderHook encoderHook = (ModeEncoderHook)pgm_read_ptr(&MODE_TABLE[currentMode].encoder);
+  if (encoderHook) encoderHook(delta);
+}
+
+void modeButton(ButtonEvent event) {
+  ModeButtonHook buttonHook = (ModeButtonHook)pgm_read_ptr(&MODE_TABLE[currentMode].button);
+  if (buttonHook) buttonHook(event);
+}
+
+void modeRedraw() {
+  ModeHook redraw = hookOf(currentMode, &ModeHandlers::redraw);
+  if (redraw) redraw();
+}
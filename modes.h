@@ -0,0 +1,120 @@
+// modes.h - Table des modes : un descripteur de gestionnaires en PROGMEM par valeur de Mode
+//
+// loop(), handleEncoder(), handleButton() et le réveil de veille ne font plus qu'un appel indexé
+// (modeTick, modeEncoder, modeButton, modeRedraw) dans MODE_TABLE[currentMode]. Ajouter un mode :
+// une valeur dans l'enum Mode (conf.h, avant MODE_COUNT) et une ligne dans MODE_TABLE (.ino).
+// Un gestionnaire nullptr signifie "rien à faire".
+//
+// L'encodeur est lu en relatif : handleEncoder() remet sa position à 0 après chaque lecture et
+// transmet le nombre de crans. Plus aucune position absolue à resynchroniser entre les modes.
+//
+// État propre au mode : un seul mode est actif à la fois, ses variables de travail partagent donc
+// la même zone de SRAM (union anonyme de ModeState). Seul le temps en cours du métronome est à
+// part : MODE_PRACTICE fait tourner métronome et décompte ensemble. Quand le mode change, setMode()
+// remet le tout à zéro avant enter(), qui l'initialise (les rendus en attente de l'ancien mode
+// sont déjà écartés par serviceDisplay()). Ce qui doit
+// survivre à un changement de mode (temps cible, BPM, réglages, position du menu principal) reste
+// en variables globales. Un décompte en cours ou en pause ne quitte jamais MODE_TIMER, le
+// métronome s'arrête en quittant MODE_METRONOME ou MODE_PRACTICE et le chronomètre ne rend la
+// main qu'à zéro.
+#ifndef MODES_H
+#define MODES_H
+
+#include <Arduino.h>
+#include <avr/pgmspace.h>
+#include "conf.h"
+#include "bouton.h"
+
+typedef void (*ModeHook)();
+typedef void (*ModeEncoderHook)(int delta);
+typedef void (*ModeButtonHook)(ButtonEvent event);
+
+struct ModeHandlers {
+  ModeHook enter;           // Entrée dans le mode : état initial et dessin complet de l'écran
+  ModeHook exit;            // Sortie du mode (arrêt du son...)
+  ModeHook tick;            // À chaque passe de loop()
+  ModeEncoderHook encoder;  // Crans de l'encodeur depuis la dernière lecture (signé)
+  ModeButtonHook button;    // Geste du bouton (bouton.h)
+  ModeHook redraw;          // Redessiner l'écran du mode (réveil de veille)
+};
+
+// MODE_TIMER : décompte en cours ou en pause, affichage, séquence de fin
+struct TimerModeState {
+  unsigned long targetEndTime;          // millis() de la fin du décompte en cours
+  long remainingMillis;
+  unsigned long pausedRemainingMillis;
+  unsigned long lastCsUpdateTime;
+  unsigned long blinkSequenceStartTime;
+  unsigned long lastEndBlinkToggleTime;
+  int displayMIN, displaySEC, displayCS;
+  int lastDisplayedMIN, lastDisplayedSEC;
+  int lastPos, newPos;                  // Temps cible en pas de l'encodeur (SECOND_INCREMENT)
+  bool blinkDone : 1;
+  bool isEndSequenceBlinking : 1;
+  bool endBlinkStateIsOn : 1;
+  bool timerResumePending : 1;          // Décompte restauré au démarrage (checkpoint.h), en attente de reprise
+};
+
+// MODE_METRONOME : temps en cours (le BPM et la signature sont des réglages globaux)
+struct MetronomeModeState {
+  unsigned long lastBeatTime;           // Échéance du dernier temps (grille absolue, pas l'instant où il a été vu)
+  unsigned int beatFraction;            // Reste de 60000 / BPM cumulé, en 1/BPM de ms (metronome.cpp)
+  byte beatInMeasure;                   // 1..timeSignatureNum, 0 avant le premier temps
+};
+
+// Sous-menus (mélodie, preset, veille, tempo) : un seul ouvert à la fois
+struct MenuModeState {
+  byte index;                           // Option sélectionnée
+  byte scrollOffset;                    // Première option visible
+};
+
+// MODE_CHRONO : base de temps et anneau des tours (chrono.h)
+struct ChronoModeState {
+  ChronoState state;
+  unsigned long elapsedMs;              // Temps écoulé au dernier recalage
+  unsigned long syncMicros;             // micros() correspondant à elapsedMs
+  unsigned long laps[CHRONO_LAP_SLOTS]; // Temps intermédiaires (ms), tour n à l'indice (n-1) % CHRONO_LAP_SLOTS
+  unsigned int lapCount;                // Tours pris depuis la remise à zéro
+  unsigned long evictedSplit;           // Intermédiaire du dernier tour écrasé
+  unsigned int viewLap;                 // Tour affiché (0 = le plus récent)
+  int shownMIN, shownSEC, shownCS;      // Valeurs dessinées par les rendus
+  unsigned long lastCsRequest;
+};
+
+// MODE_PRACTICE : séance minutée (pratique.h), le métronome utilise modeState.metro
+struct PracticeModeState {
+  PracticeState state;
+  unsigned long endTime;                // millis() de la fin de la séance (PRACTICE_RUNNING)
+  unsigned long pausedRemaining;        // Reste de la séance en pause (ms)
+  int shownSeconds;                     // Secondes affichées (-1 = à redessiner)
+  unsigned long passes;                 // Coût des deux moteurs par passe de loop() (séance en cours)
+  unsigned long passMicros;
+  unsigned int maxPassMicros;
+};
+
+struct ModeState {
+  union {
+    TimerModeState timer;
+    MenuModeState menu;
+    ChronoModeState chrono;
+    PracticeModeState practice;
+  };
+  MetronomeModeState metro;             // Hors de l'union : actif aussi en MODE_PRACTICE
+};
+extern ModeState modeState;
+
+// Taille qu'occuperaient ces états en variables séparées (rapport SRAM du démarrage)
+const unsigned int MODE_STATE_SEPARATE_SIZE = sizeof(TimerModeState) + sizeof(MetronomeModeState) +
+                                              sizeof(MenuModeState) + sizeof(ChronoModeState) +
+                                              sizeof(PracticeModeState);
+
+extern const ModeHandlers MODE_TABLE[] PROGMEM; // Défini dans le .ino, dans l'ordre de l'enum
+extern enum Mode currentMode;
+
+void setMode(Mode mode);   // exit() du mode courant, puis enter() du nouveau
+void modeTick();
+void modeEncoder(int delta);
+void modeButton(ButtonEvent event);
+void modeRedraw();
+
+#endif // MODES_H
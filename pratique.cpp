@@ -0,0 +1,171 @@
+// pratique.cpp - Séance de pratique : décompte, fin sur une mesure, écran combiné
+
+#include "pratique.h"
+#include "rapport.h"
+
+// État de la séance : modeState.practice (modes.h), le métronome garde modeState.metro
+
+static const char PRACTICE_LABELS[][7] PROGMEM = { "Pret", "Marche", "Pause", "Fin...", "Fini" }; // Ordre de PracticeState
+
+static unsigned long remainingMillis() {
+  if (modeState.practice.state == PRACTICE_PAUSED) return modeState.practice.pausedRemaining;
+  if (modeState.practice.state != PRACTICE_RUNNING) return modeState.practice.state == PRACTICE_READY ? targetTotalSeconds * 1000UL : 0;
+  long left = (long)(modeState.practice.endTime - millis());
+  return left > 0 ? left : 0;
+}
+
+static void reportPracticeCost() {
+  if (modeState.practice.passes == 0) return;
+  Report.print(F("Pratique passes=")); Report.print(modeState.practice.passes);
+  Report.print(F(" moy="));            Report.print(modeState.practice.passMicros / modeState.practice.passes);
+  Report.print(F(" us max="));         Report.print(modeState.practice.maxPassMicros);
+  Report.println(F(" us"));
+  modeState.practice.passes = 0;
+  modeState.practice.passMicros = 0;
+  modeState.practice.maxPassMicros = 0;
+}
+
+// --- Affichage ---
+
+static void drawPracticeTime() {
+  unsigned int seconds = (remainingMillis() + 999) / 1000; // Arrondi au-dessus : 00:00 à la fin seulement
+  if (LCD_TALL) {
+    drawBigClock(seconds / 60, seconds % 60);
+  } else {
+    LCD.setCursor(PRACTICE_TIME_COL, PRACTICE_TIME_ROW);
+    if (seconds / 60 < 10) LCD.print('0');
+    LCD.print(seconds / 60);
+    LCD.print(':');
+    if (seconds % 60 < 10) LCD.print('0');
+    LCD.print(seconds % 60);
+  }
+}
+
+// Ligne d'état : état de la séance, signature (4 lignes) et BPM
+static void drawPracticeStatus() {
+  LCD.setCursor(PRACTICE_STATE_COL, PRACTICE_STATE_ROW);
+  byte len = LCD.print((const __FlashStringHelper*)PRACTICE_LABELS[modeState.practice.state]);
+  for (; len < 6; len++) LCD.print(' ');
+  if (LCD_TALL) {
+    LCD.setCursor(PRACTICE_TS_COL, PRACTICE_BPM_ROW);
+    len = LCD.print(timeSignatureNum);
+    len += LCD.print('/');
+    len += LCD.print(timeSignatureDen);
+    for (; len < 5; len++) LCD.print(' ');
+  }
+  LCD.setCursor(PRACTICE_BPM_COL, PRACTICE_BPM_ROW);
+  if (currentBPM < 100) LCD.print(' ');
+  LCD.print(currentBPM);
+  LCD.print(F("BPM"));
+}
+
+void redrawPracticeScreen() {
+  LCD.clear();
+  drawPracticeStatus();
+  drawPracticeTime();
+  resetBeatMarkers(); // Ligne des marqueurs effacée par LCD.clear()
+  if (currentMetroState == METRO_RUNNING) drawBeatMarkers();
+  modeState.practice.shownSeconds = (remainingMillis() + 999) / 1000;
+}
+
+// --- Séance ---
+
+static void setPracticeState(PracticeState state) {
+  modeState.practice.state = state;
+  requestDisplay(DISP_PRIO_STATUS, drawPracticeStatus);
+}
+
+static void startSession(unsigned long durationMs) {
+  modeState.practice.endTime = millis() + durationMs;
+  startMetronome(true); // Chaque départ ou reprise repart du premier temps
+  setPracticeState(PRACTICE_RUNNING);
+}
+
+static void finishSession() {
+  setPracticeState(PRACTICE_DONE);
+  requestDisplay(DISP_PRIO_SECONDS, drawPracticeTime);
+  playSound(SOUND_ALARM, PRACTICE_CHIME_FREQ, PRACTICE_CHIME_DURATION);
+  reportPracticeCost();
+  resetActivityTimer();
+}
+
+// Décompte : une échéance en millis(), l'affichage ne suit que les changements de seconde
+static void serviceCountdown() {
+  if (modeState.practice.state == PRACTICE_RUNNING && remainingMillis() == 0) {
+    stopMetronomeAtMeasureEnd();
+    setPracticeState(PRACTICE_ENDING);
+  }
+  if (modeState.practice.state == PRACTICE_ENDING && currentMetroState == METRO_STOPPED) {
+    finishSession();
+    return;
+  }
+  int seconds = (remainingMillis() + 999) / 1000;
+  if (seconds != modeState.practice.shownSeconds) {
+    modeState.practice.shownSeconds = seconds;
+    requestDisplay(DISP_PRIO_SECONDS, drawPracticeTime);
+  }
+}
+
+// --- Gestionnaires de mode ---
+
+void enterPracticeMode() {
+  resetActivityTimer();
+  currentMetroState = METRO_STOPPED;
+  bigNum.begin(); // Les menus ont remplacé deux caractères personnalisés par les flèches
+  redrawPracticeScreen();
+}
+
+void exitPracticeMode() {
+  if (currentMetroState == METRO_RUNNING) stopMetronome();
+  flushTempo();
+  reportPracticeCost();
+}
+
+void tickPracticeMode() {
+  serviceTempo(); // BPM enregistré quand l'encodeur ne tourne plus
+  bool running = modeState.practice.state == PRACTICE_RUNNING || modeState.practice.state == PRACTICE_ENDING;
+  if (!running) { checkIdleSleep(); return; }
+  unsigned long start = micros();
+  handleMetronomeLogic();
+  serviceCountdown();
+  unsigned long elapsed = micros() - start;
+  modeState.practice.passes++;
+  modeState.practice.passMicros += elapsed;
+  if (elapsed > modeState.practice.maxPassMicros) modeState.practice.maxPassMicros = elapsed > 65535UL ? 65535U : elapsed;
+}
+
+void handlePracticeEncoder(int delta) {
+  if (midiSyncMode() == MIDI_SYNC_SLAVE) return; // Tempo imposé par l'horloge reçue
+  int newBPM = constrain(currentBPM + delta, MIN_BPM, MAX_BPM);
+  if (newBPM == currentBPM) return;
+  if (currentMetroState == METRO_STOPPED) playClickSound(); // En séance, un clic brouillerait la pulsation
+  resetActivityTimer();
+  setTempo(newBPM); // Phase du temps en cours gardée, enregistrement différé
+  requestDisplay(DISP_PRIO_STATUS, drawPracticeStatus);
+}
+
+void handlePracticeButton(ButtonEvent event) {
+  resetActivityTimer();
+  if (event == BTN_LONG_PRESS) { setMode(MODE_MENU_MAIN); return; }
+  if (!isClickEvent(event)) return;
+  switch (modeState.practice.state) {
+    case PRACTICE_READY:
+    case PRACTICE_DONE:
+      if (targetTotalSeconds == 0) return; // Pas de temps cible : rien à décompter
+      startSession(targetTotalSeconds * 1000UL);
+      modeState.practice.shownSeconds = -1;
+      break;
+    case PRACTICE_RUNNING:
+      modeState.practice.pausedRemaining = remainingMillis();
+      stopMetronome();
+      setPracticeState(PRACTICE_PAUSED);
+      break;
+    case PRACTICE_PAUSED:
+      startSession(modeState.practice.pausedRemaining);
+      break;
+    case PRACTICE_ENDING:
+      stopMetronome(); // Fin de mesure abrégée : la séance se termine tout de suite
+      finishSession();
+      break;
+  }
+}
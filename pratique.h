@@ -0,0 +1,46 @@
+// pratique.h - Séance de pratique minutée : métronome et décompte dans la même passe de loop()
+//
+// Une séance = le métronome au BPM et à la signature courants pendant le temps cible du minuteur
+// (preset ou temps manuel). Les deux moteurs tournent à chaque passe : handleMetronomeLogic() bat
+// les temps (son, MIDI, marqueurs), le décompte suit une échéance en millis(). À zéro, le
+// métronome finit la mesure en cours et s'arrête à la place du temps fort suivant
+// (stopMetronomeAtMeasureEnd(), metronome.h), puis le carillon de fin sonne.
+//
+// Écran combiné : état, signature et BPM sur la ligne 0, reste de la séance en grands chiffres,
+// marqueurs de temps sur la dernière ligne (mêmes positions que l'écran du métronome). Sur 16x2 :
+// "MM:SS" et BPM en haut, état et marqueurs en bas.
+//
+// Le coût des deux moteurs (µs par passe, moyenne et maximum) est mesuré pendant la séance et
+// envoyé sur le port série à la fin. En esclave MIDI, les temps suivent l'horloge reçue ; ses
+// Start / Stop ne commandent pas la séance.
+//
+// Commandes : clic = départ / pause / reprise (pendant la fin de mesure : arrêt immédiat) ;
+// encodeur = BPM, aussi pendant la séance (setTempo(), metronome.h) ; appui long = retour au menu.
+#ifndef PRATIQUE_H
+#define PRATIQUE_H
+
+#include <Arduino.h>
+#include "conf.h"
+#include "ecran.h"
+#include "geometrie.h"
+#include "affichage.h"
+#include "modes.h"
+#include "bouton.h"
+#include "metronome.h" // Moteur du métronome, marqueurs de temps
+#include "timer.h"     // Temps cible (targetTotalSeconds), grands chiffres MM.SS
+
+// Fonctions utilitaires du .ino principal
+void resetActivityTimer();
+void playClickSound();
+void checkIdleSleep();
+void clearRestOfLine(byte startCol, byte row);
+
+// Gestionnaires de MODE_PRACTICE (modes.h)
+void enterPracticeMode();
+void exitPracticeMode();
+void tickPracticeMode();
+void handlePracticeEncoder(int delta);
+void handlePracticeButton(ButtonEvent event);
+void redrawPracticeScreen();
+
+#endif // PRATIQUE_H
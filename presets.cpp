@@ -0,0 +1,290 @@
+// presets.cpp - Bibliothèque de presets en EEPROM et éditeur
+
+#include "presets.h"
+#include "checkpoint.h" // eepromWriteBegin/End : écriture protégée de la chute de tension
+#include <string.h>
+
+static const byte PRESET_LIBRARY_MAGIC = 0xA7; // Change si le format des enregistrements change
+
+// Caractères proposés par l'éditeur pour les noms
+static const char PRESET_NAME_CHARS[] PROGMEM = " ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789-";
+static const byte NUM_NAME_CHARS = sizeof(PRESET_NAME_CHARS) - 1;
+
+// Champs de l'éditeur : un par caractère du nom, puis durée, puis actions
+static const byte FIELD_SECONDS = PRESET_NAME_LEN;
+static const byte FIELD_SAVE = PRESET_NAME_LEN + 1;
+static const byte FIELD_DELETE = PRESET_NAME_LEN + 2;
+static const byte FIELD_COUNT = PRESET_NAME_LEN + 3;
+
+static byte order[PRESET_SLOTS];                  // Copie RAM de EEPROM_ADDR_PRESET_ORDER
+static byte count = 0;
+static char currentName[PRESET_NAME_LEN + 1];     // Cache du preset courant
+static unsigned int currentSeconds = 0;
+
+static byte editSlot = PRESET_NONE;
+static char editName[PRESET_NAME_LEN + 1];
+static unsigned int editSeconds = 0;
+static byte editField = 0;
+static bool editActive = false;                   // Le champ sélectionné est en cours de modification
+
+static int recordAddress(byte slot) {
+  return EEPROM_ADDR_PRESET_RECORDS + slot * PRESET_RECORD_SIZE;
+}
+
+// Réécrit la liste d'ordre à partir d'un rang (EEPROM.update : seuls les octets changés sont programmés)
+static void saveOrderFrom(byte rank) {
+  eepromWriteBegin();
+  for (byte r = rank; r < PRESET_SLOTS; r++) {
+    EEPROM.update(EEPROM_ADDR_PRESET_ORDER + r, r < count ? order[r] : PRESET_NONE);
+  }
+  eepromWriteEnd();
+}
+
+static void writeRecord(byte slot, const char* name, unsigned int seconds) {
+  int address = recordAddress(slot);
+  bool ended = false;
+  eepromWriteBegin();
+  for (byte i = 0; i < PRESET_NAME_LEN; i++) {
+    if (name[i] == '\0') ended = true;
+    EEPROM.update(address + i, ended ? ' ' : name[i]);
+  }
+  EEPROM.put(address + PRESET_NAME_LEN, (uint16_t)seconds); // 2 octets : taille fixée par PRESET_RECORD_SIZE
+  eepromWriteEnd();
+}
+
+static void installDefaultPresets() {
+  for (byte i = 0; i < NUM_DEFAULT_PRESETS; i++) {
+    DefaultPreset preset;
+    memcpy_P(&preset, &DEFAULT_PRESETS[i], sizeof(preset));
+    writeRecord(i, preset.name, preset.seconds);
+    order[i] = i;
+  }
+  count = NUM_DEFAULT_PRESETS;
+  saveOrderFrom(0);
+  eepromWriteBegin();
+  EEPROM.update(EEPROM_ADDR_PRESET_LIBRARY, PRESET_LIBRARY_MAGIC);
+  eepromWriteEnd();
+}
+
+static void loadOrder() {
+  unsigned long seen = 0; // Un bit par emplacement : une liste abîmée s'arrête au premier doublon
+  count = 0;
+  for (byte r = 0; r < PRESET_SLOTS; r++) {
+    byte slot = EEPROM.read(EEPROM_ADDR_PRESET_ORDER + r);
+    if (slot >= PRESET_SLOTS || (seen & (1UL << slot))) break;
+    seen |= 1UL << slot;
+    order[count++] = slot;
+  }
+}
+
+static void loadCurrentPreset() {
+  if (currentPresetChoice == 0) return;
+  byte slot = currentPresetChoice - 1;
+  readPresetName(slot, currentName);
+  for (byte i = PRESET_NAME_LEN; i > 0 && currentName[i - 1] == ' '; i--) { currentName[i - 1] = '\0'; }
+  currentSeconds = readPresetSeconds(slot);
+}
+
+void setupPresets() {
+  if (EEPROM.read(EEPROM_ADDR_PRESET_LIBRARY) != PRESET_LIBRARY_MAGIC) { installDefaultPresets(); }
+  else { loadOrder(); }
+
+  byte saved = settings.preset;
+  if (saved != 0 && (saved > PRESET_SLOTS || presetRankOf(saved - 1) == PRESET_NONE)) {
+    saved = 0;
+    settings.preset = saved; // Enregistré par setup()
+  }
+  currentPresetChoice = saved;
+  loadCurrentPreset();
+}
+
+byte presetCount() {
+  return count;
+}
+
+byte presetSlotAt(byte rank) {
+  return rank < count ? order[rank] : PRESET_NONE;
+}
+
+byte presetRankOf(byte slot) {
+  for (byte r = 0; r < count; r++) {
+    if (order[r] == slot) return r;
+  }
+  return PRESET_NONE;
+}
+
+void readPresetName(byte slot, char* name) {
+  int address = recordAddress(slot);
+  for (byte i = 0; i < PRESET_NAME_LEN; i++) { name[i] = EEPROM.read(address + i); }
+  name[PRESET_NAME_LEN] = '\0';
+}
+
+unsigned int readPresetSeconds(byte slot) {
+  uint16_t seconds;
+  EEPROM.get(recordAddress(slot) + PRESET_NAME_LEN, seconds);
+  return seconds > PRESET_MAX_SECONDS ? PRESET_MAX_SECONDS : seconds;
+}
+
+void selectPreset(byte choice) {
+  currentPresetChoice = choice;
+  settings.preset = choice;
+  saveSettings();
+  if (choice == 0) return;
+
+  // Le preset choisi remonte en tête de la liste
+  byte slot = choice - 1;
+  byte rank = presetRankOf(slot);
+  if (rank != PRESET_NONE && rank > 0) {
+    memmove(order + 1, order, rank);
+    order[0] = slot;
+    eepromWriteBegin();
+    for (byte r = 0; r <= rank; r++) { EEPROM.update(EEPROM_ADDR_PRESET_ORDER + r, order[r]); }
+    eepromWriteEnd();
+  }
+  loadCurrentPreset();
+}
+
+unsigned int presetTargetSeconds() {
+  if (currentPresetChoice != 0) return currentSeconds;
+  return settings.manualSeconds > MAX_TOTAL_SECONDS ? 0 : settings.manualSeconds;
+}
+
+const char* currentPresetName() {
+  return currentPresetChoice == 0 ? "Manuel" : currentName;
+}
+
+byte writePreset(byte slot, const char* name, unsigned int seconds) {
+  if (slot == PRESET_NONE) {
+    if (count >= PRESET_SLOTS) return PRESET_NONE;
+    for (slot = 0; presetRankOf(slot) != PRESET_NONE; slot++) {} // Premier emplacement libre
+    memmove(order + 1, order, count);                           // Nouveau preset en tête
+    order[0] = slot;
+    count++;
+    saveOrderFrom(0);
+  }
+  writeRecord(slot, name, seconds);
+  if (currentPresetChoice == slot + 1) loadCurrentPreset();
+  return slot;
+}
+
+void deletePreset(byte slot) {
+  byte rank = presetRankOf(slot);
+  if (rank == PRESET_NONE) return;
+  memmove(order + rank, order + rank + 1, count - rank - 1);
+  count--;
+  saveOrderFrom(rank);
+  if (currentPresetChoice == slot + 1) selectPreset(0);
+}
+
+void printPresetDuration(unsigned int seconds) {
+  byte minutes = seconds / 60;
+  byte secs = seconds % 60;
+  if (minutes < 10) LCD.print("0");
+  LCD.print(minutes);
+  LCD.print(":");
+  if (secs < 10) LCD.print("0");
+  LCD.print(secs);
+}
+
+// --- Éditeur ---
+
+void openPresetEditor(byte slot) {
+  editSlot = slot;
+  if (slot == PRESET_NONE) {
+    strcpy(editName, "NOUVEAU");
+    editSeconds = targetTotalSeconds > 0 ? targetTotalSeconds : 60; // Part du temps affiché sur le minuteur
+  } else {
+    readPresetName(slot, editName);
+    editSeconds = readPresetSeconds(slot);
+  }
+  for (byte i = strlen(editName); i < PRESET_NAME_LEN; i++) { editName[i] = ' '; }
+  editName[PRESET_NAME_LEN] = '\0';
+  editField = 0;
+  editActive = false;
+  setMode(MODE_EDIT_PRESET);
+}
+
+void enterPresetEditor() {
+  resetActivityTimer();
+  LCD.clear();
+  displayPresetEditor();
+}
+
+void displayPresetEditor() {
+  if (LCD_TALL) {
+    LCD.setCursor(0, 0);
+    LCD.print(editSlot == PRESET_NONE ? F("Nouveau Preset:") : F("Edition Preset:"));
+  }
+  LCD.setCursor(0, PRESET_EDIT_ROW);
+  LCD.print(editName);
+  LCD.print(" ");
+  printPresetDuration(editSeconds);
+  clearRestOfLine(PRESET_EDIT_TIME_COL + 5, PRESET_EDIT_ROW);
+
+  // Repère sous le champ sélectionné : '^' pour choisir, '*' pendant la modification
+  if (editField < FIELD_SAVE) {
+    clearRestOfLine(0, PRESET_EDIT_MARK_ROW);
+    char mark = editActive ? '*' : '^';
+    if (editField == FIELD_SECONDS) {
+      LCD.setCursor(PRESET_EDIT_TIME_COL, PRESET_EDIT_MARK_ROW);
+      for (byte i = 0; i < 5; i++) LCD.print(mark);
+    } else {
+      LCD.setCursor(editField, PRESET_EDIT_MARK_ROW);
+      LCD.print(mark);
+    }
+  } else if (LCD_TALL) {
+    clearRestOfLine(0, PRESET_EDIT_MARK_ROW);
+  }
+
+  if (LCD_TALL || editField >= FIELD_SAVE) {
+    LCD.setCursor(0, PRESET_EDIT_ACTION_ROW);
+    LCD.print(editField == FIELD_SAVE ? ">" : " ");
+    LCD.print(F("OK  "));
+    LCD.print(editField == FIELD_DELETE ? ">" : " ");
+    LCD.print(editSlot == PRESET_NONE ? F("Annul") : F("Suppr"));
+    clearRestOfLine(textLen(" OK   Suppr"), PRESET_EDIT_ACTION_ROW);
+  }
+}
+
+static byte nameCharIndex(char c) {
+  for (byte i = 0; i < NUM_NAME_CHARS; i++) {
+    if ((char)pgm_read_byte(&PRESET_NAME_CHARS[i]) == c) return i;
+  }
+  return 0;
+}
+
+void handlePresetEditorEncoder(int delta) {
+  playClickSound(); resetActivityTimer();
+  if (!editActive) {
+    int field = ((int)editField + delta) % FIELD_COUNT;
+    if (field < 0) field += FIELD_COUNT;
+    editField = field;
+  } else if (editField < PRESET_NAME_LEN) {
+    int index = ((int)nameCharIndex(editName[editField]) + delta) % NUM_NAME_CHARS;
+    if (index < 0) index += NUM_NAME_CHARS;
+    editName[editField] = pgm_read_byte(&PRESET_NAME_CHARS[index]);
+  } else {
+    long seconds = (long)editSeconds + (long)delta * SECOND_INCREMENT;
+    editSeconds = constrain(seconds, (long)SECOND_INCREMENT, (long)PRESET_MAX_SECONDS);
+  }
+  displayPresetEditor();
+}
+
+void handlePresetEditorButton(ButtonEvent event) {
+  if (event == BTN_LONG_PRESS) { // Abandon des modifications
+    setMode(MODE_MENU_PRESET);
+    return;
+  }
+  if (!isClickEvent(event)) return;
+
+  if (editField < FIELD_SAVE) {
+    editActive = !editActive;
+    displayPresetEditor();
+  } else if (editField == FIELD_SAVE) {
+    writePreset(editSlot, editName, editSeconds);
+    setMode(MODE_MENU_PRESET);
+  } else { // FIELD_DELETE (nouveau preset : Annuler)
+    if (editSlot != PRESET_NONE) deletePreset(editSlot);
+    setMode(MODE_MENU_PRESET);
+  }
+}
@@ -0,0 +1,67 @@
+// presets.h - Bibliothèque de presets du minuteur en EEPROM (nom court + durée), ordre d'usage récent
+//
+// Jusqu'à PRESET_SLOTS presets de PRESET_RECORD_SIZE octets (nom de PRESET_NAME_LEN caractères
+// complété par des espaces, durée en secondes) à EEPROM_ADDR_PRESET_RECORDS. La liste des
+// emplacements occupés, du plus récemment utilisé au plus ancien, est rangée juste avant
+// (EEPROM_ADDR_PRESET_ORDER) : le menu présente les presets dans cet ordre, le dernier utilisé
+// est à un cran de "Manuel". Choisir un preset le remonte en tête ; EEPROM.update() ne
+// réécrit que les octets de la liste qui ont changé.
+//
+// La liste d'ordre (32 octets) et le preset courant (nom + durée) sont gardés en RAM : ni la
+// ligne d'infos ni le départ du décompte ne relisent l'EEPROM, et le menu lit directement les
+// seuls enregistrements visibles (emplacement connu, aucun parcours).
+//
+// Premier démarrage (octet de format absent) : DEFAULT_PRESETS (.ino) est installé aux
+// emplacements 0.., ce qui conserve le sens des anciens choix 1..3 sauvegardés dans settings.preset.
+#ifndef PRESETS_H
+#define PRESETS_H
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include "conf.h"
+#include "ecran.h"
+#include "geometrie.h"
+#include "modes.h"
+#include "bouton.h"
+#include "reglages.h" // Réglages persistants (choix courant, temps manuel)
+
+const byte PRESET_NONE = 0xFF; // Emplacement absent / nouveau preset
+
+struct DefaultPreset {
+  char name[PRESET_NAME_LEN + 1];
+  unsigned int seconds;
+};
+
+// Déclaration seulement (la définition = { ... } est dans le .ino)
+extern const DefaultPreset DEFAULT_PRESETS[] PROGMEM;
+
+extern byte currentPresetChoice; // 0 = Manuel, sinon emplacement + 1 (sauvegardé dans settings.preset)
+extern unsigned int targetTotalSeconds;
+
+// Fonctions utilitaires du .ino principal
+void resetActivityTimer();
+void playClickSound();
+void clearRestOfLine(byte startCol, byte row);
+
+// --- Bibliothèque ---
+void setupPresets();                          // Charge l'ordre et le preset courant (installe les presets par défaut si besoin)
+byte presetCount();
+byte presetSlotAt(byte rank);                 // rank 0 = le plus récemment utilisé
+byte presetRankOf(byte slot);                 // PRESET_NONE si l'emplacement est libre
+void readPresetName(byte slot, char* name);   // name : PRESET_NAME_LEN + 1 octets
+unsigned int readPresetSeconds(byte slot);
+void selectPreset(byte choice);               // 0 = Manuel, sinon emplacement + 1 ; remonte le preset en tête
+unsigned int presetTargetSeconds();           // Temps cible du choix courant (Manuel : temps sauvegardé)
+const char* currentPresetName();              // Nom du choix courant, sans espaces finaux ("Manuel")
+byte writePreset(byte slot, const char* name, unsigned int seconds); // PRESET_NONE = nouvel emplacement, rendu
+void deletePreset(byte slot);
+void printPresetDuration(unsigned int seconds); // "MM:SS" à la position courante
+
+// --- Éditeur (MODE_EDIT_PRESET) : nom caractère par caractère, durée, OK / Suppr ---
+void openPresetEditor(byte slot);             // PRESET_NONE = nouveau preset
+void enterPresetEditor();
+void displayPresetEditor();
+void handlePresetEditorEncoder(int delta);
+void handlePresetEditorButton(ButtonEvent event);
+
+#endif // PRESETS_H
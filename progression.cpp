@@ -0,0 +1,65 @@
+// progression.cpp - Barre de progression du décompte : rendu complet ou de la seule case modifiée
+
+#include "progression.h"
+
+static const byte PROGRESS_STEPS = PROGRESS_CELLS * PROGRESS_COLS_PER_CELL;
+static const byte PROGRESS_UNKNOWN = 0xFF; // Contenu de la ligne inconnu : rendu complet
+
+static byte targetPosition = 0;
+static byte shownPosition = PROGRESS_UNKNOWN;
+
+byte progressForRemaining(unsigned long remainingMs, unsigned long totalMs) {
+  if (totalMs == 0 || remainingMs >= totalMs) return 0;
+  // 99:59 au plus : (totalMs - remainingMs) * PROGRESS_STEPS tient largement sur 32 bits
+  return (totalMs - remainingMs) * PROGRESS_STEPS / totalMs;
+}
+
+// Case partielle : 'columns' colonnes allumées depuis la gauche, sur toute la hauteur
+static void definePartialChar(byte columns) {
+  byte pattern[8];
+  memset(pattern, (0x1F << (PROGRESS_COLS_PER_CELL - columns)) & 0x1F, sizeof(pattern));
+  LCD.createChar(PROGRESS_PARTIAL_CHAR, pattern);
+}
+
+static byte cellCode(byte cell, byte position) {
+  byte cellStart = cell * PROGRESS_COLS_PER_CELL;
+  if (position >= cellStart + PROGRESS_COLS_PER_CELL) return PROGRESS_FULL_CHAR;
+  if (position <= cellStart) return ' ';
+  return PROGRESS_PARTIAL_CHAR;
+}
+
+void drawProgressBar() {
+  if (PROGRESS_CELLS == 0) return;
+  definePartialChar(targetPosition % PROGRESS_COLS_PER_CELL);
+  if (PROGRESS_CELLS < LCD_COLS) clearRestOfLine(0, PROGRESS_ROW); // 40x4 : restes de la ligne d'infos
+  LCD.setCursor(PROGRESS_COL, PROGRESS_ROW);
+  for (byte cell = 0; cell < PROGRESS_CELLS; cell++) { LCD.write(cellCode(cell, targetPosition)); }
+  shownPosition = targetPosition;
+}
+
+// Rendu incrémental : seules les cases dont le code change sont réécrites (contiguës)
+static void drawProgressStep() {
+  if (shownPosition == PROGRESS_UNKNOWN || targetPosition < shownPosition) { drawProgressBar(); return; }
+  byte columns = targetPosition % PROGRESS_COLS_PER_CELL;
+  if (columns > 0) definePartialChar(columns);
+  bool cursorPlaced = false;
+  byte lastCell = targetPosition / PROGRESS_COLS_PER_CELL;
+  for (byte cell = shownPosition / PROGRESS_COLS_PER_CELL; cell <= lastCell && cell < PROGRESS_CELLS; cell++) {
+    byte code = cellCode(cell, targetPosition);
+    if (code == cellCode(cell, shownPosition)) continue; // Case partielle déjà en place : son dessin suffit
+    if (!cursorPlaced) { LCD.setCursor(PROGRESS_COL + cell, PROGRESS_ROW); cursorPlaced = true; }
+    LCD.write(code);
+  }
+  shownPosition = targetPosition;
+}
+
+void resetProgress(byte position) {
+  targetPosition = position;
+  shownPosition = PROGRESS_UNKNOWN;
+}
+
+void setProgress(byte position) {
+  if (PROGRESS_CELLS == 0 || position == targetPosition) return;
+  targetPosition = position;
+  requestDisplay(DISP_PRIO_STATUS, drawProgressStep); // Remplace au besoin un displayStatusLine3() en attente
+}
@@ -0,0 +1,35 @@
+// progression.h - Barre de progression du décompte, au cinquième de case près
+//
+// PROGRESS_CELLS cases de PROGRESS_COLS_PER_CELL colonnes de pixels : 100 positions sur un 20x4.
+// Les cases pleines sont le pavé de la ROM (PROGRESS_FULL_CHAR), les vides un espace ; seule la
+// case en cours de remplissage utilise un caractère custom (PROGRESS_PARTIAL_CHAR, rendu libre par
+// les grands chiffres), redéfini de 1 à 4 colonnes à chaque position.
+//
+// Mise à jour incrémentale : setProgress() ne dépose une demande de rendu que si la position
+// change, et ce rendu n'écrit que l'écart avec ce qui est déjà à l'écran. Dans la même case, seul
+// le caractère custom est reprogrammé (9 octets vers le contrôleur, aucune case réécrite) ; au
+// passage à la case suivante, la case terminée devient un pavé et la nouvelle reçoit le caractère
+// custom. Jamais la ligne entière, sauf au départ et aux redessins complets (réveil, retour menu).
+//
+// La barre remplace la ligne d'infos (mélodie | preset) tant que le minuteur n'est pas à l'arrêt :
+// displayStatusLine3() la redessine alors en entier. Pas de barre sur 16x2 (aucune ligne libre).
+#ifndef PROGRESSION_H
+#define PROGRESSION_H
+
+#include <Arduino.h>
+#include "conf.h"
+#include "ecran.h"
+#include "geometrie.h"
+#include "affichage.h"
+
+// Fonction utilitaire du .ino principal
+void clearRestOfLine(byte startCol, byte row);
+
+// Position (0..PROGRESS_CELLS*5) pour un décompte de totalMs dont il reste remainingMs
+byte progressForRemaining(unsigned long remainingMs, unsigned long totalMs);
+
+void resetProgress(byte position); // Nouveau décompte : barre à redessiner en entier au prochain rendu
+void setProgress(byte position);   // Appelée à chaque passe : rendu demandé si la position a changé
+void drawProgressBar();            // Barre complète (ligne d'infos redessinée)
+
+#endif // PROGRESSION_H
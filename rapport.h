@@ -0,0 +1,21 @@
+// rapport.h - Destination des rapports texte (diagnostic, sorties, chrono...)
+//
+// Report vaut Serial, sauf quand l'UART sert au MIDI (MIDI_ENABLED, midi.h) : les rapports partent
+// alors dans un puits qui ne fait rien, pour ne pas être lus comme des messages MIDI.
+#ifndef RAPPORT_H
+#define RAPPORT_H
+
+#include <Arduino.h>
+#include "conf.h"
+
+#if MIDI_ENABLED
+class NullReport : public Print {
+  public:
+    virtual size_t write(uint8_t) { return 1; }
+};
+extern NullReport Report; // Défini dans midi.cpp
+#else
+#define Report Serial
+#endif
+
+#endif // RAPPORT_H
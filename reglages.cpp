@@ -0,0 +1,201 @@
+// reglages.cpp - Enregistrement des réglages, migration des anciens schémas, console d'export/import
+
+#include "reglages.h"
+#include "rapport.h"
+#include "journal.h"
+#include "checkpoint.h" // eepromWriteBegin/End : écriture protégée de la chute de tension
+#include <string.h>
+#include <util/crc16.h>
+
+// Enregistrement en EEPROM, et trame de la console (mêmes octets)
+struct SettingsRecord {
+  byte version;            // SETTINGS_VERSION ; 0xFF = jamais écrit (ancien schéma ou unité neuve)
+  Settings data;
+  uint16_t crc;            // CRC-16 de version et data
+};
+
+Settings settings;
+
+extern enum TimerRunState currentTimerState;
+extern enum MetronomeRunState currentMetroState;
+
+static SettingsRecord incoming;   // Trame REGLAGES en cours de réception
+
+static uint16_t recordCrc(const SettingsRecord& rec) {
+  const byte* bytes = (const byte*)&rec;
+  uint16_t crc = 0xFFFF;
+  for (byte i = 0; i < sizeof(SettingsRecord) - sizeof(rec.crc); i++) {
+    crc = _crc16_update(crc, bytes[i]);
+  }
+  return crc;
+}
+
+// Schéma 1 : un champ par adresse. Les valeurs sont reprises telles quelles, les setup...()
+// remplacent ensuite les seules valeurs invalides (0xFF d'une unité neuve) par leur défaut.
+static void readLegacyLayout() {
+  settings.melody = EEPROM.read(EEPROM_ADDR_MELODY);
+  settings.preset = EEPROM.read(EEPROM_ADDR_PRESET);
+  EEPROM.get(EEPROM_ADDR_MANUAL_TIME, settings.manualSeconds);
+  settings.sleepDelay = EEPROM.read(EEPROM_ADDR_SLEEP_DELAY);
+  settings.buzzerFeedback = EEPROM.read(EEPROM_ADDR_BUZZER_FEEDBACK);
+  settings.timerMelody = EEPROM.read(EEPROM_ADDR_TIMER_MELODY_ENABLED);
+  EEPROM.get(EEPROM_ADDR_METRONOME_BPM, settings.bpm);
+  settings.tsNum = EEPROM.read(EEPROM_ADDR_METRONOME_TS_NUM);
+  settings.tsDen = EEPROM.read(EEPROM_ADDR_METRONOME_TS_DEN);
+  settings.midiSync = EEPROM.read(EEPROM_ADDR_MIDI_SYNC);
+}
+
+// Une étape par version : chacune amène settings au schéma suivant (les cas s'enchaînent)
+static void migrateSettings(byte fromVersion) {
+  switch (fromVersion) {
+    case 1:
+      readLegacyLayout(); // 1 -> 2 : champs épars regroupés dans l'enregistrement
+      break;
+  }
+  Report.print(F("Reglages: schema ")); Report.print(fromVersion);
+  Report.print(F(" migre vers ")); Report.println(SETTINGS_VERSION);
+}
+
+void loadSettings() {
+  static_assert(sizeof(SettingsRecord) <= SETTINGS_RECORD_SIZE, "SETTINGS_RECORD_SIZE trop petit");
+  SettingsRecord rec;
+  EEPROM.get(EEPROM_ADDR_SETTINGS, rec);
+  if (rec.version == SETTINGS_VERSION && rec.crc == recordCrc(rec)) {
+    settings = rec.data;
+  } else if (rec.version == 0xFF) {
+    migrateSettings(1); // Pas d'enregistrement : ancien schéma (tout à 0xFF sur une unité neuve)
+  } else {
+    memset(&settings, 0xFF, sizeof(settings)); // Coupé pendant l'écriture ou version inconnue : défauts
+    Report.println(F("Reglages: enregistrement invalide, valeurs par defaut"));
+  }
+  // L'enregistrement est (ré)écrit par saveSettings() à la fin de setup(), après validation
+}
+
+void saveSettings() {
+  SettingsRecord rec;
+  rec.version = SETTINGS_VERSION;
+  rec.data = settings;
+  rec.crc = recordCrc(rec);
+  eepromWriteBegin();
+  EEPROM.put(EEPROM_ADDR_SETTINGS, rec); // Octet par octet avec EEPROM.update : seuls les changements sont programmés
+  eepromWriteEnd();
+}
+
+// --- Console série ---
+
+static void exportSettings() {
+  SettingsRecord rec;
+  EEPROM.get(EEPROM_ADDR_SETTINGS, rec);
+  Report.print(F("REGLAGES "));
+  const byte* bytes = (const byte*)&rec;
+  for (byte i = 0; i < sizeof(SettingsRecord); i++) {
+    if (bytes[i] < 0x10) Report.print('0');
+    Report.print(bytes[i], HEX);
+  }
+  Report.println();
+}
+
+static void importSettings() {
+  if (incoming.crc != recordCrc(incoming)) { Report.println(F("ERR crc")); return; }
+  if (incoming.version != SETTINGS_VERSION) { Report.println(F("ERR version")); return; }
+  if (currentTimerState != STATE_IDLE || currentMetroState != METRO_STOPPED) { Report.println(F("ERR occupe")); return; }
+  settings = incoming.data;
+  applySettings(); // Valeurs hors plage ramenées à leur défaut, comme au démarrage
+  saveSettings();
+  Report.println(F("OK"));
+}
+
+// Commande "REGLAGES" : sans argument l'export, avec l'enregistrement complet l'import
+static void settingsCommand(unsigned int bytes) {
+  if (bytes == 0) exportSettings();
+  else if (bytes == sizeof(SettingsRecord)) importSettings();
+  else Report.println(F("ERR format"));
+}
+
+// Table des commandes : l'argument hexadécimal est reçu directement dans buffer
+static const byte COMMAND_NAME_SIZE = 9; // "REGLAGES" + zéro final
+
+struct ConsoleCommand {
+  char name[COMMAND_NAME_SIZE];
+  byte* buffer;
+  unsigned int capacity;
+  void (*run)(unsigned int bytes);  // bytes = octets reçus (0 : pas d'argument, BAD_ARGUMENT : mal formé)
+};
+
+static const ConsoleCommand CONSOLE_COMMANDS[] PROGMEM = {
+  { "REGLAGES", (byte*)&incoming,    sizeof(incoming),    settingsCommand },
+#if INPUT_JOURNAL
+  { "JOURNAL",  nullptr,             0,                   journalDump },
+  { "REJOUER",  (byte*)&journalBlob, sizeof(journalBlob), journalImport },
+#endif
+};
+static const byte NUM_COMMANDS = sizeof(CONSOLE_COMMANDS) / sizeof(CONSOLE_COMMANDS[0]);
+static const byte NO_COMMAND = 0xFF;
+static const unsigned int BAD_ARGUMENT = 0xFFFF;
+
+static char commandName[COMMAND_NAME_SIZE]; // Nom de la commande en cours de réception
+static byte nameLen = 0;
+static byte command = NO_COMMAND;    // Commande reconnue (après l'espace)
+static bool discard = false;         // Ligne mal formée : ignorée jusqu'à la fin
+static unsigned int nibbles = 0;     // Chiffres hexadécimaux reçus après la commande
+
+static byte findCommand() {
+  commandName[nameLen] = '\0';
+  for (byte i = 0; i < NUM_COMMANDS; i++) {
+    if (strcmp_P(commandName, CONSOLE_COMMANDS[i].name) == 0) return i;
+  }
+  return NO_COMMAND;
+}
+
+static int8_t hexValue(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  return -1;
+}
+
+static void endOfLine() {
+  if (command == NO_COMMAND && !discard && nameLen > 0) command = findCommand();
+  if (command != NO_COMMAND) {
+    ConsoleCommand entry;
+    memcpy_P(&entry, &CONSOLE_COMMANDS[command], sizeof(entry));
+    entry.run(discard || nibbles % 2 != 0 ? BAD_ARGUMENT : nibbles / 2); // Appelée même mal formée : buffer a pu changer
+  } else if (discard || nameLen > 0) {
+    Report.println(F("ERR format"));
+  }
+  nameLen = 0;
+  command = NO_COMMAND;
+  discard = false;
+  nibbles = 0;
+}
+
+static void consumeChar(char c) {
+  if (c == '\r' || c == '\n') { endOfLine(); return; }
+  if (discard) return;
+  if (command == NO_COMMAND) {
+    if (c == ' ' && nameLen > 0) {
+      command = findCommand();
+      discard = command == NO_COMMAND;
+    } else if (nameLen < COMMAND_NAME_SIZE - 1) {
+      commandName[nameLen++] = c;
+    } else {
+      discard = true;
+    }
+    return;
+  }
+  ConsoleCommand entry;
+  memcpy_P(&entry, &CONSOLE_COMMANDS[command], sizeof(entry));
+  int8_t value = hexValue(c);
+  if (value < 0 || nibbles >= 2 * entry.capacity) { discard = true; return; }
+  if (nibbles % 2 == 0) entry.buffer[nibbles / 2] = value << 4;
+  else entry.buffer[nibbles / 2] |= value;
+  nibbles++;
+}
+
+void serviceSettingsConsole() {
+#if !MIDI_ENABLED // L'UART sert au MIDI : pas de console
+  while (Serial.available() > 0) {
+    consumeChar(Serial.read());
+  }
+#endif
+}
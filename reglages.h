@@ -0,0 +1,53 @@
+// reglages.h - Réglages persistants : un enregistrement versionné protégé par CRC, exportable
+//
+// Tous les choix de l'utilisateur (mélodie, preset courant, temps manuel, veille, bips, mélodie de
+// fin, BPM, signature, synchro MIDI) tiennent dans Settings, copie RAM d'un seul enregistrement
+// EEPROM (EEPROM_ADDR_SETTINGS) : octet de version, champs, CRC-16. Les modules lisent leur champ
+// au démarrage (et le valident comme avant), puis modifient settings et appellent saveSettings() :
+// EEPROM.put() ne reprogramme que les octets changés (le champ et le CRC).
+//
+// Migration au démarrage : une unité à l'ancien schéma (version 1 : un champ par adresse EEPROM,
+// sans en-tête) est reprise champ par champ, sans retour aux valeurs par défaut. L'ancien schéma
+// reste en place ; un enregistrement coupé pendant l'écriture échoue au CRC et les réglages
+// repartent de leurs valeurs par défaut. Changer Settings = incrémenter SETTINGS_VERSION (conf.h)
+// et ajouter l'étape correspondante à migrateSettings().
+//
+// Console série (115200 bauds, une ligne par commande, coupée avec MIDI_ENABLED) :
+//   "REGLAGES"            -> "REGLAGES <hex>" : l'enregistrement complet (version, champs, CRC)
+//   "REGLAGES <hex>"      -> "OK", ou "ERR crc" / "ERR version" / "ERR occupe" / "ERR format"
+// La ligne exportée se renvoie telle quelle à une autre unité (tools/reglages.py) : une trame de
+// 41 caractères et au plus 16 octets EEPROM à programmer, moins de 100 ms. Refusée pendant un
+// décompte ou quand le métronome bat ; appliquée tout de suite (mêmes validations qu'au démarrage).
+// Les commandes forment une table (nom, tampon de l'argument, action) : avec INPUT_JOURNAL s'y
+// ajoutent "JOURNAL" et "REJOUER" (journal.h), dont les trames font jusqu'à 344 caractères.
+#ifndef REGLAGES_H
+#define REGLAGES_H
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include "conf.h"
+
+// Schéma SETTINGS_VERSION : ne pas réordonner sans migration
+struct Settings {
+  byte melody;             // Mélodie de fin (0..NUM_MELODIES-1)
+  byte preset;             // 0 = Manuel, n = emplacement n-1 de la bibliothèque (presets.h)
+  uint16_t manualSeconds;  // Temps cible en mode Manuel
+  byte sleepDelay;         // Indice dans SLEEP_DELAY_VALUES
+  byte buzzerFeedback;     // 0 = bips de l'interface coupés
+  byte timerMelody;        // 0 = pas de mélodie en fin de décompte
+  uint16_t bpm;            // Tempo du métronome
+  byte tsNum;              // Signature rythmique X/Y
+  byte tsDen;
+  byte midiSync;           // MidiSync (midi.h)
+};
+
+extern Settings settings;
+
+void loadSettings();            // Au démarrage, avant les setup...() qui lisent settings
+void saveSettings();            // Après chaque modification de settings
+void serviceSettingsConsole();  // Commandes "REGLAGES" reçues sur le port série, à chaque passe de loop()
+
+// Fonction du .ino principal : préférences relues depuis settings après un import
+void applySettings();
+
+#endif // REGLAGES_H
@@ -0,0 +1,155 @@
+// sorties.cpp - Calendrier des sorties programmées et écriture directe des ports
+
+#include "sorties.h"
+#include "rapport.h"
+#include <limits.h>
+#include <util/atomic.h>
+
+enum OutputPhase : byte { OUTPUTS_IDLE, OUTPUTS_RUNNING, OUTPUTS_PAUSED };
+
+struct OutputChannel {
+  volatile uint8_t* port; // PORTx de la broche (portOutputRegister)
+  uint8_t mask;
+  bool active;
+};
+
+OutputChannelStats outputStats[NUM_OUTPUT_CHANNELS];
+
+static OutputChannel channels[NUM_OUTPUT_CHANNELS];
+static OutputPhase phase = OUTPUTS_IDLE;
+static unsigned long timelineOrigin = 0; // millis() correspondant au départ du décompte
+static long timelineDuration = 0;        // Durée du décompte (ms) : position du repère de fin
+static long timelineResume = 0;          // Position du dernier départ/reprise : fronts imposés avant
+static long timelineStop = 0;            // Dernier front du calendrier
+
+static long anchoredTime(byte anchor, long delayMs) {
+  return anchor == OUT_FROM_END ? timelineDuration + delayMs : delayMs;
+}
+
+// État d'un canal à l'instant t ; edgeAt = instant du dernier changement prévu, nextAt = du prochain
+static bool channelStateAt(const OutputChannelConfig& cfg, long t, long& edgeAt, long& nextAt) {
+  long on = anchoredTime(cfg.onAnchor, cfg.onDelay);
+  long off = anchoredTime(cfg.offAnchor, cfg.offDelay);
+  if (t < on)   { edgeAt = LONG_MIN; nextAt = on < off ? on : LONG_MAX; return false; }
+  if (t >= off) { edgeAt = on < off ? off : LONG_MIN; nextAt = LONG_MAX; return false; }
+
+  unsigned long period = (unsigned long)cfg.pulseOnMs + cfg.pulseOffMs;
+  if (cfg.pulseOnMs == 0 || cfg.pulseOffMs == 0) { edgeAt = on; nextAt = off; return true; }
+  long cycleStart = t - (long)((unsigned long)(t - on) % period);
+  bool pulseHigh = t - cycleStart < (long)cfg.pulseOnMs;
+  edgeAt = pulseHigh ? cycleStart : cycleStart + cfg.pulseOnMs;
+  nextAt = pulseHigh ? cycleStart + cfg.pulseOnMs : cycleStart + (long)period;
+  if (nextAt > off) nextAt = off;
+  return pulseHigh;
+}
+
+static void writeChannels(const bool* state) {
+  // Toutes les sorties changent dans le même bloc, sans ISR intercalée entre lecture et écriture
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    for (byte i = 0; i < NUM_OUTPUT_CHANNELS; i++) {
+      if (state[i] == channels[i].active) continue;
+      channels[i].active = state[i];
+      bool level = state[i] != (bool)pgm_read_byte(&OUTPUT_CHANNELS[i].activeLow);
+      if (level) { *channels[i].port |= channels[i].mask; }
+      else { *channels[i].port &= ~channels[i].mask; }
+    }
+  }
+}
+
+static void forceAllInactive() {
+  bool state[NUM_OUTPUT_CHANNELS] = {};
+  writeChannels(state);
+}
+
+void setupOutputs() {
+  for (byte i = 0; i < NUM_OUTPUT_CHANNELS; i++) {
+    byte pin = pgm_read_byte(&OUTPUT_CHANNELS[i].pin);
+    channels[i].port = portOutputRegister(digitalPinToPort(pin));
+    channels[i].mask = digitalPinToBitMask(pin);
+    channels[i].active = true; // Force l'écriture du niveau inactif ci-dessous
+    pinMode(pin, OUTPUT);
+  }
+  forceAllInactive();
+}
+
+void outputsRunStart(unsigned long durationMs, unsigned long remainingMs) {
+  timelineDuration = (long)durationMs;
+  timelineResume = (long)(durationMs - remainingMs);
+  timelineOrigin = millis() - (unsigned long)timelineResume;
+  timelineStop = timelineDuration;
+  for (byte i = 0; i < NUM_OUTPUT_CHANNELS; i++) {
+    OutputChannelConfig cfg;
+    memcpy_P(&cfg, &OUTPUT_CHANNELS[i], sizeof(cfg));
+    long off = anchoredTime(cfg.offAnchor, cfg.offDelay);
+    if (off > timelineStop) timelineStop = off;
+  }
+  phase = OUTPUTS_RUNNING;
+  serviceOutputs();
+}
+
+void outputsPause() {
+  phase = OUTPUTS_PAUSED;
+  forceAllInactive();
+}
+
+void outputsStop() {
+  phase = OUTPUTS_IDLE;
+  forceAllInactive();
+}
+
+void serviceOutputs() {
+  if (phase != OUTPUTS_RUNNING) return;
+  long t = (long)(millis() - timelineOrigin);
+
+  bool state[NUM_OUTPUT_CHANNELS];
+  for (byte i = 0; i < NUM_OUTPUT_CHANNELS; i++) {
+    OutputChannelConfig cfg;
+    memcpy_P(&cfg, &OUTPUT_CHANNELS[i], sizeof(cfg));
+    long edgeAt, nextAt;
+    state[i] = channelStateAt(cfg, t, edgeAt, nextAt);
+    if (state[i] == channels[i].active) continue;
+
+    // Front prévu avant le départ/la reprise : imposé à la reprise, pas en retard
+    if (edgeAt < timelineResume) edgeAt = timelineResume;
+    unsigned long late = (unsigned long)(t - edgeAt);
+    unsigned int error = late > 0xFFFF ? 0xFFFF : (unsigned int)late;
+    OutputChannelStats& stats = outputStats[i];
+    stats.edges++;
+    stats.lastErrorMs = error;
+    stats.totalErrorMs += error;
+    if (error > stats.maxErrorMs) stats.maxErrorMs = error;
+  }
+  writeChannels(state);
+
+  if (t >= timelineStop) {
+    phase = OUTPUTS_IDLE; // Plus aucun front à venir : calendrier terminé
+    reportOutputStats();
+  }
+}
+
+long outputsMillisToNextEdge() {
+  if (phase != OUTPUTS_RUNNING) return LONG_MAX;
+  long t = (long)(millis() - timelineOrigin);
+  long next = LONG_MAX;
+  for (byte i = 0; i < NUM_OUTPUT_CHANNELS; i++) {
+    OutputChannelConfig cfg;
+    memcpy_P(&cfg, &OUTPUT_CHANNELS[i], sizeof(cfg));
+    long edgeAt, nextAt;
+    channelStateAt(cfg, t, edgeAt, nextAt);
+    if (nextAt < next) next = nextAt;
+  }
+  return next == LONG_MAX ? LONG_MAX : next - t;
+}
+
+void reportOutputStats() {
+  for (byte i = 0; i < NUM_OUTPUT_CHANNELS; i++) {
+    const OutputChannelStats& stats = outputStats[i];
+    Report.print(F("Sortie ")); Report.print(i);
+    Report.print(F(" (D")); Report.print(pgm_read_byte(&OUTPUT_CHANNELS[i].pin));
+    Report.print(F(") fronts=")); Report.print(stats.edges);
+    Report.print(F(" retard dernier=")); Report.print(stats.lastErrorMs);
+    Report.print(F(" moy=")); Report.print(stats.edges ? stats.totalErrorMs / stats.edges : 0);
+    Report.print(F(" max=")); Report.print(stats.maxErrorMs);
+    Report.println(F(" ms"));
+  }
+}
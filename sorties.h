@@ -0,0 +1,54 @@
+// sorties.h - Sorties programmées (relais, lampe, flash...) pendant le décompte
+//
+// Chaque canal suit un calendrier lu en PROGMEM (OUTPUT_CHANNELS, défini dans le .ino) : une
+// fenêtre d'activité dont le début et la fin sont repérés par rapport au DÉPART ou à la FIN du
+// décompte (délai en ms, négatif = avant le repère), éventuellement découpée en train
+// d'impulsions. Le minuteur ne pilote plus les broches : il signale départ / pause / arrêt et
+// serviceOutputs() (loop() et yield(), donc aussi pendant les delay() des mélodies) calcule l'état
+// de tous les canaux sur une même base de temps puis les écrit d'un seul bloc, directement dans
+// les registres PORTx (port et masque mis en cache au démarrage, interruptions coupées : tone()
+// modifie PORTB depuis son ISR).
+//
+// Chaque front est daté : l'écart entre l'instant prévu par le calendrier et l'écriture réelle
+// (retard en ms, dû à la boucle, aux écritures I2C ou au réveil du WDT) est cumulé par canal.
+// Pause et arrêt coupent toutes les sorties ; après la fin du décompte, les fenêtres repérées
+// sur la fin continuent jusqu'à leur dernier front.
+#ifndef SORTIES_H
+#define SORTIES_H
+
+#include <Arduino.h>
+#include "conf.h"
+
+enum OutputAnchor : byte { OUT_FROM_START, OUT_FROM_END };
+
+struct OutputChannelConfig {
+  byte pin;
+  bool activeLow;           // Module relais courant : actif à LOW
+  byte onAnchor;            // Repère du début de fenêtre (OutputAnchor)
+  long onDelay;             // ms après le repère (négatif = avant)
+  byte offAnchor;           // Repère de la fin de fenêtre
+  long offDelay;
+  unsigned int pulseOnMs;   // Train d'impulsions dans la fenêtre (0 = sortie continue)
+  unsigned int pulseOffMs;
+};
+
+// Déclaration seulement (la définition = { ... } est dans le .ino)
+extern const OutputChannelConfig OUTPUT_CHANNELS[] PROGMEM;
+
+struct OutputChannelStats {
+  unsigned int edges;          // Fronts produits par le calendrier
+  unsigned int lastErrorMs;    // Retard du dernier front
+  unsigned int maxErrorMs;     // Plus grand retard
+  unsigned long totalErrorMs;  // Somme des retards (moyenne = total / fronts)
+};
+extern OutputChannelStats outputStats[NUM_OUTPUT_CHANNELS];
+
+void setupOutputs();                                                // Broches en sortie, canaux inactifs
+void outputsRunStart(unsigned long durationMs, unsigned long remainingMs); // Départ ou reprise du décompte
+void outputsPause();                                                // Toutes les sorties coupées, calendrier figé
+void outputsStop();                                                 // Arrêt : sorties coupées, fenêtres abandonnées
+void serviceOutputs();                                              // Tick unique du calendrier
+long outputsMillisToNextEdge();                                     // Prochain front prévu (LONG_MAX si aucun)
+void reportOutputStats();                                           // Retards par canal sur le port série
+
+#endif // SORTIES_H
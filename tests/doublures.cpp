@@ -0,0 +1,53 @@
+// doublures.cpp - Reste du sketch pour les tests : variables globales du .ino et modules sans effet
+//
+// Ce que timer.cpp et metronome.cpp appellent hors de leur sujet (réglages, presets, points de
+// reprise, sorties, veille...) ne fait rien ici. L'afficheur, le buzzer et les lignes d'infos du
+// .ino sont propres à chaque test.
+#include "hote.h"
+#include "../timer.h"
+#include "../metronome.h"
+
+AppFlags appFlags = { false, false, false };
+Settings settings;
+ModeState modeState;
+Mode currentMode = MODE_TIMER;
+TimerRunState currentTimerState = STATE_IDLE;
+MetronomeRunState currentMetroState = METRO_STOPPED;
+unsigned int targetTotalSeconds = 0;
+byte currentMelodyChoice = 0;
+byte currentPresetChoice = 1;
+int currentBPM = DEFAULT_BPM;
+byte timeSignatureNum = 4;
+byte timeSignatureDen = 4;
+const TempoMarking tempoMarkings[NUM_TEMPO_MARKINGS] PROGMEM = {
+  {"T0", "", 20, 22}, {"T1", "", 25, 35}, {"T2", "", 40, 48}, {"T3", "", 55, 58},
+  {"T4", "", 60, 63}, {"T5", "", 66, 70}, {"T6", "", 72, 74}, {"T7", "", 76, 84},
+  {"T8", "", 92, 95}, {"T9", "", 98, 102}, {"T10", "", 108, 112}, {"T11", "", 116, 120},
+  {"T12", "", 124, 138}, {"T13", "", 156, 162}, {"T14", "", 168, 184}, {"T15", "", 200, 208}
+};
+
+void buzzerSilence(SoundPriority) {}
+void playMelody(byte) {}
+void playClickSound() {}
+void requestDisplay(DisplayPriority, DisplayRenderFn) {}
+void resetActivityTimer() {}
+void checkIdleSleep() {}
+void ignoreWakeInput() {}
+void setMode(Mode mode) { currentMode = mode; }
+void saveSettings() {}
+void selectPreset(byte) {}
+unsigned int presetTargetSeconds() { return targetTotalSeconds; }
+byte progressForRemaining(uint32_t, uint32_t) { return 0; }
+void resetProgress(byte) {}
+void setProgress(byte) {}
+void outputsRunStart(uint32_t, uint32_t) {}
+void outputsPause() {}
+void outputsStop() {}
+void checkpointBegin() {}
+bool checkpointRestore(unsigned int&, unsigned int&) { return false; }
+void checkpointSave(TimerRunState, uint32_t) {}
+void checkpointClear() {}
+void serviceCheckpoint(uint32_t) {}
+bool serviceLowPowerRun() { return false; }
+void lowPowerRunBegin() {}
+void lowPowerRunEnd() {}
@@ -0,0 +1,124 @@
+// hote.cpp - Arduino simulé des tests : horloge virtuelle, Print, Serial, EEPROM, registres
+
+#include <string> // Avant Arduino.h : ses macros min() / max() gênent la bibliothèque standard
+#include <stdarg.h>
+#include <stdio.h>
+#define HOST_NATIVE_LONG // Aucun module du sketch ici : long du PC (Arduino.h)
+#include "hote.h"
+#include <EEPROM.h>
+
+static uint64_t nowMicros = 0;
+static std::string serialText;
+
+void (*hostTwiControlWritten)() = nullptr;
+void (*hostBusWait)() = nullptr;
+
+HostTwiControl& HostTwiControl::operator=(uint8_t value) {
+  _value = value;
+  if (hostTwiControlWritten) hostTwiControlWritten();
+  return *this;
+}
+
+HostTwiControl::operator uint8_t() const {
+  if (hostBusWait) hostBusWait();
+  return _value;
+}
+
+HostTwiControl TWCR;
+volatile uint8_t TWDR, TWBR, TWSR, WDTCSR, MCUSR, SREG, SMCR, MCUCR, PRR,
+                 UCSR0A, UCSR0B, UCSR0C, UBRR0L, UBRR0H, UDR0,
+                 TCCR1A, TCCR1B, TIMSK1, TIFR1, PCMSK2, PCICR, PCIFR,
+                 ACSR, ADCSRB, DIDR1, PORTB, PORTD, PIND;
+volatile uint16_t OCR1A, TCNT1, ICR1;
+
+uint8_t hostEeprom[1024];
+EEPROMClass EEPROM;
+HardwareSerial Serial;
+
+struct EepromErased { EepromErased() { memset(hostEeprom, 0xFF, sizeof(hostEeprom)); } };
+static EepromErased eepromErased;
+
+// Interruptions permises, comme après init() du cœur Arduino : l'ISR TWI est appelée par le bus simulé
+struct InterruptsEnabled { InterruptsEnabled() { SREG = _BV(SREG_I); } };
+static InterruptsEnabled interruptsEnabled;
+
+// --- Horloge ---
+
+void hostSetMillis(uint32_t ms) { nowMicros = (uint64_t)ms * 1000; }
+void hostAdvanceMicros(uint32_t us) { nowMicros += us; }
+void hostAdvanceMillis(uint32_t ms) { nowMicros += (uint64_t)ms * 1000; }
+uint64_t hostNowMicros() { return nowMicros; }
+
+uint32_t millis() { return (uint32_t)(nowMicros / 1000); }
+uint32_t micros() {
+  if (hostBusWait) hostBusWait();
+  return (uint32_t)nowMicros;
+}
+void delay(unsigned long ms) { hostAdvanceMillis(ms); }
+void delayMicroseconds(unsigned int us) { hostAdvanceMicros(us); }
+void yield() {}
+
+// --- Broches, son : sans effet ---
+
+void tone(uint8_t, unsigned int, unsigned long) {}
+void noTone(uint8_t) {}
+void pinMode(uint8_t, uint8_t) {}
+void digitalWrite(uint8_t, uint8_t) {}
+int digitalRead(uint8_t) { return HIGH; }
+int analogRead(uint8_t) { return 0; }
+void attachInterrupt(uint8_t, void (*)(), int) {}
+
+// --- Port série ---
+
+size_t HardwareSerial::write(uint8_t value) {
+  serialText += (char)value;
+  return 1;
+}
+
+const char* hostSerialText() { return serialText.c_str(); }
+void hostSerialClear() { serialText.clear(); }
+
+// --- Print ---
+
+static size_t printNumber(Print& out, unsigned long value, int base, bool negative) {
+  char digits[34];
+  char* p = &digits[sizeof(digits) - 1];
+  *p = '\0';
+  do {
+    unsigned long digit = value % base;
+    *--p = digit < 10 ? '0' + digit : 'A' + digit - 10;
+    value /= base;
+  } while (value != 0);
+  if (negative) *--p = '-';
+  return out.write(p);
+}
+
+size_t Print::print(const __FlashStringHelper* s) { return write((const char*)s); }
+size_t Print::print(const char* s) { return write(s); }
+size_t Print::print(char c) { return write((uint8_t)c); }
+size_t Print::print(unsigned char value, int base) { return printNumber(*this, value, base, false); }
+size_t Print::print(unsigned int value, int base) { return printNumber(*this, value, base, false); }
+size_t Print::print(unsigned long value, int base) { return printNumber(*this, value, base, false); }
+size_t Print::print(int value, int base) { return print((long)value, base); }
+size_t Print::print(long value, int base) {
+  if (base == DEC && value < 0) return printNumber(*this, -(unsigned long)value, DEC, true);
+  return printNumber(*this, (unsigned long)value, base, false);
+}
+size_t Print::print(double value, int digits) {
+  char text[32];
+  snprintf(text, sizeof(text), "%.*f", digits, value);
+  return write(text);
+}
+size_t Print::println() { return write("\r\n"); }
+
+// --- Vérifications ---
+
+void hostFail(const char* file, int line, const char* condition, const char* format, ...) {
+  fprintf(stderr, "%s:%d: ECHEC %s : ", file, line, condition);
+  va_list args;
+  va_start(args, format);
+  vfprintf(stderr, format, args);
+  va_end(args);
+  fputc('\n', stderr);
+  exit(1);
+}
@@ -0,0 +1,26 @@
+// hote.h - Contrôle de l'Arduino simulé des tests : horloge virtuelle, port série, bus I2C
+//
+// L'horloge ne bouge que par hostAdvanceMicros() / hostAdvanceMillis() ou par delay() dans le code
+// testé : un test reproduit exactement la même suite de passes à chaque exécution. millis() et
+// micros() repassent par zéro comme sur le Nano (49,7 jours / 71,6 minutes).
+#ifndef HOTE_H
+#define HOTE_H
+
+#include <Arduino.h>
+
+void hostSetMillis(uint32_t ms);          // Remet l'horloge à ms (micros() = ms * 1000 modulo 2^32)
+void hostAdvanceMicros(uint32_t us);
+void hostAdvanceMillis(uint32_t ms);
+uint64_t hostNowMicros();                 // Temps virtuel sans repassage par zéro
+
+const char* hostSerialText();             // Tout ce qui a été écrit sur Serial depuis hostSerialClear()
+void hostSerialClear();
+
+extern void (*hostTwiControlWritten)();   // Appelé à chaque écriture de TWCR (nullptr : bus absent)
+extern void (*hostBusWait)();             // Appelé quand le code testé lit TWCR ou micros() : il attend peut-être le bus
+
+// Vérification : message et arrêt du test au premier échec
+#define CHECK(cond, ...) do { if (!(cond)) { hostFail(__FILE__, __LINE__, #cond, __VA_ARGS__); } } while (0)
+void hostFail(const char* file, int line, const char* condition, const char* format, ...);
+
+#endif // HOTE_H
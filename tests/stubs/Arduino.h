@@ -0,0 +1,144 @@
+// Arduino.h (tests) - Cœur Arduino réduit pour compiler les modules du sketch sur le PC
+//
+// Juste ce que les modules testés utilisent : types, macros PROGMEM (la flash est la mémoire
+// ordinaire), Print, Serial, broches sans effet. millis() et micros() lisent l'horloge virtuelle
+// de hote.h : elle n'avance que lorsque le test le décide, delay() compris.
+//
+// long fait 32 bits sur l'AVR et 64 sur le PC : après les en-têtes système (tous inclus ici),
+// long devient int (32 bits), pour que les différences de millis(), leurs repassages par zéro
+// et la disposition des structures soient ceux du Nano. Les tests calculent en int64_t / uint64_t et n'écrivent
+// jamais long ; hote.cpp, qui ne voit aucun module du sketch, garde le long du PC
+// (HOST_NATIVE_LONG). int reste sur 32 bits (16 sur l'AVR) : les modules testés n'en dépendent pas.
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <math.h>
+#include <avr/io.h>
+#include "binary.h"
+
+#define F_CPU 16000000UL
+#define SDA 18
+#define SCL 19
+
+typedef uint8_t byte;
+typedef bool boolean;
+typedef uint16_t word;
+
+#define PROGMEM
+#define PGM_P const char*
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper*>(s))
+#define PSTR(s) (s)
+#define pgm_read_byte(p) (*(const uint8_t*)(p))
+#define pgm_read_word(p) (*(const uint16_t*)(p))
+#define pgm_read_dword(p) (*(const uint32_t*)(p))
+#define pgm_read_ptr(p) (*(void* const*)(p))
+#define memcpy_P memcpy
+#define strlen_P strlen
+#define strncpy_P strncpy
+#define strcpy_P strcpy
+#define strcmp_P strcmp
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+#define DEC 10
+#define HEX 16
+
+#define _BV(b) (1u << (b))
+#define bit(b) (1UL << (b))
+#define bitRead(v, b) (((v) >> (b)) & 1)
+#define min(a, b) ((a) < (b) ? (a) : (b))
+#define max(a, b) ((a) > (b) ? (a) : (b))
+#define constrain(x, a, b) ((x) < (a) ? (a) : ((x) > (b) ? (b) : (x)))
+
+// Pas d'interruptions sur le PC : les ISR sont des fonctions que le test appelle
+#define ISR(v) extern "C" void v(void)
+#define cli() do {} while (0)
+#define sei() do {} while (0)
+#define noInterrupts() do {} while (0)
+#define interrupts() do {} while (0)
+
+#define digitalPinToPCMSKbit(p) ((p) & 7)
+#define digitalPinToPCICRbit(p) 2
+#define digitalPinToInterrupt(p) (p)
+
+uint32_t millis();
+uint32_t micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+void tone(uint8_t pin, unsigned int frequency, unsigned long duration = 0);
+void noTone(uint8_t pin);
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+void attachInterrupt(uint8_t interrupt, void (*handler)(), int mode);
+
+class Print {
+  public:
+    virtual size_t write(uint8_t value) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size) { size_t n = 0; while (size--) n += write(*buffer++); return n; }
+    size_t write(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+    size_t print(const __FlashStringHelper* s);
+    size_t print(const char* s);
+    size_t print(char c);
+    size_t print(unsigned char value, int base = DEC);
+    size_t print(int value, int base = DEC);
+    size_t print(unsigned int value, int base = DEC);
+    size_t print(long value, int base = DEC);
+    size_t print(unsigned long value, int base = DEC);
+    size_t print(double value, int digits = 2);
+    size_t println();
+    template <class T> size_t println(T value) { size_t n = print(value); return n + println(); }
+    template <class T> size_t println(T value, int base) { size_t n = print(value, base); return n + println(); }
+    virtual void flush() {}
+};
+
+class Stream : public Print {
+  public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+};
+
+// Port série : ce qui est écrit s'accumule dans hostSerialText() (hote.h), rien n'est reçu
+class HardwareSerial : public Stream {
+  public:
+    void begin(unsigned long) {}
+    void end() {}
+    int available() { return 0; }
+    int read() { return -1; }
+    int peek() { return -1; }
+    int availableForWrite() { return 63; }
+    size_t write(uint8_t value);
+    using Print::write;
+    void flush() {}
+    operator bool() { return true; }
+};
+extern HardwareSerial Serial;
+
+#ifndef HOST_NATIVE_LONG
+#define long int
+#undef LONG_MIN
+#undef LONG_MAX
+#undef ULONG_MAX
+#define LONG_MIN INT32_MIN
+#define LONG_MAX INT32_MAX
+#define ULONG_MAX UINT32_MAX
+#endif
+
+#endif // ARDUINO_H
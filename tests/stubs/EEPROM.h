@@ -0,0 +1,21 @@
+// EEPROM.h (tests) - EEPROM de 1 Ko en mémoire, effacée (0xFF) au lancement du test
+#ifndef EEPROM_H
+#define EEPROM_H
+
+#include <stdint.h>
+#include <string.h>
+
+extern uint8_t hostEeprom[1024];
+
+struct EEPROMClass {
+  uint8_t read(int address) { return hostEeprom[address]; }
+  void write(int address, uint8_t value) { hostEeprom[address] = value; }
+  void update(int address, uint8_t value) { hostEeprom[address] = value; }
+  template <class T> T& get(int address, T& value) { memcpy(&value, &hostEeprom[address], sizeof(T)); return value; }
+  template <class T> const T& put(int address, const T& value) { memcpy(&hostEeprom[address], &value, sizeof(T)); return value; }
+  uint16_t length() { return sizeof(hostEeprom); }
+  uint8_t operator[](int address) const { return hostEeprom[address]; }
+};
+extern EEPROMClass EEPROM;
+
+#endif // EEPROM_H
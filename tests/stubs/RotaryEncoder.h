@@ -0,0 +1,19 @@
+// RotaryEncoder.h (tests) - Encodeur immobile : les tests appellent directement les gestionnaires
+#ifndef ROTARY_ENCODER_H
+#define ROTARY_ENCODER_H
+
+#include <stdint.h>
+
+class RotaryEncoder {
+  public:
+    enum class Direction { NOROTATION = 0, CLOCKWISE = 1, COUNTERCLOCKWISE = -1 };
+    RotaryEncoder(int, int) {}
+    void tick() {}
+    long getPosition() { return _position; }
+    void setPosition(long position) { _position = position; }
+    Direction getDirection() { return Direction::NOROTATION; }
+  private:
+    long _position = 0;
+};
+
+#endif // ROTARY_ENCODER_H
@@ -0,0 +1,13 @@
+// avr/eeprom.h (tests) - Accès octet par octet à l'EEPROM en mémoire de EEPROM.h
+#ifndef AVR_EEPROM_H
+#define AVR_EEPROM_H
+
+#include <EEPROM.h>
+
+inline uint8_t eeprom_read_byte(const uint8_t* address) { return hostEeprom[(uintptr_t)address]; }
+inline void eeprom_write_byte(uint8_t* address, uint8_t value) { hostEeprom[(uintptr_t)address] = value; }
+inline void eeprom_update_byte(uint8_t* address, uint8_t value) { hostEeprom[(uintptr_t)address] = value; }
+inline int eeprom_is_ready() { return 1; }
+inline void eeprom_busy_wait() {}
+
+#endif // AVR_EEPROM_H
@@ -0,0 +1,2 @@
+// avr/interrupt.h (tests) - ISR(), cli() et sei() sont dans Arduino.h
+#include <Arduino.h>
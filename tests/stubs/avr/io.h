@@ -0,0 +1,39 @@
+// avr/io.h (tests) - Registres de l'ATmega328P utilisés par le sketch, en variables ordinaires
+#ifndef AVR_IO_H
+#define AVR_IO_H
+
+#include <stdint.h>
+
+// TWCR : chaque écriture prévient le simulateur du bus I2C du test (hote.h), comme le matériel
+// qui démarre l'étape suivante dès que TWINT est acquitté ; chaque lecture aussi (attente du bus)
+class HostTwiControl {
+  public:
+    HostTwiControl& operator=(uint8_t value);
+    operator uint8_t() const;
+    void hostLoad(uint8_t value) { _value = value; } // Écriture du matériel simulé, sans rappel
+  private:
+    volatile uint8_t _value = 0;
+};
+extern HostTwiControl TWCR;
+
+extern volatile uint8_t TWDR, TWBR, TWSR, WDTCSR, MCUSR, SREG, SMCR, MCUCR, PRR,
+                        UCSR0A, UCSR0B, UCSR0C, UBRR0L, UBRR0H, UDR0,
+                        TCCR1A, TCCR1B, TIMSK1, TIFR1, PCMSK2, PCICR, PCIFR,
+                        ACSR, ADCSRB, DIDR1, PORTB, PORTD, PIND;
+extern volatile uint16_t OCR1A, TCNT1, ICR1;
+
+enum {
+  TWINT = 7, TWEA = 6, TWSTA = 5, TWSTO = 4, TWWC = 3, TWEN = 2, TWIE = 0, TWPS0 = 0, TWPS1 = 1,
+  WDIF = 7, WDIE = 6, WDP3 = 5, WDCE = 4, WDE = 3, WDP2 = 2, WDP1 = 1, WDP0 = 0, WDRF = 3,
+  BORF = 2, EXTRF = 1, PORF = 0,
+  RXC0 = 7, TXC0 = 6, UDRE0 = 5, FE0 = 4, DOR0 = 3, U2X0 = 1,
+  RXCIE0 = 7, TXCIE0 = 6, UDRIE0 = 5, RXEN0 = 4, TXEN0 = 3, UCSZ01 = 2, UCSZ00 = 1,
+  WGM13 = 4, WGM12 = 3, CS12 = 2, CS11 = 1, CS10 = 0, OCIE1A = 1, TOIE1 = 0, OCF1A = 1,
+  PCINT16 = 0, PCINT18 = 2, PCINT20 = 4, PCINT22 = 6, PCIE2 = 2, PCIF2 = 2,
+  ACD = 7, ACBG = 6, ACO = 5, ACI = 4, ACIE = 3, ACIS1 = 1, ACIS0 = 0, AIN1D = 1, AIN0D = 0,
+  SREG_I = 7
+};
+
+#define RAMEND 0x8FF
+
+#endif // AVR_IO_H
@@ -0,0 +1,2 @@
+// avr/pgmspace.h (tests) - Macros PROGMEM dans Arduino.h (la flash est la mémoire ordinaire)
+#include <Arduino.h>
@@ -0,0 +1,2 @@
+// avr/power.h (tests) - Rien à couper sur le PC
+#include <avr/io.h>
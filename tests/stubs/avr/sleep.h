@@ -0,0 +1,18 @@
+// avr/sleep.h (tests) - La veille rend la main tout de suite
+#ifndef AVR_SLEEP_H
+#define AVR_SLEEP_H
+
+#include <avr/io.h>
+
+#define SLEEP_MODE_IDLE 0
+#define SLEEP_MODE_PWR_DOWN 2
+#define SLEEP_MODE_PWR_SAVE 3
+
+inline void set_sleep_mode(int) {}
+inline void sleep_enable() {}
+inline void sleep_disable() {}
+inline void sleep_cpu() {}
+inline void sleep_mode() {}
+inline void sleep_bod_disable() {}
+
+#endif // AVR_SLEEP_H
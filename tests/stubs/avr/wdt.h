@@ -0,0 +1,15 @@
+// avr/wdt.h (tests) - Chien de garde sans effet
+#ifndef AVR_WDT_H
+#define AVR_WDT_H
+
+#include <avr/io.h>
+
+#define WDTO_15MS 0
+#define WDTO_1S 6
+#define WDTO_8S 9
+
+inline void wdt_reset() {}
+inline void wdt_disable() {}
+inline void wdt_enable(int) {}
+
+#endif // AVR_WDT_H
@@ -0,0 +1,9 @@
+// util/atomic.h (tests) - Pas d'interruption à masquer : le bloc s'exécute une fois
+#ifndef UTIL_ATOMIC_H
+#define UTIL_ATOMIC_H
+
+#define ATOMIC_RESTORESTATE 0
+#define ATOMIC_FORCEON 1
+#define ATOMIC_BLOCK(type) for (int atomicOnce_ = 1; atomicOnce_; atomicOnce_ = 0)
+
+#endif // UTIL_ATOMIC_H
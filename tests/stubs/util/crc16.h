@@ -0,0 +1,13 @@
+// util/crc16.h (tests) - _crc16_update() d'avr-libc (polynôme 0xA001)
+#ifndef UTIL_CRC16_H
+#define UTIL_CRC16_H
+
+#include <stdint.h>
+
+inline uint16_t _crc16_update(uint16_t crc, uint8_t data) {
+  crc ^= data;
+  for (uint8_t i = 0; i < 8; i++) crc = (crc & 1) ? (crc >> 1) ^ 0xA001 : crc >> 1;
+  return crc;
+}
+
+#endif // UTIL_CRC16_H
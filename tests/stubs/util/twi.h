@@ -0,0 +1,18 @@
+// util/twi.h (tests) - Codes d'état du TWI (fiche ATmega328P, tableau 22-2)
+#ifndef UTIL_TWI_H
+#define UTIL_TWI_H
+
+#include <avr/io.h>
+
+#define TW_STATUS (TWSR & 0xF8)
+#define TW_START 0x08
+#define TW_REP_START 0x10
+#define TW_MT_SLA_ACK 0x18
+#define TW_MT_SLA_NACK 0x20
+#define TW_MT_DATA_ACK 0x28
+#define TW_MT_DATA_NACK 0x30
+#define TW_MT_ARB_LOST 0x38
+#define TW_WRITE 0
+#define TW_READ 1
+
+#endif // UTIL_TWI_H
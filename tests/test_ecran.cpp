@@ -0,0 +1,366 @@
+// test_ecran.cpp - Octets I2C par trame de l'écran du minuteur, sur un bus TWI simulé
+//
+// ecran_bus.cpp, ecran_lcd.cpp, ecran_oled.cpp, BigNumbers_I2C.cpp et le rendu de timer.cpp tels
+// quels ; DISPLAY_OLED choisit l'afficheur (build/test_ecran_lcd, build/test_ecran_oled), et
+// build/test_ecran_lcd40 vérifie le 40x4 et ses deux contrôleurs (LCD_PANEL=4004). Le TWI
+// simulé répond à chaque écriture de TWCR comme le matériel (START, adresse, données, STOP, codes
+// d'état de util/twi.h) puis appelle TWI_vect ; il compte les octets émis, adresses comprises, et
+// décode le flux : HD44780 en 4 bits derrière le PCF8574, ou RAM du SSD1306.
+// Deux rythmes de bus encadrent le matériel :
+//  - immédiat : chaque transmission part en entier dès son START, avant le retour de
+//    displayBusWrite(). Aucune fusion (append) : c'est le coût d'avant la file, quand Wire
+//    attendait la fin de chaque envoi ;
+//  - différé : le bus n'avance que lorsque le code l'attend (lecture de TWCR ou de micros()).
+//    Toutes les écritures d'une trame fusionnent : borne basse.
+// Sur le Nano, l'ISR vide la file pendant que loop() la remplit : le coût réel est entre les deux.
+// Scènes : écran complet (effacement puis drawTimerScreen() du .ino), mise à jour des centièmes,
+// mêmes centièmes redessinés. Les octets vus sur le bus doivent égaler ceux de displayBusStats,
+// et l'écran décodé doit montrer ce que le minuteur a écrit.
+#include "hote.h"
+#include "../timer.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <util/twi.h>
+
+extern "C" void TWI_vect(void); // ISR de ecran_bus.cpp
+
+// --- Doublures propres à ce test (le reste : doublures.cpp) ---
+
+DisplayDevice LCD(LCD_ADDR, LCD_COLS, LCD_ROWS);
+BigNumberDevice bigNum(&LCD);
+
+void playSound(SoundPriority, unsigned int, unsigned int) {}
+
+// Copie du .ino
+void clearRestOfLine(byte startCol, byte row) {
+  if (startCol >= LCD_COLS) return;
+  LCD.setCursor(startCol, row);
+  for (byte c = startCol; c < LCD_COLS; c++) {
+    LCD.print(" ");
+  }
+}
+
+// displayStatusLine3() du .ino à l'arrêt, mélodie "Bip-Bip" et preset manuel
+void displayStatusLine3() {
+  if (!LCD_TALL) return;
+  clearRestOfLine(0, MELODY_NAME_ROW);
+  LCD.setCursor(MELODY_NAME_COL - 1, MELODY_NAME_ROW);
+  LCD.print(F("*"));
+  LCD.print("Bip-Bip  ");
+  LCD.print(F("|"));
+  LCD.print("Manuel");
+}
+
+// --- Écran décodé ---
+
+#if DISPLAY_OLED
+
+// RAM du SSD1306 : 8 pages de 128 colonnes, fenêtre et pointeur de l'adressage horizontal
+static byte oledRam[8][128];
+static byte colStart = 0, colEnd = 127, pageStart = 0, pageEnd = 7, ramCol = 0, ramPage = 0;
+static byte command[3];            // Commande en cours et ses arguments
+static byte commandLen = 0, commandArgs = 0;
+static bool controlNext = false;   // Premier octet de la transmission : octet de contrôle
+static bool dataMode = false;
+
+static byte argumentCount(byte cmd) {
+  switch (cmd) {
+    case 0x21: case 0x22: return 2;
+    case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3: case 0xD5: case 0xD9: case 0xDA: case 0xDB: return 1;
+    default: return 0;
+  }
+}
+
+static void decodeStart() {
+  controlNext = true;
+}
+
+static void decodeByte(byte value) {
+  if (controlNext) { dataMode = value == 0x40; controlNext = false; return; }
+  if (dataMode) {
+    oledRam[ramPage][ramCol] = value;
+    if (ramCol < colEnd) { ramCol++; return; }
+    ramCol = colStart;
+    ramPage = ramPage < pageEnd ? ramPage + 1 : pageStart;
+    return;
+  }
+  if (commandLen == 0) commandArgs = argumentCount(value);
+  command[commandLen++] = value;
+  if (commandLen <= commandArgs) return;
+  if (command[0] == 0x21) { colStart = command[1]; colEnd = command[2]; ramCol = colStart; }
+  if (command[0] == 0x22) { pageStart = command[1]; pageEnd = command[2]; ramPage = pageStart; }
+  commandLen = 0;
+}
+
+// Quelques caractères de la police 5x7 (ecran_oled.cpp), bit 0 en haut ; les autres ne sont pas vérifiés
+struct TestGlyph { char c; byte columns[5]; };
+static const TestGlyph GLYPHS[] = {
+  { ' ', { 0x00, 0x00, 0x00, 0x00, 0x00 } }, { '*', { 0x08, 0x2A, 0x1C, 0x2A, 0x08 } },
+  { '.', { 0x00, 0x60, 0x60, 0x00, 0x00 } }, { '0', { 0x3E, 0x51, 0x49, 0x45, 0x3E } },
+  { '1', { 0x00, 0x42, 0x7F, 0x40, 0x00 } }, { '2', { 0x42, 0x61, 0x51, 0x49, 0x46 } },
+  { '3', { 0x21, 0x41, 0x45, 0x4B, 0x31 } }, { '4', { 0x18, 0x14, 0x12, 0x7F, 0x10 } },
+  { ':', { 0x00, 0x36, 0x36, 0x00, 0x00 } }, { 'T', { 0x01, 0x01, 0x7F, 0x01, 0x01 } },
+  { '|', { 0x00, 0x00, 0x7F, 0x00, 0x00 } }
+};
+
+static byte stretch(byte nibble) { // Chaque bit doublé : police étirée x2 en hauteur
+  byte out = 0;
+  for (byte bit = 0; bit < 4; bit++) if (nibble & (1 << bit)) out |= 3 << (bit * 2);
+  return out;
+}
+
+static bool cellShows(byte col, byte row, char c) {
+  const TestGlyph* glyph = nullptr;
+  for (const TestGlyph& g : GLYPHS) if (g.c == c) glyph = &g;
+  if (glyph == nullptr) return true;
+  for (byte x = 0; x < OLED_CELL_WIDTH; x++) {
+    byte column = x < 5 ? glyph->columns[x] : 0;
+    byte ramX = OLED_X_OFFSET + col * OLED_CELL_WIDTH + x;
+    if (oledRam[row * 2][ramX] != stretch(column & 0x0F)) return false;
+    if (oledRam[row * 2 + 1][ramX] != stretch(column >> 4)) return false;
+  }
+  return true;
+}
+
+static bool textAt(byte col, byte row, const char* text) {
+  for (; *text; text++, col++) if (!cellShows(col, row, *text)) return false;
+  return true;
+}
+
+static const byte* screenBytes() { return &oledRam[0][0]; }
+static const unsigned int SCREEN_SIZE = sizeof(oledRam);
+
+// Octets de l'écran appartenant à une case de texte
+static bool inCells(unsigned int index, byte fromCol, byte toCol, byte row) {
+  byte page = index / 128, x = index % 128;
+  return page / 2 == row && x >= OLED_X_OFFSET + fromCol * OLED_CELL_WIDTH
+         && x < OLED_X_OFFSET + (toCol + 1) * OLED_CELL_WIDTH;
+}
+
+#else
+
+// HD44780 vu à travers le PCF8574 : quartet lu au front descendant de E, RS = P0, D4..D7 = P4..P7.
+// Deux contrôleurs : E1 sur P2, E2 sur P1 (40x4 seulement, lignes 2 et 3)
+static const bool DUAL = LCD_COLS * LCD_ROWS > 80;
+static byte ddram[2][128];
+struct Controller {
+  byte enable;
+  byte ddramAddress;
+  bool cgram;
+  bool fourBit;        // Après le "function set" 0x20 de l'initialisation
+  bool highPending;
+  byte highNibble;
+};
+static Controller controllers[2] = { { 0x04, 0, false, false, false, 0 }, { 0x02, 0, false, false, false, 0 } };
+static byte lastPcf = 0;
+
+static void decodeStart() {}
+
+static void decodeNibble(byte index, byte pcf) {
+  Controller& c = controllers[index];
+  byte nibble = pcf & 0xF0;
+  bool rs = pcf & 0x01;
+  if (!c.fourBit) { // Initialisation en 8 bits : un quartet = une instruction
+    if (!rs && nibble == 0x20) c.fourBit = true;
+    return;
+  }
+  if (!c.highPending) { c.highNibble = nibble; c.highPending = true; return; }
+  c.highPending = false;
+  byte value = c.highNibble | nibble >> 4;
+  if (rs) {
+    if (!c.cgram) { ddram[index][c.ddramAddress] = value; c.ddramAddress = (c.ddramAddress + 1) & 0x7F; }
+  } else if (value & 0x80) {
+    c.ddramAddress = value & 0x7F; c.cgram = false;
+  } else if (value & 0x40) {
+    c.cgram = true;
+  } else if (value == 0x01) {
+    memset(ddram[index], ' ', sizeof(ddram[index])); c.ddramAddress = 0; c.cgram = false;
+  }
+}
+
+static void decodeByte(byte pcf) {
+  for (byte i = 0; i < 2; i++) {
+    if ((lastPcf & controllers[i].enable) && !(pcf & controllers[i].enable)) decodeNibble(i, pcf);
+  }
+  lastPcf = pcf;
+}
+
+// Position de la case dans ddram (contrôleur * 128 + adresse)
+static unsigned int cellIndex(byte col, byte row) {
+  if (DUAL && row >= 2) return 128 + (row & 1 ? 0x40 : 0x00) + col;
+  return (row & 1 ? 0x40 : 0x00) + (row & 2 ? LCD_COLS : 0) + col;
+}
+
+static bool textAt(byte col, byte row, const char* text) {
+  for (; *text; text++, col++) if ((&ddram[0][0])[cellIndex(col, row)] != (byte)*text) return false;
+  return true;
+}
+
+static const byte* screenBytes() { return &ddram[0][0]; }
+static const unsigned int SCREEN_SIZE = sizeof(ddram);
+
+static bool inCells(unsigned int index, byte fromCol, byte toCol, byte row) {
+  return index >= cellIndex(fromCol, row) && index <= cellIndex(toCol, row);
+}
+
+#endif // DISPLAY_OLED
+
+// --- TWI simulé ---
+
+enum BusPace { BUS_IMMEDIATE, BUS_DEFERRED };
+static BusPace pace = BUS_IMMEDIATE;
+static bool stepPending = false;     // TWCR écrit, étape pas encore faite
+static bool busRunning = false;      // Étapes et ISR en cours (l'ISR réécrit TWCR)
+static bool inTransmission = false;  // START émis, pas encore de STOP
+static bool addressNext = false;
+static uint32_t wireBytes = 0;       // Octets émis sur le bus, adresses comprises
+static uint32_t transmissions = 0;
+
+// Étape demandée par la dernière écriture de TWCR ; rend vrai si TWI_vect doit suivre
+static bool twiStep() {
+  byte control = TWCR;
+  if (!(control & _BV(TWINT)) || !(control & _BV(TWEN))) return false;
+  if (control & _BV(TWSTO)) {
+    inTransmission = false;
+    control &= ~_BV(TWSTO);
+    if (!(control & _BV(TWSTA))) { TWCR.hostLoad(control & ~_BV(TWINT)); return false; }
+  }
+  byte status;
+  if (control & _BV(TWSTA)) {
+    status = inTransmission ? TW_REP_START : TW_START;
+    inTransmission = true;
+    addressNext = true;
+  } else if (addressNext) {
+    wireBytes++;
+    transmissions++;
+    addressNext = false;
+    status = (TWDR >> 1) == LCD_ADDR && !(TWDR & TW_READ) ? TW_MT_SLA_ACK : TW_MT_SLA_NACK;
+    decodeStart();
+  } else {
+    wireBytes++;
+    decodeByte(TWDR);
+    status = TW_MT_DATA_ACK;
+  }
+  TWSR = status;
+  TWCR.hostLoad(control | _BV(TWINT)); // Étape finie : TWINT levé par le matériel
+  return control & _BV(TWIE);
+}
+
+static void runBus() {
+  if (busRunning) return;
+  busRunning = true;
+  while (stepPending) {
+    stepPending = false;
+    if (twiStep()) TWI_vect();
+  }
+  busRunning = false;
+}
+
+static void controlWritten() {
+  stepPending = true;
+  if (pace == BUS_IMMEDIATE) runBus();
+}
+
+// --- Scènes ---
+
+struct SceneBytes {
+  uint32_t bytes;
+  uint32_t transmissions;
+};
+
+static SceneBytes measure(const char* scene, void (*draw)()) {
+  uint32_t wire = wireBytes, count = transmissions, counted = displayBusStats.totalBytes;
+  draw();
+  LCD.endFrame();
+  displayBusFlush(); // Différé : le bus se vide ici
+  SceneBytes s = { wireBytes - wire, transmissions - count };
+  CHECK(s.bytes == displayBusStats.totalBytes - counted, "%s : %" PRIu32 " octets sur le bus, %" PRIu32 " comptes",
+        scene, s.bytes, displayBusStats.totalBytes - counted);
+  return s;
+}
+
+static void drawFullScreen() {
+  LCD.clear();
+  updateStaticDisplay();       // drawTimerScreen() du .ino
+  updateCentisecondsDisplay();
+  displayStatusLine3();
+}
+
+static void drawCentis() {
+  updateCentisecondsDisplay();
+}
+
+struct PaceResult {
+  SceneBytes full, centis, unchanged;
+};
+
+static PaceResult runScenes(BusPace busPace) {
+  PaceResult r;
+  pace = busPace;
+  hostSetMillis(0);
+  LCD.begin();
+  bigNum.begin();
+  LCD.endFrame();
+  displayBusFlush();
+
+  currentTimerState = STATE_IDLE;
+  targetTotalSeconds = 90;
+  modeState.timer.displayMIN = 1;
+  modeState.timer.displaySEC = 30;
+  modeState.timer.displayCS = 0;
+  r.full = measure("ecran complet", drawFullScreen);
+  CHECK(textAt(0, STATUS_ROW, "TIMER STOP | 01:30  "), "ligne de statut a l'ecran");
+  CHECK(textAt(CS_COL, CS_ROW, ".00 "), "centiemes a l'ecran");
+  CHECK(textAt(0, MELODY_NAME_ROW, "*Bip-Bip  |Manuel   "), "ligne d'infos a l'ecran");
+
+  static byte before[SCREEN_SIZE];
+  memcpy(before, screenBytes(), SCREEN_SIZE);
+  modeState.timer.displayCS = 42;
+  r.centis = measure("centiemes", drawCentis);
+  CHECK(textAt(CS_COL, CS_ROW, ".42 "), "nouveaux centiemes a l'ecran");
+  for (unsigned int i = 0; i < SCREEN_SIZE; i++) {
+    CHECK(screenBytes()[i] == before[i] || inCells(i, CS_COL, CS_COL + 3, CS_ROW),
+          "octet %u de l'ecran change hors des centiemes", i);
+  }
+
+  memcpy(before, screenBytes(), SCREEN_SIZE);
+  r.unchanged = measure("centiemes inchanges", drawCentis);
+  CHECK(memcmp(before, screenBytes(), SCREEN_SIZE) == 0, "ecran inchange");
+  CHECK(displayBusStats.errors == 0, "%u transmissions refusees", displayBusStats.errors);
+  return r;
+}
+
+static void printRow(const char* scene, SceneBytes immediate, SceneBytes deferred) {
+  printf("%-28s %8" PRIu32 " (%3" PRIu32 " tr.) %8" PRIu32 " (%3" PRIu32 " tr.)\n", scene,
+         immediate.bytes, immediate.transmissions, deferred.bytes, deferred.transmissions);
+}
+
+int main() {
+  hostTwiControlWritten = controlWritten;
+  hostBusWait = runBus;
+  PaceResult immediate = runScenes(BUS_IMMEDIATE);
+  PaceResult deferred = runScenes(BUS_DEFERRED);
+
+  printf("%s %dx%d : octets I2C par trame, adresses comprises (transmissions)\n",
+         DISPLAY_OLED ? "OLED SSD1306" : "LCD HD44780 + PCF8574", LCD_COLS, LCD_ROWS);
+  printf("%-28s %20s %20s\n", "", "bus immediat", "bus differe");
+  printRow("ecran du minuteur complet", immediate.full, deferred.full);
+  printRow("mise a jour des centiemes", immediate.centis, deferred.centis);
+  printRow("centiemes inchanges", immediate.unchanged, deferred.unchanged);
+
+  // Chiffres de référence (20x4) : un pilote qui envoie plus devra les justifier
+#if DISPLAY_OLED
+  const uint32_t expected[6] = { 1088, 44, 0, 1088, 44, 0 }; // L'octet de contrôle interdit la fusion
+#else
+  const uint32_t expected[6] = { 515, 25, 25, 415, 21, 21 };
+#endif
+  const uint32_t measured[6] = { immediate.full.bytes, immediate.centis.bytes, immediate.unchanged.bytes,
+                                 deferred.full.bytes, deferred.centis.bytes, deferred.unchanged.bytes };
+  for (byte i = 0; i < 6; i++) {
+    CHECK(LCD_PANEL != 2004 || measured[i] == expected[i], "scene %u : %" PRIu32 " octets au lieu de %" PRIu32,
+          i, measured[i], expected[i]);
+  }
+
+  printf("\n%s : OK\n", DISPLAY_OLED ? "test_ecran_oled" : LCD_PANEL == 4004 ? "test_ecran_lcd40" : "test_ecran_lcd");
+  return 0;
+}
@@ -0,0 +1,342 @@
+// test_timing.cpp - Précision du métronome et du minuteur sur l'horloge virtuelle (hote.h)
+//
+// timer.cpp et metronome.cpp tels quels ; le reste du sketch est remplacé par des doublures
+// (doublures.cpp, plus l'afficheur et le buzzer ici).
+// Chaque passe de loop() dure 0,1 à 2 ms, et des passes bloquées (mélodie, EEPROM, rendu) sont
+// injectées au hasard : le générateur a une graine fixe, les résultats sont reproductibles.
+//  - Métronome, chaque BPM de MIN_BPM à MAX_BPM pendant 10 minutes, départ juste avant le
+//    repassage par zéro de millis() : la grille des temps (lastBeatTime) est exactement à
+//    floor(n * 60000 / BPM) ms du départ, donc la dérive cumulée reste sous la milliseconde,
+//    et chaque temps est entendu au plus une passe après son échéance.
+//  - Passe bloquée plus d'un intervalle : un seul temps, grille recalée, pas de rafale.
+//  - Minuteur : fin du décompte à l'échéance (à une passe près), départ avant ou après le
+//    repassage par zéro ; pause et reprise gardent le reste exact à la milliseconde près.
+// Les colonnes "ancien" rejouent sur les mêmes passes les calculs d'avant la grille absolue
+// (intervalle tronqué, repartant du temps vu ; comparaison non signée du minuteur) : c'est ce
+// que la grille et la différence signée corrigent.
+#include "hote.h"
+#include "../timer.h"
+#include "../metronome.h"
+#include <inttypes.h>
+#include <stdio.h>
+
+// --- Doublures du reste du sketch ---
+
+LcdHd44780::LcdHd44780(byte address, byte cols, byte rows) : _address(address), _cols(cols), _rows(rows) {}
+void LcdHd44780::clear() {}
+void LcdHd44780::setCursor(byte, byte) {}
+void LcdHd44780::backlight() {}
+void LcdHd44780::noBacklight() {}
+void LcdHd44780::endFrame() {}
+size_t LcdHd44780::write(uint8_t) { return 1; }
+BigNumbers_I2C::BigNumbers_I2C(LcdHd44780* lcd) : _lcd(lcd) {}
+void BigNumbers_I2C::begin() {}
+void BigNumbers_I2C::clearLargeNumber(byte, byte) {}
+void BigNumbers_I2C::displayLargeNumber(byte, byte, byte) {}
+
+DisplayDevice LCD(LCD_ADDR, LCD_COLS, LCD_ROWS);
+BigNumberDevice bigNum(&LCD);
+
+// Chaque temps battu passe par playSound(SOUND_BEAT) : instant (µs virtuelles) et nombre
+static uint64_t beatHeardAt = 0;
+static uint32_t beatsHeard = 0;
+void playSound(SoundPriority priority, unsigned int, unsigned int) {
+  if (priority != SOUND_BEAT) return;
+  beatHeardAt = hostNowMicros();
+  beatsHeard++;
+}
+void clearRestOfLine(byte, byte) {}
+void displayStatusLine3() {}
+
+// --- Passes de loop() ---
+
+static uint32_t randomState = 12345;
+static uint32_t nextRandom() { // xorshift32 : même suite à chaque exécution
+  randomState ^= randomState << 13;
+  randomState ^= randomState >> 17;
+  randomState ^= randomState << 5;
+  return randomState;
+}
+
+const uint32_t PASS_MIN_US = 100;
+const uint32_t PASS_MAX_US = 2000;
+const uint32_t STALL_ONE_IN = 400;  // Une passe sur 400 en moyenne est bloquée
+const uint32_t STALL_MIN_US = 5000;
+
+// Avance l'horloge d'une passe, bloquée ou non ; rend sa durée (µs)
+static uint32_t runPass(uint32_t maxStallUs) {
+  uint32_t us = PASS_MIN_US + nextRandom() % (PASS_MAX_US - PASS_MIN_US + 1);
+  if (maxStallUs > STALL_MIN_US && nextRandom() % STALL_ONE_IN == 0) {
+    us += STALL_MIN_US + nextRandom() % (maxStallUs - STALL_MIN_US + 1);
+  }
+  hostAdvanceMicros(us);
+  return us;
+}
+
+// Échéance idéale du temps n (µs depuis le départ), exacte à la µs près
+static uint64_t idealBeatMicros(uint32_t beat, int bpm) {
+  return (uint64_t)beat * 60000000U / bpm;
+}
+
+// --- Métronome : chaque BPM ---
+
+struct BeatStats {
+  uint32_t beats;
+  int32_t maxGridDriftUs;  // |grille - échéance idéale|, la plus grande
+  int32_t finalDriftUs;    // Au dernier temps : dérive cumulée
+  int32_t maxLateUs;       // Temps entendu après son échéance idéale
+  int32_t minLateUs;       // Négatif : entendu avant (la grille est en ms entières)
+  uint32_t maxPassUs;      // Passe la plus longue (borne du retard)
+  unsigned int resyncs;
+  int32_t oldFinalDriftUs; // Ancien calcul, au même instant
+};
+
+const uint32_t METRO_RUN_MS = 10U * 60U * 1000U;
+
+static BeatStats runMetronome(int bpm) {
+  BeatStats s = { 0, 0, 0, 0, 0, 0, 0, 0 };
+  uint32_t intervalMs = 60000U / bpm;
+  uint32_t maxStallUs = intervalMs * 1000U * 8 / 10 - PASS_MAX_US; // Jamais deux temps dans une passe
+  if (maxStallUs > 200000U) maxStallUs = 200000U;
+
+  hostSetMillis(0xFFFFFFFFU - 120000U + bpm * 37U); // millis() repasse par zéro pendant l'essai
+  hostAdvanceMicros(nextRandom() % 1000);
+  currentBPM = bpm;
+  currentMetroState = METRO_STOPPED;
+  beatsHeard = 0;
+  startMetronome(true);
+  uint32_t startMs = modeState.metro.lastBeatTime;
+  uint64_t startUs = (hostNowMicros() / 1000U) * 1000U; // Origine de la grille : la ms du départ
+
+  // Ancien calcul : intervalle tronqué, repart de l'instant où le temps a été vu
+  uint32_t oldLastBeat = startMs;
+  uint32_t oldBeats = 0;
+
+  uint64_t endUs = hostNowMicros() + METRO_RUN_MS * 1000U;
+  while (hostNowMicros() < endUs) {
+    uint32_t passUs = runPass(maxStallUs);
+    if (passUs > s.maxPassUs) s.maxPassUs = passUs;
+    uint32_t heardBefore = beatsHeard;
+    handleMetronomeLogic();
+    if (millis() - oldLastBeat >= intervalMs) { oldLastBeat = millis(); oldBeats++; }
+    if (beatsHeard == heardBefore) continue;
+    CHECK(beatsHeard == heardBefore + 1, "BPM %d : deux temps dans une passe", bpm);
+    s.beats++;
+
+    int64_t ideal = (int64_t)idealBeatMicros(s.beats, bpm);
+    int64_t grid = (int64_t)(uint32_t)(modeState.metro.lastBeatTime - startMs) * 1000;
+    int32_t drift = (int32_t)(ideal - grid);
+    CHECK(drift >= 0 && drift < 1000, "BPM %d temps %" PRIu32 " : grille a %" PRId32 " us de l'echeance", bpm, s.beats, drift);
+    if (drift > s.maxGridDriftUs) s.maxGridDriftUs = drift;
+    s.finalDriftUs = drift;
+
+    int32_t late = (int32_t)((int64_t)(beatHeardAt - startUs) - ideal);
+    CHECK(late > -1000 && late <= (int32_t)passUs, "BPM %d temps %" PRIu32 " : entendu %" PRId32 " us apres l'echeance (passe %" PRIu32 " us)",
+          bpm, s.beats, late, passUs);
+    if (late > s.maxLateUs) s.maxLateUs = late;
+    if (late < s.minLateUs) s.minLateUs = late;
+  }
+  s.resyncs = metronomeTiming.resyncs;
+  CHECK(s.resyncs == 0, "BPM %d : %u recalages sans passe bloquee d'un intervalle", bpm, s.resyncs);
+  CHECK(s.beats == METRO_RUN_MS * bpm / 60000U || s.beats + 1 == METRO_RUN_MS * bpm / 60000U,
+        "BPM %d : %" PRIu32 " temps en 10 min", bpm, s.beats);
+  // Ancien calcul : où tombait son dernier temps, comparé à l'échéance du même numéro
+  s.oldFinalDriftUs = (int32_t)((int64_t)(uint32_t)(oldLastBeat - startMs) * 1000
+                             - (int64_t)idealBeatMicros(oldBeats, bpm));
+  CHECK(abs(s.oldFinalDriftUs) >= 1000, "BPM %d : l'ancien calcul ne derive pas (%" PRId32 " us)", bpm, s.oldFinalDriftUs);
+  stopMetronome();
+  return s;
+}
+
+// Une passe bloquée de plus d'un intervalle : un seul temps à la sortie, grille recalée dessus
+static void testMetronomeResync() {
+  const int bpm = 120;
+  hostSetMillis(1000);
+  currentBPM = bpm;
+  currentMetroState = METRO_STOPPED;
+  beatsHeard = 0;
+  startMetronome(true);
+  for (int i = 0; i < 5000; i++) { runPass(0); handleMetronomeLogic(); }
+  uint32_t before = beatsHeard;
+  hostAdvanceMillis(1700); // Mélodie bloquante : plus de trois intervalles
+  handleMetronomeLogic();
+  CHECK(beatsHeard == before + 1, "un seul temps apres la passe bloquee (%" PRIu32 ")", beatsHeard - before);
+  CHECK(metronomeTiming.resyncs == 1, "un recalage (%u)", metronomeTiming.resyncs);
+  uint32_t anchor = modeState.metro.lastBeatTime;
+  CHECK(anchor == millis(), "grille recalee sur la sortie de la passe");
+  handleMetronomeLogic();
+  CHECK(beatsHeard == before + 1, "pas de rafale de rattrapage");
+  uint32_t k = 0;
+  uint64_t anchorUs = (uint64_t)anchor * 1000U;
+  for (int i = 0; i < 20000; i++) {
+    uint32_t heard = beatsHeard;
+    uint32_t passUs = runPass(0);
+    handleMetronomeLogic();
+    if (beatsHeard == heard) continue;
+    k++;
+    CHECK(modeState.metro.lastBeatTime - anchor == k * 60000U / bpm, "grille apres recalage, temps %" PRIu32, k);
+    int32_t late = (int32_t)(beatHeardAt - anchorUs - idealBeatMicros(k, bpm));
+    CHECK(late > -1000 && late <= (int32_t)passUs, "retard apres recalage %" PRId32 " us", late);
+  }
+  stopMetronome();
+  printf("Recalage : passe de 1700 ms a 120 BPM -> 1 temps, 1 recalage, %" PRIu32 " temps ensuite sur la nouvelle grille\n", k);
+}
+
+// --- Minuteur ---
+
+struct CountdownStats {
+  int32_t endErrorUs;    // Fin vue - échéance (depuis l'appui, µs)
+  uint32_t passUs;       // Passe qui a vu la fin
+  int64_t oldEndErrorUs; // Ancienne comparaison non signée, mêmes passes (dépasse 2^31 µs)
+};
+
+static void startCountdown(unsigned int seconds) {
+  currentTimerState = STATE_IDLE;
+  targetTotalSeconds = seconds;
+  modeState.timer.blinkDone = true;
+  handleTimerButtonShortPress();
+  CHECK(currentTimerState == STATE_RUNNING, "decompte demarre");
+}
+
+// Passes jusqu'à la fin du décompte ; rend l'instant (µs virtuelles) de la passe qui la voit
+static uint64_t runUntilEnd(uint32_t maxStallUs, uint32_t& lastPassUs,
+                            uint64_t& oldEndUs) {
+  oldEndUs = 0;
+  while (currentTimerState == STATE_RUNNING) {
+    lastPassUs = runPass(maxStallUs);
+    // Ancienne comparaison : reste nul dès que targetEndTime <= millis() en non signé
+    if (oldEndUs == 0 && !(modeState.timer.targetEndTime > millis())) {
+      oldEndUs = hostNowMicros();
+    }
+    loopTimer();
+  }
+  if (oldEndUs == 0) oldEndUs = hostNowMicros();
+  return hostNowMicros();
+}
+
+static CountdownStats runCountdown(unsigned int seconds, uint32_t startMs) {
+  CountdownStats s;
+  hostSetMillis(startMs);
+  hostAdvanceMicros(nextRandom() % 1000);
+  uint64_t pressUs = hostNowMicros();
+  hostSerialClear();
+  startCountdown(seconds);
+  uint64_t oldEndUs;
+  uint64_t endUs = runUntilEnd(50000U, s.passUs, oldEndUs);
+  s.endErrorUs = (int32_t)(endUs - pressUs) - (int32_t)seconds * 1000000;
+  s.oldEndErrorUs = (int64_t)(oldEndUs - pressUs) - (int64_t)seconds * 1000000;
+  CHECK(s.endErrorUs > -1000 && s.endErrorUs <= (int32_t)s.passUs,
+        "%u s depuis %" PRIu32 " ms : fin a %" PRId32 " us de l'echeance (passe %" PRIu32 " us)", seconds, startMs, s.endErrorUs, s.passUs);
+  CHECK(strstr(hostSerialText(), "Minuteur fin retard=") != nullptr, "retard de fin envoye sur le port serie");
+  if (startMs > (uint32_t)(startMs + seconds * 1000)) { // Échéance après le repassage par zéro
+    CHECK(s.oldEndErrorUs < -(int64_t)seconds * 1000000 + 100000, "%u s : l'ancienne comparaison finit tout de suite", seconds);
+  }
+  return s;
+}
+
+struct PauseStats {
+  int32_t endErrorUs;          // Fin vue - (échéance + durée des pauses)
+  uint32_t passUs;
+  int32_t maxRemainderErrorUs; // Reste gardé à l'appui - reste réel
+};
+
+// Décompte coupé de pauses (dont une à cheval sur le repassage par zéro de millis())
+static PauseStats runPauses(unsigned int seconds, uint32_t startMs, byte pauses) {
+  PauseStats s = { 0, 0, 0 };
+  hostSetMillis(startMs);
+  hostAdvanceMicros(nextRandom() % 1000);
+  uint64_t pressUs = hostNowMicros();
+  startCountdown(seconds);
+  uint64_t pausedUs = 0;
+  for (byte p = 0; p < pauses; p++) {
+    uint64_t runFor = (uint64_t)seconds * 1000000 / (pauses + 2);
+    uint64_t until = hostNowMicros() + runFor;
+    while (hostNowMicros() < until) { runPass(50000U); loopTimer(); }
+    CHECK(currentTimerState == STATE_RUNNING, "pas de fin avant la pause %u", p);
+    int64_t realLeft = (int64_t)(pressUs + (uint64_t)seconds * 1000000 + pausedUs) - (int64_t)hostNowMicros();
+    handleTimerButtonShortPress(); // Pause
+    CHECK(currentTimerState == STATE_PAUSED, "pause %u", p);
+    int32_t remainderError = (int32_t)((int64_t)modeState.timer.pausedRemainingMillis * 1000 - realLeft);
+    if (remainderError < 0) remainderError = -remainderError;
+    CHECK(remainderError < 1000 * (p + 1), "pause %u : reste garde a %" PRId32 " us du reste reel", p, remainderError);
+    if (remainderError > s.maxRemainderErrorUs) s.maxRemainderErrorUs = remainderError;
+    uint64_t pauseStart = hostNowMicros();
+    uint64_t pauseEnd = pauseStart + 3000000U + nextRandom() % 4000000U;
+    while (hostNowMicros() < pauseEnd) { runPass(50000U); loopTimer(); }
+    CHECK(currentTimerState == STATE_PAUSED, "toujours en pause");
+    handleTimerButtonShortPress(); // Reprise
+    pausedUs += hostNowMicros() - pauseStart;
+  }
+  uint64_t oldEndUs;
+  uint64_t endUs = runUntilEnd(50000U, s.passUs, oldEndUs);
+  s.endErrorUs = (int32_t)((int64_t)(endUs - pressUs - pausedUs) - (int64_t)seconds * 1000000);
+  CHECK(s.endErrorUs > -1000 * (pauses + 1) && s.endErrorUs <= (int32_t)s.passUs + 1000 * pauses,
+        "%u pauses : fin a %" PRId32 " us de l'echeance (passe %" PRIu32 " us)", pauses, s.endErrorUs, s.passUs);
+  return s;
+}
+
+// --- Rapport ---
+
+int main() {
+  printf("Metronome : %d a %d BPM, %" PRIu32 " min chacun, passes %" PRIu32 "-%" PRIu32 " us, 1 passe sur %u bloquee 5 ms a 0,8 intervalle\n",
+         MIN_BPM, MAX_BPM, METRO_RUN_MS / 60000U, PASS_MIN_US, PASS_MAX_US, (unsigned)STALL_ONE_IN);
+  printf("%-9s %7s %13s %13s %13s %13s %9s %15s\n", "BPM", "temps", "derive max", "derive fin",
+         "retard max", "avance max", "recal.", "ancien: derive");
+  BeatStats worst = { 0, 0, 0, 0, 0, 0, 0, 0 };
+  int worstDriftBpm = 0, worstLateBpm = 0;
+  for (int band = MIN_BPM; band <= MAX_BPM; band += 20) {
+    BeatStats row = { 0, 0, 0, 0, 0, 0, 0, 0 };
+    int last = band + 19 < MAX_BPM ? band + 19 : MAX_BPM;
+    for (int bpm = band; bpm <= last; bpm++) {
+      BeatStats s = runMetronome(bpm);
+      row.beats += s.beats;
+      if (s.maxGridDriftUs > row.maxGridDriftUs) row.maxGridDriftUs = s.maxGridDriftUs;
+      if (s.finalDriftUs > row.finalDriftUs) row.finalDriftUs = s.finalDriftUs;
+      if (s.maxLateUs > row.maxLateUs) row.maxLateUs = s.maxLateUs;
+      if (s.minLateUs < row.minLateUs) row.minLateUs = s.minLateUs;
+      row.resyncs += s.resyncs;
+      if (abs(s.oldFinalDriftUs) > abs(row.oldFinalDriftUs)) row.oldFinalDriftUs = s.oldFinalDriftUs;
+      if (s.maxGridDriftUs > worst.maxGridDriftUs) { worst.maxGridDriftUs = s.maxGridDriftUs; worstDriftBpm = bpm; }
+      if (s.maxLateUs > worst.maxLateUs) { worst.maxLateUs = s.maxLateUs; worstLateBpm = bpm; }
+      if (abs(s.oldFinalDriftUs) > abs(worst.oldFinalDriftUs)) worst.oldFinalDriftUs = s.oldFinalDriftUs;
+    }
+    char label[10];
+    snprintf(label, sizeof(label), "%d-%d", band, last);
+    printf("%-9s %7" PRIu32 " %10" PRId32 " us %10" PRId32 " us %10" PRId32 " us %10" PRId32 " us %9u %12.1f ms\n", label, row.beats, row.maxGridDriftUs,
+           row.finalDriftUs, row.maxLateUs, -row.minLateUs, row.resyncs, row.oldFinalDriftUs / 1000.0);
+  }
+  printf("Pire cas : derive de grille %" PRId32 " us (%d BPM), retard %" PRId32 " us (%d BPM, passe bloquee comprise) ; "
+         "ancien calcul : %.1f ms de derive en 10 min\n",
+         worst.maxGridDriftUs, worstDriftBpm, worst.maxLateUs, worstLateBpm, worst.oldFinalDriftUs / 1000.0);
+  testMetronomeResync();
+
+  printf("\nMinuteur : fin du decompte (passes %" PRIu32 "-%" PRIu32 " us, passes bloquees jusqu'a 50 ms)\n", PASS_MIN_US, PASS_MAX_US);
+  printf("%-8s %-22s %14s %14s %18s\n", "duree", "depart millis()", "erreur fin", "passe", "ancien: erreur");
+  const unsigned int durations[] = { 1, 7, 59, 61, 600, 5999 };
+  int32_t worstEnd = 0;
+  for (unsigned int seconds : durations) {
+    const uint32_t starts[] = { 0U, 0xFFFFFFFFU - seconds * 500U }; // Le second repasse par zéro à mi-course
+    for (uint32_t startMs : starts) {
+      CountdownStats s = runCountdown(seconds, startMs);
+      if (abs(s.endErrorUs) > abs(worstEnd)) worstEnd = s.endErrorUs;
+      printf("%5u s  %-22" PRIu32 " %11" PRId32 " us %11" PRIu32 " us %15.1f s\n", seconds, startMs, s.endErrorUs, s.passUs,
+             s.oldEndErrorUs / 1000000.0);
+    }
+  }
+  printf("Pire cas : fin a %" PRId32 " us de l'echeance\n", worstEnd);
+
+  printf("\nMinuteur : pause / reprise (pauses de 3 a 7 s)\n");
+  printf("%-8s %-8s %-22s %14s %16s\n", "duree", "pauses", "depart millis()", "erreur fin", "erreur du reste");
+  int32_t worstPause = 0;
+  for (byte pauses = 1; pauses <= 5; pauses += 2) {
+    const uint32_t starts[] = { 5000U, 0xFFFFFFFFU - 20000U };
+    for (uint32_t startMs : starts) {
+      PauseStats s = runPauses(60, startMs, pauses);
+      if (abs(s.endErrorUs) > abs(worstPause)) worstPause = s.endErrorUs;
+      printf("%5u s  %-8u %-22" PRIu32 " %11" PRId32 " us %13" PRId32 " us\n", 60u, pauses, startMs, s.endErrorUs, s.maxRemainderErrorUs);
+    }
+  }
+  printf("Pire cas : fin a %" PRId32 " us de l'echeance apres pauses\n", worstPause);
+  printf("\ntest_timing : OK\n");
+  return 0;
+}
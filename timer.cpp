@@ -1,95 +1,121 @@
 #include "timer.h"
+#include "rapport.h"
 
 void setupTimer() {
   // Cette fonction est appelée depuis setup() dans le .ino principal.
-  // Charger les préférences EEPROM pour le timer (preset, temps manuel)
-  byte savedPreset = EEPROM.read(EEPROM_ADDR_PRESET);
-  if (savedPreset >= NUM_PRESETS) { 
-    currentPresetChoice = 0; 
-    EEPROM.update(EEPROM_ADDR_PRESET, currentPresetChoice); 
-  } else { 
-    currentPresetChoice = savedPreset; 
-  }
-  // menuPresetIndex = currentPresetChoice; // menuPresetIndex est pour le menu, pas ici
-
+  // Le choix courant (Manuel ou preset) est chargé et validé par setupPresets(), appelée avant
   if (currentPresetChoice == 0) { // Mode Manuel
-     EEPROM.get(EEPROM_ADDR_MANUAL_TIME, targetTotalSeconds);
-     if (targetTotalSeconds > MAX_TOTAL_SECONDS) { 
-        targetTotalSeconds = 0;
-        EEPROM.put(EEPROM_ADDR_MANUAL_TIME, targetTotalSeconds);
+     if (settings.manualSeconds > MAX_TOTAL_SECONDS) { 
+        settings.manualSeconds = 0;
      }
+     targetTotalSeconds = settings.manualSeconds;
   } else { // Mode Preset
-     if (currentPresetChoice < NUM_PRESETS) { 
-        targetTotalSeconds = PRESET_VALUES[currentPresetChoice];
-     } else { 
-        targetTotalSeconds = 0;
-        currentPresetChoice = 0; 
-        EEPROM.update(EEPROM_ADDR_PRESET, currentPresetChoice);
-     }
+     targetTotalSeconds = presetTargetSeconds();
   }
-  lastPos = targetTotalSeconds / SECOND_INCREMENT;
-  // encoder.setPosition(lastPos * STEPS); // L'encodeur est initialisé dans le setup principal
+  modeState.timer.lastPos = targetTotalSeconds / SECOND_INCREMENT;
 
   // Initialiser les variables d'affichage du timer
-  displayMIN = targetTotalSeconds / 60;
-  displaySEC = targetTotalSeconds % 60;
-  displayCS = 0;
-  lastDisplayedMIN = -1; 
-  lastDisplayedSEC = -1;
+  modeState.timer.displayMIN = targetTotalSeconds / 60;
+  modeState.timer.displaySEC = targetTotalSeconds % 60;
+  modeState.timer.displayCS = 0;
+  modeState.timer.lastDisplayedMIN = -1; 
+  modeState.timer.lastDisplayedSEC = -1;
 
-  // currentTimerState = STATE_IDLE; // Est déjà initialisé dans le .ino
+  // Décompte interrompu par une coupure ou un reset : le proposer en pause
+  checkpointBegin();
+  unsigned int resumeSeconds, resumeTarget;
+  if (checkpointRestore(resumeSeconds, resumeTarget)) {
+    targetTotalSeconds = resumeTarget;
+    modeState.timer.pausedRemainingMillis = (unsigned long)resumeSeconds * 1000UL;
+    modeState.timer.remainingMillis = modeState.timer.pausedRemainingMillis;
+    modeState.timer.displayMIN = resumeSeconds / 60;
+    modeState.timer.displaySEC = resumeSeconds % 60;
+    resetProgress(progressForRemaining(modeState.timer.pausedRemainingMillis, (unsigned long)resumeTarget * 1000UL));
+    currentTimerState = STATE_PAUSED;
+    modeState.timer.timerResumePending = true;
+    modeState.timer.blinkDone = false;
+  } else {
+    currentTimerState = STATE_IDLE;
+  }
 }
 
 
+// Entrée dans MODE_TIMER (sortie des menus, réveil) : temps cible rechargé, écran complet
+void enterTimerMode() {
+  resetActivityTimer();
+  bigNum.begin(); // Les menus ont remplacé deux caractères personnalisés par les flèches
+  if (currentTimerState == STATE_IDLE) {
+    targetTotalSeconds = presetTargetSeconds(); // Preset (cache RAM) ou temps manuel sauvegardé
+    modeState.timer.displayMIN = targetTotalSeconds / 60;
+    modeState.timer.displaySEC = targetTotalSeconds % 60;
+    modeState.timer.displayCS = 0; 
+    modeState.timer.lastPos = targetTotalSeconds / SECOND_INCREMENT;
+  }
+  modeState.timer.lastDisplayedMIN = -1; 
+  modeState.timer.lastDisplayedSEC = -1;
+  LCD.clear();
+  updateStaticDisplay();
+  updateCentisecondsDisplay();
+  displayStatusLine3();
+}
+
+// Sortie de MODE_TIMER (menu pendant le clignotement de fin) : l'état du mode va être effacé
+void exitTimerMode() {
+  if (modeState.timer.isEndSequenceBlinking) LCD.backlight();
+}
+
+void tickTimerMode() {
+  loopTimer();
+  if (serviceLowPowerRun()) { ignoreWakeInput(); } // Long décompte sans action : écran éteint, MCU en veille
+  if (currentTimerState == STATE_IDLE && !modeState.timer.isEndSequenceBlinking) { checkIdleSleep(); }
+}
+
 void loopTimer() {
-  // Cette fonction est appelée depuis loop() dans le .ino principal lorsque currentMode == MODE_TIMER
+  // Cette fonction est appelée par tickTimerMode() (MODE_TIMER)
 
   if (currentTimerState == STATE_RUNNING) {
     unsigned long currentTime = millis();
-    // Gérer le cas où targetEndTime pourrait ne pas être encore initialisé correctement
-    // ou si millis() a fait un rollover et est plus petit que targetEndTime après un long uptime.
-    // Pour la robustesse, on vérifie si targetEndTime est supérieur à currentTime avant soustraction.
-    if (targetEndTime >= currentTime) {
-        remainingMillis = targetEndTime - currentTime;
-    } else {
-        remainingMillis = 0; // Le temps est écoulé ou erreur de synchronisation
-    }
+    // Différence signée : juste aussi quand millis() repasse par zéro (après 49 jours)
+    long left = (long)(modeState.timer.targetEndTime - currentTime);
+    modeState.timer.remainingMillis = left > 0 ? left : 0;
 
-    if (remainingMillis <= 0) { 
-        remainingMillis = 0; // Assurer qu'il n'est pas négatif
+    if (modeState.timer.remainingMillis <= 0) { 
+        Report.print(F("Minuteur fin retard=")); Report.print(-left); Report.println(F(" ms")); // Latence de la passe qui voit l'échéance
         timerEnd();          // Gérer la fin du timer
     } else {
-      unsigned long totalRemainingSeconds = (remainingMillis + 999) / 1000; // Arrondi supérieur
+      unsigned long totalRemainingSeconds = (modeState.timer.remainingMillis + 999) / 1000; // Arrondi supérieur
       int currentMIN_disp = totalRemainingSeconds / 60;
       int currentSEC_disp = totalRemainingSeconds % 60;
 
-      if (currentMIN_disp != displayMIN || currentSEC_disp != displaySEC) {
-          displayMIN = currentMIN_disp;
-          displaySEC = currentSEC_disp;
-           if (displayMIN != lastDisplayedMIN || displaySEC != lastDisplayedSEC) {
-               updateStaticDisplay(); 
-               lastDisplayedMIN = displayMIN;
-               lastDisplayedSEC = displaySEC;
+      if (currentMIN_disp != modeState.timer.displayMIN || currentSEC_disp != modeState.timer.displaySEC) {
+          modeState.timer.displayMIN = currentMIN_disp;
+          modeState.timer.displaySEC = currentSEC_disp;
+           if (modeState.timer.displayMIN != modeState.timer.lastDisplayedMIN || modeState.timer.displaySEC != modeState.timer.lastDisplayedSEC) {
+               requestDisplay(DISP_PRIO_SECONDS, updateStaticDisplay); 
+               modeState.timer.lastDisplayedMIN = modeState.timer.displayMIN;
+               modeState.timer.lastDisplayedSEC = modeState.timer.displaySEC;
            }
       }
-      displayCS = (remainingMillis % 1000) / 10;
-      if (currentTime - lastCsUpdateTime >= csUpdateInterval) {
-          lastCsUpdateTime = currentTime;
-          updateCentisecondsDisplay();
+      modeState.timer.displayCS = (modeState.timer.remainingMillis % 1000) / 10;
+      setProgress(progressForRemaining(modeState.timer.remainingMillis, (unsigned long)targetTotalSeconds * 1000UL));
+      serviceCheckpoint(modeState.timer.remainingMillis);
+      if (currentTime - modeState.timer.lastCsUpdateTime >= csUpdateInterval) {
+          modeState.timer.lastCsUpdateTime = currentTime;
+          requestDisplay(DISP_PRIO_CENTIS, updateCentisecondsDisplay);
       }
     }
   } 
-  else if (isEndSequenceBlinking) { 
+  else if (modeState.timer.isEndSequenceBlinking) { 
     unsigned long currentTime = millis();
-    if (currentTime - blinkSequenceStartTime >= blinkSequenceDuration) {
-      isEndSequenceBlinking = false;
+    if (currentTime - modeState.timer.blinkSequenceStartTime >= blinkSequenceDuration) {
+      modeState.timer.isEndSequenceBlinking = false;
       LCD.backlight();
       resetActivityTimer(); 
     } else {
-      if (currentTime - lastEndBlinkToggleTime >= endBlinkInterval) {
-        lastEndBlinkToggleTime = currentTime;
-        endBlinkStateIsOn = !endBlinkStateIsOn;
-        if (endBlinkStateIsOn) { LCD.backlight(); }
+      if (currentTime - modeState.timer.lastEndBlinkToggleTime >= endBlinkInterval) {
+        modeState.timer.lastEndBlinkToggleTime = currentTime;
+        modeState.timer.endBlinkStateIsOn = !modeState.timer.endBlinkStateIsOn;
+        if (modeState.timer.endBlinkStateIsOn) { LCD.backlight(); }
         else { LCD.noBacklight(); }
       }
     }
@@ -100,68 +126,73 @@ void loopTimer() {
 
 void timerEnd() {
   currentTimerState = STATE_IDLE;
-  displayMIN = 0; displaySEC = 0; displayCS = 0;
+  checkpointClear();
+  lowPowerRunEnd();
+  modeState.timer.displayMIN = 0; modeState.timer.displaySEC = 0; modeState.timer.displayCS = 0;
   updateStaticDisplay(); 
   updateCentisecondsDisplay(); 
+  requestDisplay(DISP_PRIO_STATUS, displayStatusLine3); // La ligne d'infos remplace la barre de progression
 
-  lastDisplayedMIN = -1; 
-  lastDisplayedSEC = -1;
-  digitalWrite(RELAY_PIN, HIGH); 
+  modeState.timer.lastDisplayedMIN = -1; 
+  modeState.timer.lastDisplayedSEC = -1;
+  // Les sorties s'éteignent d'elles-mêmes au repère de fin (calendrier de sorties.h)
 
-  if (currentPresetChoice == 0) { 
-      EEPROM.get(EEPROM_ADDR_MANUAL_TIME, targetTotalSeconds);
-      if (targetTotalSeconds > MAX_TOTAL_SECONDS) targetTotalSeconds = 0;
-  } else { 
-      if (currentPresetChoice < NUM_PRESETS) targetTotalSeconds = PRESET_VALUES[currentPresetChoice];
-      else targetTotalSeconds = 0; 
-  }
-  lastPos = targetTotalSeconds / SECOND_INCREMENT;
-  encoder.setPosition(lastPos * STEPS); 
+  targetTotalSeconds = presetTargetSeconds();
+  modeState.timer.lastPos = targetTotalSeconds / SECOND_INCREMENT;
 
-  if (timerMelodyEnabled) { 
-    byte melodyIdx = currentMelodyChoice;
-    if (melodyIdx < NUM_MELODIES) { // Sécurité
-        if (melodyIdx == 0) { playMarioMelody(); }
-        else if (melodyIdx == 1) { playImperialMarch(); }
-        else if (melodyIdx == 2) { playZeldaTheme(); }
-        else if (melodyIdx == 3) { playNokiaTune(); }
-        else if (melodyIdx == 4) { playTetrisTheme(); } 
-        else if (melodyIdx == 5) { playBipBipMelody(); }
-    }
+  if (appFlags.timerMelodyEnabled) { 
+    LCD.endFrame(); // La mélodie bloque la boucle : l'écran de fin part avant
+    playMelody(currentMelodyChoice); // Vérifie lui-même l'index
   } 
 
-  if (!blinkDone) { 
-      isEndSequenceBlinking = true;
-      blinkSequenceStartTime = millis();
-      lastEndBlinkToggleTime = millis();
-      endBlinkStateIsOn = false; 
+  if (!modeState.timer.blinkDone) { 
+      modeState.timer.isEndSequenceBlinking = true;
+      modeState.timer.blinkSequenceStartTime = millis();
+      modeState.timer.lastEndBlinkToggleTime = millis();
+      modeState.timer.endBlinkStateIsOn = false; 
       LCD.noBacklight();
   }
-  blinkDone = true; 
+  modeState.timer.blinkDone = true; 
 }
 
 void updateStaticDisplay() { 
+  // Ligne de statut : texte complet sur 4 lignes, abrégé (3 caractères) sur 16x2
   LCD.setCursor(STATUS_COL_START, STATUS_ROW);
+  byte statusLen;
     if (currentTimerState == STATE_RUNNING) {
-        LCD.print(F("TIMER START         "));
-        clearRestOfLine(strlen("TIMER START         "), STATUS_ROW);
+        statusLen = LCD.print(LCD_TALL ? F("TIMER START") : F("RUN"));
+    } else if (currentTimerState == STATE_PAUSED && modeState.timer.timerResumePending) {
+        statusLen = LCD.print(LCD_TALL ? F("REPRISE? Appui=Go") : F("GO?"));
     } else if (currentTimerState == STATE_PAUSED) {
-        LCD.print(F("PAUSE               "));
-        clearRestOfLine(strlen("PAUSE               "), STATUS_ROW);
+        statusLen = LCD.print(LCD_TALL ? F("PAUSE") : F("PAU"));
+    }
+    else if (!LCD_TALL) { // STATE_IDLE, 16x2 : le temps cible est déjà en grands chiffres
+        statusLen = LCD.print(F("STP"));
     }
     else { // STATE_IDLE
         LCD.print(F("TIMER STOP | "));
         int targetMIN_disp = targetTotalSeconds / 60;
         int targetSEC_disp = targetTotalSeconds % 60;
-        if (targetMIN_disp < 10) LCD.print("0"); LCD.print(targetMIN_disp);
+        if (targetMIN_disp < 10) LCD.print("0");
+        LCD.print(targetMIN_disp);
         LCD.print(":");
-        if (targetSEC_disp < 10) LCD.print("0"); LCD.print(targetSEC_disp);
-        LCD.print(" "); 
-        clearRestOfLine(strlen("TIMER STOP | MM:SS "), STATUS_ROW);
+        if (targetSEC_disp < 10) LCD.print("0");
+        LCD.print(targetSEC_disp);
+        statusLen = textLen("TIMER STOP | MM:SS");
     }
+    clearRestOfLine(STATUS_COL_START + statusLen, STATUS_ROW);
+
+    drawBigClock(modeState.timer.displayMIN, modeState.timer.displaySEC);
+}
 
-    byte minTens = displayMIN / 10; byte minUnits = displayMIN % 10;
-    byte secTens = displaySEC / 10; byte secUnits = displaySEC % 10;
+void updateCentisecondsDisplay() {
+  drawCentiseconds(modeState.timer.displayCS);
+}
+
+// Grands chiffres MM.SS et ".CS" : partagés par le minuteur et le chronomètre
+void drawBigClock(int minutes, int seconds) {
+    byte minTens = minutes / 10; byte minUnits = minutes % 10;
+    byte secTens = seconds / 10; byte secUnits = seconds % 10;
     bigNum.displayLargeNumber(minTens, BIG_M1_COL, BIG_NUM_ROW);
     bigNum.displayLargeNumber(minUnits, BIG_M2_COL, BIG_NUM_ROW);
     LCD.setCursor(COLON_COL, BIG_NUM_ROW); LCD.print(" "); 
@@ -170,126 +201,131 @@ void updateStaticDisplay() {
     bigNum.displayLargeNumber(secUnits, BIG_S2_COL, BIG_NUM_ROW);
 }
 
-void updateCentisecondsDisplay() {
+void drawCentiseconds(int centis) {
   LCD.setCursor(CS_COL, CS_ROW); LCD.print(".");
-  if (displayCS < 10) { LCD.print("0"); } 
-  LCD.print(displayCS);
+  if (centis < 10) { LCD.print("0"); } 
+  LCD.print(centis);
   LCD.print(" "); 
 }
 
-void handleTimerEncoderInput(int physicalEncoderPos) {
-  // Cette fonction est appelée par handleEncoder() dans le .ino quand currentMode == MODE_TIMER
+void handleTimerEncoderInput(int delta) {
+  // Crans de l'encodeur (relatifs) en MODE_TIMER : réglage du temps cible à l'arrêt
   if (currentTimerState == STATE_IDLE) {
-     newPos = physicalEncoderPos; 
-
-     if (newPos < POSMIN) {
-         encoder.setPosition(POSMIN); 
-         newPos = POSMIN;
-     } else if (newPos > POSMAX) {
-         encoder.setPosition(POSMAX); 
-         newPos = POSMAX;
-     }
+     modeState.timer.newPos = constrain(modeState.timer.lastPos + delta, POSMIN, POSMAX);
     
-     if (lastPos != newPos) { 
+     if (modeState.timer.lastPos != modeState.timer.newPos) { 
        playClickSound();
        resetActivityTimer();
        if (currentPresetChoice != 0) {
-           currentPresetChoice = 0; 
-           saveChoiceToEEPROM(EEPROM_ADDR_PRESET, currentPresetChoice);
-           displayStatusLine3(); 
+           selectPreset(0); // Réglage à l'encodeur : retour en Manuel
+           requestDisplay(DISP_PRIO_STATUS, displayStatusLine3); 
        }
-       targetTotalSeconds = newPos * SECOND_INCREMENT; 
-       lastPos = newPos; 
+       targetTotalSeconds = modeState.timer.newPos * SECOND_INCREMENT; 
+       modeState.timer.lastPos = modeState.timer.newPos; 
       
-       displayMIN = targetTotalSeconds / 60;
-       displaySEC = targetTotalSeconds % 60;
-       displayCS = 0;
-       updateStaticDisplay();
-       updateCentisecondsDisplay();
-       lastDisplayedMIN = displayMIN; 
-       lastDisplayedSEC = displaySEC;
+       modeState.timer.displayMIN = targetTotalSeconds / 60;
+       modeState.timer.displaySEC = targetTotalSeconds % 60;
+       modeState.timer.displayCS = 0;
+       requestDisplay(DISP_PRIO_SECONDS, updateStaticDisplay);
+       requestDisplay(DISP_PRIO_CENTIS, updateCentisecondsDisplay);
+       modeState.timer.lastDisplayedMIN = modeState.timer.displayMIN; 
+       modeState.timer.lastDisplayedSEC = modeState.timer.displaySEC;
      }
   }
 }
 
+void handleTimerButton(ButtonEvent event) {
+  if (event == BTN_LONG_PRESS) {
+    if (currentTimerState == STATE_IDLE) {
+      setMode(MODE_MENU_MAIN);
+    } else { // STATE_PAUSED (RUNNING ne fait rien sur appui long)
+      handleTimerButtonLongPress();
+    }
+  } else if (isClickEvent(event)) {
+    handleTimerButtonShortPress();
+  }
+}
+
 void handleTimerButtonShortPress() {
-  // Cette fonction est appelée par handleButton() dans le .ino
-  // pour un appui court quand currentMode == MODE_TIMER
+  // Appui court (ou double-clic) en MODE_TIMER : départ / pause / reprise
   if (currentTimerState == STATE_RUNNING) { 
       currentTimerState = STATE_PAUSED;
-      pausedRemainingMillis = remainingMillis;
-      digitalWrite(RELAY_PIN, HIGH); 
-      noTone(BUZZER_PIN); 
-      updateStaticDisplay(); 
+      long left = (long)(modeState.timer.targetEndTime - millis()); // Reste à l'appui, pas à la dernière passe
+      modeState.timer.pausedRemainingMillis = left > 0 ? left : 0;
+      outputsPause();
+      buzzerSilence(SOUND_ALARM);
+      checkpointSave(STATE_PAUSED, modeState.timer.pausedRemainingMillis);
+      requestDisplay(DISP_PRIO_SECONDS, updateStaticDisplay); 
   } else if (currentTimerState == STATE_PAUSED) { 
       currentTimerState = STATE_RUNNING;
-      targetEndTime = millis() + pausedRemainingMillis; 
-      digitalWrite(RELAY_PIN, LOW); 
-      updateStaticDisplay(); 
-      lastCsUpdateTime = millis(); 
-      remainingMillis = pausedRemainingMillis; 
-      unsigned long totalRemainingSeconds = (remainingMillis + 999) / 1000;
-      displayMIN = totalRemainingSeconds / 60;
-      displaySEC = totalRemainingSeconds % 60;
-      displayCS = (remainingMillis % 1000) / 10; // Recalculer displayCS
-      updateCentisecondsDisplay(); // Afficher CS
-      lastDisplayedMIN = displayMIN; 
-      lastDisplayedSEC = displaySEC;
+      if (modeState.timer.timerResumePending) lowPowerRunBegin(); // Décompte restauré : mesuré à partir de la reprise
+      modeState.timer.timerResumePending = false;
+      checkpointSave(STATE_RUNNING, modeState.timer.pausedRemainingMillis);
+      modeState.timer.targetEndTime = millis() + modeState.timer.pausedRemainingMillis; 
+      outputsRunStart((unsigned long)targetTotalSeconds * 1000UL, modeState.timer.pausedRemainingMillis);
+      requestDisplay(DISP_PRIO_SECONDS, updateStaticDisplay); 
+      modeState.timer.lastCsUpdateTime = millis(); 
+      modeState.timer.remainingMillis = modeState.timer.pausedRemainingMillis; 
+      unsigned long totalRemainingSeconds = (modeState.timer.remainingMillis + 999) / 1000;
+      modeState.timer.displayMIN = totalRemainingSeconds / 60;
+      modeState.timer.displaySEC = totalRemainingSeconds % 60;
+      modeState.timer.displayCS = (modeState.timer.remainingMillis % 1000) / 10; // Recalculer displayCS
+      requestDisplay(DISP_PRIO_CENTIS, updateCentisecondsDisplay); // Afficher CS
+      modeState.timer.lastDisplayedMIN = modeState.timer.displayMIN; 
+      modeState.timer.lastDisplayedSEC = modeState.timer.displaySEC;
   } else if (currentTimerState == STATE_IDLE) { 
       if (targetTotalSeconds > 0) { 
-          targetEndTime = millis() + (unsigned long)targetTotalSeconds * 1000UL;
-          remainingMillis = targetEndTime - millis(); 
-          if(remainingMillis < 0) remainingMillis = 0; 
+          modeState.timer.targetEndTime = millis() + (unsigned long)targetTotalSeconds * 1000UL;
+          modeState.timer.remainingMillis = modeState.timer.targetEndTime - millis(); 
+          if(modeState.timer.remainingMillis < 0) modeState.timer.remainingMillis = 0; 
           
-          unsigned long totalRemainingSeconds = (remainingMillis + 999) / 1000;
-          displayMIN = totalRemainingSeconds / 60;
-          displaySEC = totalRemainingSeconds % 60;
-          displayCS = (remainingMillis % 1000) / 10;
+          unsigned long totalRemainingSeconds = (modeState.timer.remainingMillis + 999) / 1000;
+          modeState.timer.displayMIN = totalRemainingSeconds / 60;
+          modeState.timer.displaySEC = totalRemainingSeconds % 60;
+          modeState.timer.displayCS = (modeState.timer.remainingMillis % 1000) / 10;
           
           currentTimerState = STATE_RUNNING;
-          blinkDone = false; 
+          modeState.timer.blinkDone = false; 
           
           if (currentPresetChoice == 0) { 
-              EEPROM.put(EEPROM_ADDR_MANUAL_TIME, targetTotalSeconds);
+              settings.manualSeconds = targetTotalSeconds;
+              saveSettings();
           }
-          digitalWrite(RELAY_PIN, LOW); 
-          updateStaticDisplay(); 
-          updateCentisecondsDisplay();
-          displayStatusLine3(); 
-          lastDisplayedMIN = displayMIN; 
-          lastDisplayedSEC = displaySEC;
-          lastCsUpdateTime = millis();
+          outputsRunStart((unsigned long)targetTotalSeconds * 1000UL, modeState.timer.remainingMillis);
+          checkpointSave(STATE_RUNNING, modeState.timer.remainingMillis);
+          lowPowerRunBegin();
+          resetProgress(0);
+          requestDisplay(DISP_PRIO_SECONDS, updateStaticDisplay); 
+          requestDisplay(DISP_PRIO_CENTIS, updateCentisecondsDisplay);
+          requestDisplay(DISP_PRIO_STATUS, displayStatusLine3); // Barre de progression à la place des infos
+          modeState.timer.lastDisplayedMIN = modeState.timer.displayMIN; 
+          modeState.timer.lastDisplayedSEC = modeState.timer.displaySEC;
+          modeState.timer.lastCsUpdateTime = millis();
       }
   }
 }
 
 void handleTimerButtonLongPress() {
-  // Cette fonction est appelée par handleButton() dans le .ino
-  // pour un appui long quand currentMode == MODE_TIMER
+  // Appui long en MODE_TIMER pendant la pause : arrêt
   if (currentTimerState == STATE_PAUSED) { 
        currentTimerState = STATE_IDLE;
-       pausedRemainingMillis = 0; 
-       digitalWrite(RELAY_PIN, HIGH); 
-       noTone(BUZZER_PIN); 
+       modeState.timer.pausedRemainingMillis = 0; 
+       modeState.timer.timerResumePending = false;
+       checkpointClear();
+       lowPowerRunEnd();
+       outputsStop();
+       buzzerSilence(SOUND_ALARM);
        
-       if (currentPresetChoice == 0) { 
-           EEPROM.get(EEPROM_ADDR_MANUAL_TIME, targetTotalSeconds);
-           if (targetTotalSeconds > MAX_TOTAL_SECONDS) targetTotalSeconds = 0;
-       } else { 
-           if (currentPresetChoice < NUM_PRESETS) targetTotalSeconds = PRESET_VALUES[currentPresetChoice];
-           else targetTotalSeconds = 0; 
-       }
-       lastPos = targetTotalSeconds / SECOND_INCREMENT;
-       encoder.setPosition(lastPos * STEPS); 
-       displayMIN = targetTotalSeconds / 60; 
-       displaySEC = targetTotalSeconds % 60;
-       displayCS = 0;
-       updateStaticDisplay();
-       updateCentisecondsDisplay();
-       displayStatusLine3();
-       lastDisplayedMIN = -1; 
-       lastDisplayedSEC = -1; 
+       targetTotalSeconds = presetTargetSeconds();
+       modeState.timer.lastPos = targetTotalSeconds / SECOND_INCREMENT;
+       modeState.timer.displayMIN = targetTotalSeconds / 60; 
+       modeState.timer.displaySEC = targetTotalSeconds % 60;
+       modeState.timer.displayCS = 0;
+       requestDisplay(DISP_PRIO_SECONDS, updateStaticDisplay);
+       requestDisplay(DISP_PRIO_CENTIS, updateCentisecondsDisplay);
+       requestDisplay(DISP_PRIO_STATUS, displayStatusLine3);
+       modeState.timer.lastDisplayedMIN = -1; 
+       modeState.timer.lastDisplayedSEC = -1; 
   }
-  // Si STATE_IDLE, enterMainMenu() est géré dans le .ino principal
-  // Si STATE_RUNNING, un appui long ne fait rien
+  // Si STATE_IDLE, handleTimerButton() ouvre le menu ; si STATE_RUNNING, un appui long ne fait rien
 }
\ No newline at end of file
@@ -3,51 +3,41 @@
 
 #include <Arduino.h>
 #include <EEPROM.h>
-#include "LiquidCrystal_I2C.h"
-#include "BigNumbers_I2C.h"
+#include "ecran.h"    // Afficheur (LCD ou OLED) : objets LCD et bigNum
 #include "RotaryEncoder.h"
-#include "conf.h"    // Pour les constantes (RELAY_PIN, etc.) et les types enum si besoin
+#include "conf.h"    // Pour les constantes et les types enum si besoin
 #include "melodie.h" // Pour les déclarations des play...Melody()
+#include "buzzer.h"  // Arbitrage du buzzer
+#include "affichage.h" // Ordonnanceur de rafraîchissement
+#include "checkpoint.h" // Points de reprise en EEPROM
+#include "lowpower.h"   // Décompte en basse consommation
+#include "modes.h"      // Table des modes (setMode)
+#include "geometrie.h"  // Disposition de l'écran (panneau choisi à la compilation)
+#include "sorties.h"    // Sorties programmées (relais, lampe, flash)
+#include "presets.h"    // Bibliothèque de presets (temps cible)
+#include "reglages.h"   // Réglages persistants (temps manuel)
+#include "progression.h" // Barre de progression (ligne d'infos pendant le décompte)
 
 // Références externes aux objets et variables globales définis dans le .ino principal
-extern LiquidCrystal_I2C LCD;
-extern BigNumbers_I2C bigNum;
 extern RotaryEncoder encoder; 
 
 // Extern pour les états et variables globales du .ino principal que ce module utilise/modifie
 extern enum Mode currentMode;           
 extern enum TimerRunState currentTimerState;
 
-extern bool blinkDone;
-extern int lastPos;
-extern int newPos; 
-
-extern int displaySEC;
-extern int displayMIN;
-extern int displayCS;
+// Décompte, affichage et séquence de fin : modeState.timer (modes.h)
 extern unsigned int targetTotalSeconds;
-extern unsigned long targetEndTime;
-extern long remainingMillis;
-extern unsigned long pausedRemainingMillis;
-extern int lastDisplayedSEC;
-extern int lastDisplayedMIN;
-extern unsigned long lastCsUpdateTime;
-
-extern bool isEndSequenceBlinking;
-extern unsigned long blinkSequenceStartTime;
-extern unsigned long lastEndBlinkToggleTime;
-extern bool endBlinkStateIsOn;
 
 extern byte currentMelodyChoice;
 extern byte currentPresetChoice;
-extern bool timerMelodyEnabled;
 
 // Fonctions utilitaires du .ino principal que ce module appelle
 void resetActivityTimer();
 void playClickSound(); 
 void displayStatusLine3();
-void saveChoiceToEEPROM(int address, byte value); 
 extern void clearRestOfLine(byte startCol, byte row); // <<< AJOUT: DÉCLARATION EXTERN
+void checkIdleSleep();
+void ignoreWakeInput();
 
 // Fonctions spécifiques au module Timer
 void setupTimer(); 
@@ -55,8 +45,15 @@ void loopTimer();
 void timerEnd();
 void updateStaticDisplay();       
 void updateCentisecondsDisplay(); 
-
-void handleTimerEncoderInput(int physicalEncoderPos);
+void drawBigClock(int minutes, int seconds); // Grands chiffres MM.SS (disposition BIG_*_COL)
+void drawCentiseconds(int centis);           // ".CS" à CS_COL / CS_ROW
+
+// Gestionnaires de MODE_TIMER (modes.h)
+void enterTimerMode();
+void exitTimerMode();
+void tickTimerMode();
+void handleTimerEncoderInput(int delta);
+void handleTimerButton(ButtonEvent event);
 void handleTimerButtonShortPress();
 void handleTimerButtonLongPress();
 
@@ -0,0 +1,164 @@
+#!/usr/bin/env python3
+# journal.py - Journal des entrées d'une unité (INPUT_JOURNAL) : relevé, lecture, rejeu (voir journal.h)
+#
+# export  : envoie "JOURNAL", enregistre la ligne renvoyée et affiche son contenu décodé.
+# lire    : décode un journal enregistré (réglages du départ, entrées datées, empreinte).
+# rejouer : envoie le journal à une unité ("REJOUER <hex>", par morceaux : le tampon de réception
+#           du Nano ne fait que 64 octets), attend "OK", rouvre le port pour la redémarrer (DTR)
+#           puis attend la ligne "Rejeu ETAT=... attendu=... identique|ECART" de fin de rejeu.
+#
+# Usage :
+#   python3 tools/journal.py export /dev/ttyUSB0 -o incident.txt
+#   python3 tools/journal.py lire incident.txt
+#   python3 tools/journal.py rejouer /dev/ttyUSB1 incident.txt
+
+import argparse
+import struct
+import sys
+import time
+
+SERIAL_BAUD = 115200
+BOOT_TIMEOUT_S = 5
+REPLY_TIMEOUT_S = 3
+CHUNK_CHARS = 32          # Caractères envoyés d'un coup (moitié du tampon de réception)
+CHUNK_PAUSE_S = 0.01
+JOURNAL_FORMAT = 1
+
+# Doit suivre JournalHeader et Settings (journal.h, reglages.h) : AVR, sans remplissage, petit-boutiste
+HEADER = struct.Struct('<BB' + 'BBHBBBHBBB' + 'IHBB')
+ENTRY = struct.Struct('<HB')
+CODE_BUTTON = 0x80
+JOURNAL_TRUNCATED = 0x01
+BUTTON_EVENTS = {1: "clic", 2: "double-clic", 3: "appui long", 4: "repetition"}
+
+
+def crc16(data):
+    """_crc16_update() d'avr-libc (polynôme 0xA001), départ 0xFFFF."""
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = (crc >> 1) ^ 0xA001 if crc & 1 else crc >> 1
+    return crc
+
+
+def decode(line):
+    """Ligne "JOURNAL <hex>" -> (champs de l'en-tête, entrées [(dt, code)])."""
+    prefix, _, payload = line.strip().partition(' ')
+    if prefix not in ("JOURNAL", "REJOUER"):
+        sys.exit("Pas une ligne JOURNAL")
+    data = bytes.fromhex(payload)
+    if len(data) < HEADER.size + 2:
+        sys.exit("Journal trop court")
+    fields = HEADER.unpack_from(data)
+    count = fields[-1]
+    length = HEADER.size + count * ENTRY.size
+    if len(data) != length + 2:
+        sys.exit("Longueur incohérente : %d octets pour %d entrées" % (len(data), count))
+    if struct.unpack_from('<H', data, length)[0] != crc16(data[:length]):
+        sys.exit("CRC du journal invalide")
+    entries = [ENTRY.unpack_from(data, HEADER.size + i * ENTRY.size) for i in range(count)]
+    return fields, entries, data
+
+
+def describe(code):
+    if code == 0:
+        return "attente"
+    if code & CODE_BUTTON:
+        return "bouton " + BUTTON_EVENTS.get(code & ~CODE_BUTTON, "geste %d" % (code & ~CODE_BUTTON))
+    delta = code - 128 if code & 0x40 else code
+    return "encodeur %+d" % delta
+
+
+def print_journal(fields, entries):
+    (fmt, settings_version, melody, preset, manual, sleep, feedback, timer_melody, bpm, ts_num, ts_den,
+     midi_sync, duration, fingerprint, flags, count) = fields
+    print("Format %d, reglages v%d : %d BPM %d/%d, preset %d, temps manuel %d s, melodie %d"
+          % (fmt, settings_version, bpm, ts_num, ts_den, preset, manual, melody))
+    if flags & JOURNAL_TRUNCATED:
+        print("TRONQUE : les premières entrées ont été écrasées, rejeu impossible")
+    at = 0
+    for dt, code in entries:
+        at += dt
+        print("  %9.3f s  (+%5d ms)  %s" % (at / 1000, dt, describe(code)))
+    print("%d entrées, empreinte %04X à %.3f s" % (count, fingerprint, duration / 1000))
+
+
+def open_port(path, wait_boot):
+    try:
+        import serial
+    except ImportError:
+        sys.exit("pyserial est requis : pip install pyserial")
+    port = serial.Serial(path, SERIAL_BAUD, timeout=0.1)
+    if wait_boot:
+        end = time.monotonic() + BOOT_TIMEOUT_S
+        while time.monotonic() < end:
+            if port.readline().startswith(b"Pret en"):
+                break
+        else:
+            sys.exit("Pas de ligne 'Pret en' : l'unité a-t-elle démarré ? (--sans-attente sinon)")
+    port.reset_input_buffer()
+    return port
+
+
+def wait_line(port, prefixes, timeout):
+    end = time.monotonic() + timeout
+    while time.monotonic() < end:
+        reply = port.readline().decode('ascii', 'replace').strip()
+        if reply.startswith(prefixes):
+            return reply
+    sys.exit("Pas de réponse de l'unité")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Journal des entrées : relevé, lecture, rejeu")
+    parser.add_argument('commande', choices=['export', 'lire', 'rejouer'])
+    parser.add_argument('cible', help="export / rejouer : port série ; lire : fichier")
+    parser.add_argument('fichier', nargs='?', help="rejouer : journal enregistré")
+    parser.add_argument('-o', '--output', help="export : fichier de sortie")
+    parser.add_argument('--sans-attente', action='store_true', help="ne pas attendre le redémarrage de l'unité")
+    args = parser.parse_args()
+
+    if args.commande == 'lire':
+        with open(args.cible, encoding='ascii') as source:
+            fields, entries, _ = decode(source.readline())
+        print_journal(fields, entries)
+        return
+
+    port = open_port(args.cible, not args.sans_attente)
+    if args.commande == 'export':
+        port.write(b"JOURNAL\n")
+        line = wait_line(port, ("JOURNAL ", "ERR"), REPLY_TIMEOUT_S)
+        if not line.startswith("JOURNAL "):
+            sys.exit("Réponse inattendue : %s" % line)
+        if args.output:
+            with open(args.output, 'w', encoding='ascii', newline='\n') as out:
+                out.write(line + "\n")
+        print_journal(*decode(line)[:2])
+        return
+
+    if not args.fichier:
+        sys.exit("Journal à rejouer manquant")
+    with open(args.fichier, encoding='ascii') as source:
+        fields, entries, data = decode(source.readline())
+    if fields[0] != JOURNAL_FORMAT:
+        sys.exit("Format de journal %d inconnu" % fields[0])
+    line = ("REJOUER " + data.hex().upper() + "\n").encode('ascii')
+    for i in range(0, len(line), CHUNK_CHARS):
+        port.write(line[i:i + CHUNK_CHARS])
+        time.sleep(CHUNK_PAUSE_S)
+    reply = wait_line(port, ("OK", "ERR"), REPLY_TIMEOUT_S)
+    if reply != "OK":
+        sys.exit("Refusé : %s" % reply)
+    port.close()
+    port = open_port(args.cible, True) # Réouverture : DTR redémarre l'unité, le rejeu part au démarrage
+    duration = fields[-3] / 1000
+    print("Rejeu de %d entrées sur %.1f s..." % (len(entries), duration))
+    result = wait_line(port, ("Rejeu ETAT=",), duration + REPLY_TIMEOUT_S)
+    print(result)
+    if not result.endswith("identique"):
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,162 @@
+#!/usr/bin/env python3
+# midiclock.py - Mesure de l'horloge MIDI du métronome (MIDI_ENABLED, voir midi.h)
+#
+# listen : le métronome est MAÎTRE. Les impulsions 0xF8 reçues sont horodatées ; le script affiche
+#          le tempo mesuré et la gigue des intervalles (écart-type et crête à crête).
+# drive  : le métronome est ESCLAVE. Le script envoie Start puis l'horloge au tempo demandé (gigue
+#          aléatoire optionnelle) et lit les notes de temps renvoyées (Note On canal 10) : erreur de
+#          phase de chaque temps et temps de verrouillage (premier temps à partir duquel l'erreur
+#          reste dans la tolérance).
+#
+# Port : un adaptateur série/MIDI à 31250 bauds (pyserial), ou --pty : un pseudo-terminal Linux est
+# créé et son chemin affiché, pour brancher un simulateur ou un pont (socat, ttymidi...).
+#
+# Usage :
+#   python3 tools/midiclock.py listen /dev/ttyUSB0 --secondes 20
+#   python3 tools/midiclock.py drive /dev/ttyUSB0 --bpm 120 --gigue-ms 1 --secondes 20
+#   python3 tools/midiclock.py drive --pty --bpm 90
+
+import argparse
+import os
+import random
+import statistics
+import sys
+import time
+
+MIDI_BAUD = 31250
+MIDI_PPQN = 24
+CLOCK = 0xF8
+START = 0xFA
+STOP = 0xFC
+NOTE_ON_BEAT = 0x99  # Note On, canal MIDI_BEAT_CHANNEL (9 = canal 10)
+LOCK_BEATS = 4       # Temps consécutifs dans la tolérance pour déclarer le verrouillage
+
+
+class Port:
+    """Octets bruts, série (pyserial) ou pseudo-terminal."""
+
+    def __init__(self, path, use_pty):
+        self.serial = None
+        if use_pty:
+            self.fd, slave = os.openpty()
+            os.set_blocking(self.fd, False)
+            print("Pseudo-terminal : %s" % os.ttyname(slave))
+        else:
+            if not path:
+                sys.exit("Port série manquant (ou --pty)")
+            try:
+                import serial
+            except ImportError:
+                sys.exit("pyserial est requis : pip install pyserial")
+            self.serial = serial.Serial(path, MIDI_BAUD, timeout=0)
+
+    def read(self):
+        if self.serial:
+            return self.serial.read(64)
+        try:
+            return os.read(self.fd, 64)
+        except BlockingIOError:
+            return b''
+
+    def write(self, data):
+        if self.serial:
+            self.serial.write(data)
+        else:
+            os.write(self.fd, data)
+
+
+def listen(port, seconds):
+    stamps = []
+    end = time.perf_counter() + seconds
+    while time.perf_counter() < end:
+        data = port.read()
+        now = time.perf_counter()
+        stamps.extend(now for b in data if b == CLOCK)
+        if not data:
+            time.sleep(0.0002)
+    if len(stamps) < 3:
+        sys.exit("Moins de 3 impulsions reçues : le métronome est-il maître et démarré ?")
+    intervals = [(b - a) * 1e6 for a, b in zip(stamps, stamps[1:])]
+    mean = statistics.mean(intervals)
+    print("Impulsions : %d" % len(stamps))
+    print("Tempo      : %.2f BPM" % (60e6 / mean / MIDI_PPQN))
+    print("Intervalle : %.1f us (min %.1f, max %.1f)" % (mean, min(intervals), max(intervals)))
+    print("Gigue      : %.1f us écart-type, %.1f us crête à crête" % (statistics.pstdev(intervals), max(intervals) - min(intervals)))
+
+
+def drive(port, bpm, jitter_ms, seconds, tolerance_ms):
+    period = 60.0 / bpm / MIDI_PPQN
+    start = time.perf_counter()
+    port.write(bytes([START]))
+    ideal_beats = []  # Instants où le script a émis la première impulsion de chaque noire
+    errors = []       # Erreur de phase de chaque note de temps reçue (ms)
+    pending = b''
+    tick = 0
+    while time.perf_counter() - start < seconds:
+        ideal = start + tick * period
+        due = ideal + random.uniform(-jitter_ms, jitter_ms) / 1000
+        while time.perf_counter() < due:
+            pending = collect(port, pending, ideal_beats, errors)
+        port.write(bytes([CLOCK]))
+        if tick % MIDI_PPQN == 0:
+            ideal_beats.append(ideal)
+        tick += 1
+    port.write(bytes([STOP]))
+
+    if not errors:
+        sys.exit("Aucune note de temps reçue : le métronome est-il esclave ?")
+    lock_index = None
+    for i in range(len(errors) - LOCK_BEATS + 1):
+        if all(abs(e) <= tolerance_ms for e in errors[i:]):
+            lock_index = i
+            break
+    print("Temps reçus : %d sur %d émis" % (len(errors), len(ideal_beats)))
+    for i, e in enumerate(errors):
+        print("  temps %3d : %+7.2f ms" % (i + 1, e))
+    if lock_index is None:
+        print("Pas de verrouillage (tolérance %.1f ms)" % tolerance_ms)
+    else:
+        locked = errors[lock_index:]
+        print("Verrouillé au temps %d, %.2f s après Start (tolérance %.1f ms)" % (lock_index + 1, lock_index * 60.0 / bpm, tolerance_ms))
+        print("Erreur une fois verrouillé : moyenne %+.2f ms, écart-type %.2f ms, max %.2f ms"
+              % (statistics.mean(locked), statistics.pstdev(locked), max(abs(e) for e in locked)))
+
+
+def collect(port, pending, ideal_beats, errors):
+    """Lit les octets reçus ; chaque Note On de temps est rapprochée du temps émis le plus proche."""
+    data = port.read()
+    if not data:
+        return pending
+    now = time.perf_counter()
+    pending += bytes(b for b in data if b < 0xF8)  # Octets temps réel écartés
+    while len(pending) >= 3:
+        if pending[0] != NOTE_ON_BEAT:
+            pending = pending[1:]
+            continue
+        if pending[2] and ideal_beats:
+            nearest = min(ideal_beats[-2:], key=lambda t: abs(now - t))
+            errors.append((now - nearest) * 1000)
+        pending = pending[3:]
+    return pending
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Mesure de l'horloge MIDI du métronome")
+    parser.add_argument('commande', choices=['listen', 'drive'], help="listen = métronome maître, drive = métronome esclave")
+    parser.add_argument('port', nargs='?', help="port série MIDI (ex. /dev/ttyUSB0)")
+    parser.add_argument('--pty', action='store_true', help="pseudo-terminal Linux au lieu d'un port série")
+    parser.add_argument('--secondes', type=float, default=20, help="durée de la mesure")
+    parser.add_argument('--bpm', type=float, default=120, help="drive : tempo de l'horloge émise")
+    parser.add_argument('--gigue-ms', type=float, default=0, help="drive : gigue aléatoire ajoutée à chaque impulsion")
+    parser.add_argument('--tolerance-ms', type=float, default=2, help="drive : erreur de phase admise une fois verrouillé")
+    args = parser.parse_args()
+
+    port = Port(args.port, args.pty)
+    if args.commande == 'listen':
+        listen(port, args.secondes)
+    else:
+        drive(port, args.bpm, args.gigue_ms, args.secondes, args.tolerance_ms)
+
+
+if __name__ == '__main__':
+    main()
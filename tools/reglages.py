@@ -0,0 +1,85 @@
+#!/usr/bin/env python3
+# reglages.py - Export / import des réglages d'une unité par le port série (voir reglages.h)
+#
+# export : envoie "REGLAGES" et enregistre la ligne renvoyée ("REGLAGES <hex>", version + champs + CRC).
+# import : renvoie cette ligne à une autre unité, qui vérifie le CRC et la version, applique et
+#          répond "OK". La durée de l'échange (envoi -> réponse) est affichée.
+#
+# L'ouverture du port redémarre un Nano (DTR) : le script attend la ligne "Pret en ..." du
+# démarrage avant d'envoyer, sauf avec --sans-attente.
+#
+# Usage :
+#   python3 tools/reglages.py export /dev/ttyUSB0 -o unite.txt
+#   python3 tools/reglages.py import /dev/ttyUSB1 unite.txt
+
+import argparse
+import sys
+import time
+
+SERIAL_BAUD = 115200
+BOOT_TIMEOUT_S = 5
+REPLY_TIMEOUT_S = 2
+
+
+def open_port(path, wait_boot):
+    try:
+        import serial
+    except ImportError:
+        sys.exit("pyserial est requis : pip install pyserial")
+    port = serial.Serial(path, SERIAL_BAUD, timeout=0.1)
+    if wait_boot:
+        end = time.monotonic() + BOOT_TIMEOUT_S
+        while time.monotonic() < end:
+            if port.readline().startswith(b"Pret en"):
+                break
+        else:
+            sys.exit("Pas de ligne 'Pret en' : l'unité a-t-elle démarré ? (--sans-attente sinon)")
+    port.reset_input_buffer()
+    return port
+
+
+def exchange(port, line):
+    """Envoie une ligne et rend la première réponse non vide, avec la durée de l'échange."""
+    start = time.monotonic()
+    port.write(line.encode('ascii') + b"\n")
+    while time.monotonic() - start < REPLY_TIMEOUT_S:
+        reply = port.readline().decode('ascii', 'replace').strip()
+        if reply:
+            return reply, time.monotonic() - start
+    sys.exit("Pas de réponse de l'unité")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Export / import des réglages par le port série")
+    parser.add_argument('commande', choices=['export', 'import'])
+    parser.add_argument('port', help="port série de l'unité (ex. /dev/ttyUSB0)")
+    parser.add_argument('fichier', nargs='?', help="import : ligne exportée à charger")
+    parser.add_argument('-o', '--output', help="export : fichier de sortie (sinon la console)")
+    parser.add_argument('--sans-attente', action='store_true', help="ne pas attendre le redémarrage de l'unité")
+    args = parser.parse_args()
+
+    port = open_port(args.port, not args.sans_attente)
+    if args.commande == 'export':
+        reply, _ = exchange(port, "REGLAGES")
+        if not reply.startswith("REGLAGES "):
+            sys.exit("Réponse inattendue : %s" % reply)
+        if args.output:
+            with open(args.output, 'w', encoding='ascii', newline='\n') as out:
+                out.write(reply + "\n")
+        else:
+            print(reply)
+    else:
+        if not args.fichier:
+            sys.exit("Fichier de réglages manquant")
+        with open(args.fichier, encoding='ascii') as source:
+            line = source.readline().strip()
+        if not line.startswith("REGLAGES "):
+            sys.exit("%s : pas une ligne REGLAGES" % args.fichier)
+        reply, elapsed = exchange(port, line)
+        print("%s (%.0f ms)" % (reply, elapsed * 1000))
+        if reply != "OK":
+            sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
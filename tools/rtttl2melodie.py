@@ -0,0 +1,183 @@
+#!/usr/bin/env python3
+# rtttl2melodie.py - Convertit des mélodies RTTTL en tableaux PROGMEM compacts (melodie_data.h)
+#
+# Format d'une mélodie compactée (voir melodie.h) :
+#   octet 0 : nombre de notes
+#   octet 1 : tempo en BPM (noire)
+#   octet 2 : note MIDI de base (la note codée 1 vaut base, 2 vaut base+1, ...)
+#   puis 1 octet par note : bits 7-5 = code de durée, bits 4-0 = note (0 = silence, 1..31)
+#
+# Codes de durée : 0=ronde 1=blanche 2=noire 3=croche 4=double 5=triple 6=noire pointée 7=croche pointée
+#
+# Usage :
+#   python3 tools/rtttl2melodie.py tools/melodies.rtttl -o melodie_data.h
+#   python3 tools/rtttl2melodie.py tools/melodies.rtttl --rapport
+
+import argparse
+import re
+import sys
+
+MIN_BPM = 4  # MELODY_MIN_BPM (melodie.h) : en dessous, la ronde (240000 / b ms) déborde 16 bits
+
+NOTE_OFFSETS = {'c': 0, 'd': 2, 'e': 4, 'f': 5, 'g': 7, 'a': 9, 'b': 11, 'h': 11}
+PLAIN_DURATIONS = {1: 0, 2: 1, 4: 2, 8: 3, 16: 4, 32: 5}
+DOTTED_DURATIONS = {4: 6, 8: 7}
+MAX_NOTE_SPAN = 31
+
+# ESTIMATION, pas une mesure : coût supposé de l'ancienne implémentation (appels tone()/delay()
+# en ligne), ~12 octets de flash par note plus le prologue de chaque fonction play...(). Seule la
+# colonne "Apres" est exacte (octets des tableaux générés) ; pour un chiffre mesuré, comparer
+# avr-size sur les deux versions du firmware.
+INLINE_BYTES_PER_NOTE = 12
+INLINE_BYTES_PER_FUNCTION = 40
+PACKED_HEADER_BYTES = 3
+PACKED_TABLE_ENTRY_BYTES = 2
+
+NOTE_RE = re.compile(r'^(\d+)?([a-hp])(#?)(\.?)(\d)?(\.?)$')
+
+
+class RtttlError(Exception):
+    pass
+
+
+def parse_rtttl(line):
+    try:
+        name, defaults, notes = line.split(':', 2)
+    except ValueError:
+        raise RtttlError("ligne RTTTL invalide (attendu nom:défauts:notes)")
+    settings = {'d': 4, 'o': 6, 'b': 63}
+    for item in defaults.split(','):
+        item = item.strip()
+        if not item:
+            continue
+        key, _, value = item.partition('=')
+        settings[key.strip().lower()] = int(value)
+    if not MIN_BPM <= settings['b'] <= 255:
+        raise RtttlError("tempo %d hors limites (%d-255)" % (settings['b'], MIN_BPM))
+
+    events = []
+    for token in notes.split(','):
+        token = token.strip().lower()
+        if not token:
+            continue
+        match = NOTE_RE.match(token)
+        if not match:
+            raise RtttlError("note invalide '%s'" % token)
+        duration = int(match.group(1)) if match.group(1) else settings['d']
+        letter, sharp = match.group(2), match.group(3)
+        dotted = bool(match.group(4) or match.group(6))
+        octave = int(match.group(5)) if match.group(5) else settings['o']
+
+        table = DOTTED_DURATIONS if dotted else PLAIN_DURATIONS
+        if duration not in table:
+            raise RtttlError("durée '%s' non supportée dans '%s'" % (("%d." % duration) if dotted else duration, token))
+        code = table[duration]
+
+        if letter == 'p':
+            events.append((code, None))
+        else:
+            midi = (octave + 1) * 12 + NOTE_OFFSETS[letter] + (1 if sharp else 0)
+            events.append((code, midi))
+    if not events:
+        raise RtttlError("mélodie vide")
+    if len(events) > 255:
+        raise RtttlError("trop de notes (%d > 255)" % len(events))
+    return name.strip(), settings['b'], events
+
+
+def pack(bpm, events):
+    pitches = [midi for _, midi in events if midi is not None]
+    base = min(pitches) if pitches else 60
+    if pitches and max(pitches) - base + 1 > MAX_NOTE_SPAN:
+        raise RtttlError("étendue de %d demi-tons > %d" % (max(pitches) - base + 1, MAX_NOTE_SPAN))
+    data = [len(events), bpm, base]
+    for code, midi in events:
+        note = 0 if midi is None else midi - base + 1
+        data.append((code << 5) | note)
+    return data
+
+
+def c_identifier(name):
+    ident = re.sub(r'[^A-Za-z0-9]', '_', name).upper()
+    return 'MELODY_' + ident.strip('_')
+
+
+def load(path):
+    melodies = []
+    with open(path, encoding='utf-8') as source:
+        for number, line in enumerate(source, 1):
+            line = line.strip()
+            if not line or line.startswith('#'):
+                continue
+            try:
+                name, bpm, events = parse_rtttl(line)
+                melodies.append((name, pack(bpm, events)))
+            except RtttlError as err:
+                sys.exit("%s:%d: %s" % (path, number, err))
+    return melodies
+
+
+def render_header(melodies, source_name):
+    out = []
+    out.append("// melodie_data.h - Mélodies compactées en PROGMEM")
+    out.append("// FICHIER GÉNÉRÉ par tools/rtttl2melodie.py depuis %s : ne pas modifier à la main." % source_name)
+    out.append("")
+    out.append("#ifndef MELODIE_DATA_H")
+    out.append("#define MELODIE_DATA_H")
+    out.append("")
+    out.append("#include <Arduino.h>")
+    out.append("#include <avr/pgmspace.h>")
+    out.append("")
+    out.append("const byte MELODY_DATA_COUNT = %d;" % len(melodies))
+    out.append("")
+    for name, data in melodies:
+        out.append("// %s : %d notes, %d BPM" % (name, data[0], data[1]))
+        out.append("const uint8_t %s[] PROGMEM = {" % c_identifier(name))
+        out.append("  %d, %d, %d," % tuple(data[:3]))
+        body = data[3:]
+        for start in range(0, len(body), 12):
+            chunk = ", ".join("0x%02X" % b for b in body[start:start + 12])
+            out.append("  %s%s" % (chunk, "," if start + 12 < len(body) else ""))
+        out.append("};")
+        out.append("")
+    out.append("const uint8_t* const MELODY_TABLE[MELODY_DATA_COUNT] PROGMEM = {")
+    out.append(",\n".join("  %s" % c_identifier(name) for name, _ in melodies))
+    out.append("};")
+    out.append("")
+    out.append("#endif // MELODIE_DATA_H")
+    return "\n".join(out) + "\n"
+
+
+def report(melodies):
+    total_old = total_new = 0
+    print("%-12s %6s %12s %10s %10s" % ("Melodie", "Notes", "Avant(estim)", "Apres(o)", "Gain(estim)"))
+    for name, data in melodies:
+        notes = data[0]
+        old = INLINE_BYTES_PER_FUNCTION + notes * INLINE_BYTES_PER_NOTE
+        new = PACKED_HEADER_BYTES + notes + PACKED_TABLE_ENTRY_BYTES
+        total_old += old
+        total_new += new
+        print("%-12s %6d %12d %10d %10d" % (name, notes, old, new, old - new))
+    print("%-12s %6s %12d %10d %10d" % ("Total", "", total_old, total_new, total_old - total_new))
+    print("Avant = ESTIMATION (%d o par note + %d o par fonction, non mesuré) ; Apres = octets exacts des tableaux"
+          % (INLINE_BYTES_PER_NOTE, INLINE_BYTES_PER_FUNCTION))
+    print("(+ lecteur playPackedMelody() partagé, compté une seule fois ; chiffre réel : avr-size avant/après)")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Convertit des mélodies RTTTL en melodie_data.h")
+    parser.add_argument('source', help="fichier .rtttl (une mélodie par ligne)")
+    parser.add_argument('-o', '--output', help="fichier d'en-tête à générer")
+    parser.add_argument('--rapport', action='store_true', help="affiche le gain de flash par mélodie (ancien coût estimé, pas mesuré)")
+    args = parser.parse_args()
+
+    melodies = load(args.source)
+    if args.output:
+        with open(args.output, 'w', encoding='utf-8', newline='\n') as header:
+            header.write(render_header(melodies, args.source))
+    if args.rapport or not args.output:
+        report(melodies)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,134 @@
+#!/usr/bin/env python3
+# taille_flash.py - Flash et SRAM statique du sketch à plusieurs révisions git, cycles d'une fonction
+#
+# Chaque révision est extraite dans un dossier temporaire (git worktree), compilée par arduino-cli
+# pour le Nano, puis mesurée par avr-size : text (code + PROGMEM), data, bss. Le tableau donne la
+# flash (text + data), la SRAM statique (data + bss) et l'écart avec la première révision.
+#
+# --cycles FONCTION : désassemble la fonction (avr-objdump) dans l'ELF de chaque révision et
+# additionne la durée de ses instructions sur l'ATmega328P (fiche "AVR Instruction Set Manual"),
+# branches non prises puis prises. Chaque instruction compte une fois : exact pour une fonction
+# sans boucle ni sortie anticipée, borne haute sinon (lire le listing). L'appel (call, 4 cycles)
+# n'est pas compté. Une fonction intégrée par le compilateur (inline) n'a pas de symbole.
+#
+# Prérequis : arduino-cli avec le cœur arduino:avr et la bibliothèque RotaryEncoder installés,
+# avr-size et avr-objdump dans le PATH (ceux du cœur : ~/.arduino15/packages/arduino/tools/avr-gcc).
+#
+# Usage :
+#   python3 tools/taille_flash.py 8140e8c~1 8140e8c
+#   python3 tools/taille_flash.py HEAD --cycles modeTick --flags "-DDISPLAY_OLED=1"
+
+import argparse
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+SKETCH = "code-source"  # arduino-cli : le dossier doit porter le nom du .ino
+FQBN = "arduino:avr:nano"
+
+# Cycles par mnémonique (ATmega328P, PC sur 16 bits) ; absent = 1 cycle
+CYCLES = {
+    "adiw": 2, "sbiw": 2, "mul": 2, "muls": 2, "mulsu": 2, "fmul": 2, "fmuls": 2, "fmulsu": 2,
+    "rjmp": 2, "ijmp": 2, "jmp": 3, "rcall": 3, "icall": 3, "call": 4, "ret": 4, "reti": 4,
+    "ld": 2, "ldd": 2, "st": 2, "std": 2, "lds": 2, "sts": 2, "push": 2, "pop": 2,
+    "lpm": 3, "cbi": 2, "sbi": 2,
+}
+BRANCHES = {"breq", "brne", "brcs", "brcc", "brsh", "brlo", "brmi", "brpl", "brge", "brlt",
+            "brhs", "brhc", "brts", "brtc", "brvs", "brvc", "brie", "brid", "brbs", "brbc"}
+SKIPS = {"cpse", "sbrc", "sbrs", "sbic", "sbis"}  # 1 cycle, 2 ou 3 si l'instruction suivante est sautée
+
+
+def run(command, cwd=None):
+    result = subprocess.run(command, cwd=cwd, capture_output=True, text=True)
+    if result.returncode != 0:
+        sys.exit("Échec de %s :\n%s" % (" ".join(command), result.stderr.strip()))
+    return result.stdout
+
+
+def build(revision, workdir, flags):
+    """Compile la révision ; rend le chemin de l'ELF."""
+    tree = os.path.join(workdir, revision.replace("/", "_").replace("~", "-"), SKETCH)
+    run(["git", "worktree", "add", "--detach", tree, revision])
+    out = os.path.join(tree, "build")
+    command = ["arduino-cli", "compile", "--fqbn", FQBN, "--output-dir", out, tree]
+    if flags:
+        command[2:2] = ["--build-property", "compiler.cpp.extra_flags=" + flags]
+    run(command)
+    return os.path.join(out, SKETCH + ".ino.elf")
+
+
+def sizes(elf):
+    """(text, data, bss) d'avr-size, format berkeley."""
+    lines = run(["avr-size", "--format=berkeley", elf]).splitlines()
+    text, data, bss = (int(v) for v in lines[1].split()[:3])
+    return text, data, bss
+
+
+def function_cycles(elf, name):
+    """(instructions, minimum, maximum) des cycles de la fonction, None si elle est absente."""
+    listing = run(["avr-objdump", "-d", "--no-show-raw-insn", elf])
+    match = re.search(r"^[0-9a-f]+ <%s>:\n(.*?)(?:\n\n|\Z)" % re.escape(name), listing, re.S | re.M)
+    if not match:
+        return None
+    count = low = high = 0
+    for line in match.group(1).splitlines():
+        fields = line.split("\t")
+        if len(fields) < 2:
+            continue
+        mnemonic = fields[1].strip()
+        count += 1
+        if mnemonic in BRANCHES:
+            low, high = low + 1, high + 2
+        elif mnemonic in SKIPS:
+            low, high = low + 1, high + 3
+        else:
+            cycles = CYCLES.get(mnemonic, 1)
+            low, high = low + cycles, high + cycles
+    return count, low, high
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Flash, SRAM statique et cycles à plusieurs révisions")
+    parser.add_argument('revisions', nargs='+', help="révisions git (la première sert de référence)")
+    parser.add_argument('--cycles', metavar='FONCTION', help="cycles de cette fonction dans chaque révision")
+    parser.add_argument('--flags', default="", help="options de compilation (ex: -DDISPLAY_OLED=1)")
+    args = parser.parse_args()
+    for tool in ("git", "arduino-cli", "avr-size", "avr-objdump"):
+        if shutil.which(tool) is None:
+            sys.exit("%s introuvable dans le PATH" % tool)
+
+    workdir = tempfile.mkdtemp(prefix="taille_flash_")
+    rows = []
+    try:
+        for revision in args.revisions:
+            elf = build(revision, workdir, args.flags)
+            cycles = function_cycles(elf, args.cycles) if args.cycles else None
+            rows.append((revision, sizes(elf), cycles))
+    finally:
+        for entry in os.listdir(workdir):
+            subprocess.run(["git", "worktree", "remove", "--force", os.path.join(workdir, entry, SKETCH)],
+                           capture_output=True)
+        shutil.rmtree(workdir, ignore_errors=True)
+
+    reference_flash = rows[0][1][0] + rows[0][1][1]
+    reference_sram = rows[0][1][1] + rows[0][1][2]
+    print("%-16s %7s %6s %6s %8s %8s %9s %8s" % ("revision", "text", "data", "bss", "flash", "ecart", "SRAM stat.", "ecart"))
+    for revision, (text, data, bss), _ in rows:
+        flash, sram = text + data, data + bss
+        print("%-16s %7d %6d %6d %8d %+8d %9d %+8d" % (revision, text, data, bss, flash,
+                                                     flash - reference_flash, sram, sram - reference_sram))
+    if args.cycles:
+        print("\nCycles de %s (appel non compris, retour compris) :" % args.cycles)
+        for revision, _, cycles in rows:
+            if cycles is None:
+                print("  %-16s absente (inline ou inexistante)" % revision)
+            else:
+                print("  %-16s %3d instructions, %d a %d cycles (%.2f a %.2f us a 16 MHz)"
+                      % (revision, cycles[0], cycles[1], cycles[2], cycles[1] / 16, cycles[2] / 16))
+
+
+if __name__ == '__main__':
+    main()